@@ -0,0 +1,238 @@
+#include "benchmark.h"
+
+#include "allocator/memoryHeap.h"
+#include "allocator/objectPool.h"
+#include "threads/mpmcQueue.h"
+
+#ifdef APH_USE_MIMALLOC
+    #include <mimalloc.h>
+#endif
+
+using namespace aph;
+using bench::Runner;
+
+namespace
+{
+constexpr uint64_t OPS_PER_THREAD = 1 << 18;
+constexpr uint32_t BURST          = 16;
+constexpr uint32_t FRAME_ALLOCS   = 4096;
+constexpr uint32_t FRAME_COUNT    = 16;
+
+struct PoolObject
+{
+    uint64_t payload[8] = {};
+};
+
+// the pool as it was before magazines, one lock around everything
+class MutexObjectPool : private ObjectPool<PoolObject>
+{
+public:
+    PoolObject* allocate()
+    {
+        std::lock_guard<std::mutex> holder{m_lock};
+        return ObjectPool<PoolObject>::allocate();
+    }
+
+    void free(PoolObject* ptr)
+    {
+        std::lock_guard<std::mutex> holder{m_lock};
+        ObjectPool<PoolObject>::free(ptr);
+    }
+
+private:
+    std::mutex m_lock;
+};
+
+// every thread allocates a burst of objects and frees it again, every other burst goes through slots shared by all
+// threads so objects are also freed on threads that did not allocate them
+template <typename Pool>
+void benchPool(Runner& runner, std::string_view name, uint32_t threadCount)
+{
+    runner.run(name, threadCount, OPS_PER_THREAD * threadCount, [&]() {
+        Pool                                  pool;
+        std::vector<std::atomic<PoolObject*>> handoff(BURST);
+        std::atomic_bool                      start{false};
+        std::vector<std::thread>              threads;
+        for(uint32_t t = 0; t < threadCount; ++t)
+        {
+            threads.emplace_back([&]() {
+                while(!start.load(std::memory_order_acquire))
+                {
+                }
+                std::array<PoolObject*, BURST> burst;
+                for(uint64_t op = 0; op < OPS_PER_THREAD; op += BURST)
+                {
+                    for(auto& ptr : burst)
+                    {
+                        ptr = pool.allocate();
+                        ptr->payload[0] = op;
+                    }
+                    const bool crossThread = (op / BURST) % 2;
+                    for(uint32_t i = 0; i < BURST; ++i)
+                    {
+                        // park the object in a shared slot and free whatever another thread parked there
+                        PoolObject* ptr = crossThread ? handoff[i].exchange(burst[i]) : burst[i];
+                        if(ptr)
+                        {
+                            pool.free(ptr);
+                        }
+                    }
+                }
+            });
+        }
+
+        uint64_t time = Runner::measure([&]() {
+            start.store(true, std::memory_order_release);
+            for(auto& thread : threads)
+            {
+                thread.join();
+            }
+        });
+        for(auto& slot : handoff)
+        {
+            if(PoolObject* parked = slot.load())
+            {
+                pool.free(parked);
+            }
+        }
+        return time;
+    });
+}
+
+struct GlibcBackend
+{
+    static void* allocate(std::size_t size) { return std::malloc(size); }
+    static void  free(void* ptr) { std::free(ptr); }
+};
+
+#ifdef APH_USE_MIMALLOC
+struct MimallocBackend
+{
+    static void* allocate(std::size_t size) { return mi_malloc(size); }
+    static void  free(void* ptr) { mi_free(ptr); }
+};
+#endif
+
+// whatever aph_malloc is built with, including the memory tracker if enabled
+struct AphBackend
+{
+    static void* allocate(std::size_t size) { return memory::aph_malloc(size); }
+    static void  free(void* ptr) { memory::aph_free(ptr); }
+};
+
+// sizes seen in a frame: mostly small containers and descriptors, some staging sized blocks, the odd large upload
+std::vector<uint32_t> makeFrameTrace()
+{
+    std::vector<uint32_t> sizes(FRAME_ALLOCS * FRAME_COUNT);
+    uint32_t              state = 0x9e3779b9u;
+    for(uint32_t& size : sizes)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        uint32_t bucket = state % 100;
+        uint32_t jitter = state >> 8;
+        size            = bucket < 70 ? 16 + jitter % 240
+                        : bucket < 95 ? 256 + jitter % 3840
+                        : bucket < 99 ? 4096 + jitter % 61440
+                                      : 65536 + jitter % 983040;
+    }
+    return sizes;
+}
+
+// per frame: allocate the frame's trace, touch it, free it in allocation order
+template <typename Backend>
+void benchFrameTrace(Runner& runner, std::string_view name, const std::vector<uint32_t>& sizes)
+{
+    runner.run(name, 1, sizes.size(), [&]() {
+        std::vector<void*> ptrs(FRAME_ALLOCS);
+        return Runner::measure([&]() {
+            for(uint32_t frame = 0; frame < FRAME_COUNT; ++frame)
+            {
+                for(uint32_t i = 0; i < FRAME_ALLOCS; ++i)
+                {
+                    ptrs[i]                        = Backend::allocate(sizes[frame * FRAME_ALLOCS + i]);
+                    *static_cast<uint8_t*>(ptrs[i]) = 1;
+                }
+                for(void* ptr : ptrs)
+                {
+                    Backend::free(ptr);
+                }
+            }
+        });
+    });
+}
+
+// the same trace from a subsystem heap that is dropped wholesale at the end of each frame
+void benchFrameTraceHeap(Runner& runner, const std::vector<uint32_t>& sizes)
+{
+    runner.run("alloc.frame_trace.heap_reset", 1, sizes.size(), [&]() {
+        memory::MemoryHeap heap{"bench"};
+        return Runner::measure([&]() {
+            for(uint32_t frame = 0; frame < FRAME_COUNT; ++frame)
+            {
+                for(uint32_t i = 0; i < FRAME_ALLOCS; ++i)
+                {
+                    *static_cast<uint8_t*>(heap.allocate(sizes[frame * FRAME_ALLOCS + i])) = 1;
+                }
+                heap.reset();
+            }
+        });
+    });
+}
+
+// task sized objects allocated on one thread and freed on another, like tasks handed to workers
+template <typename Backend>
+void benchCrossThread(Runner& runner, std::string_view name)
+{
+    constexpr uint64_t count = 1 << 18;
+    runner.run(name, 2, count, [&]() {
+        MPMCQueue<void*> queue{1024};
+        std::thread      consumer{[&]() {
+            while(auto ptr = queue.pop())
+            {
+                Backend::free(ptr.value());
+            }
+        }};
+        uint64_t time = Runner::measure([&]() {
+            for(uint64_t i = 0; i < count; ++i)
+            {
+                queue.push(Backend::allocate(96 + i % 64));
+            }
+            queue.close();
+            consumer.join();
+        });
+        return time;
+    });
+}
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    Runner runner{argc, argv};
+    Logger::GetInstance().setLogLevel(Logger::Level::Warn);
+
+    for(uint32_t threadCount : {1u, std::max(std::thread::hardware_concurrency(), 4u)})
+    {
+        benchPool<MutexObjectPool>(runner, "pool.mutex", threadCount);
+        benchPool<ThreadSafeObjectPool<PoolObject>>(runner, "pool.magazine_locked_depot", threadCount);
+        benchPool<ThreadSafeObjectPool<PoolObject, PoolDepot::LockFree>>(runner, "pool.magazine_lockfree_depot",
+                                                                         threadCount);
+    }
+
+    const auto sizes = makeFrameTrace();
+    benchFrameTrace<GlibcBackend>(runner, "alloc.frame_trace.glibc", sizes);
+#ifdef APH_USE_MIMALLOC
+    benchFrameTrace<MimallocBackend>(runner, "alloc.frame_trace.mimalloc", sizes);
+#endif
+    benchFrameTrace<AphBackend>(runner, "alloc.frame_trace.aph_malloc", sizes);
+    benchFrameTraceHeap(runner, sizes);
+
+    benchCrossThread<GlibcBackend>(runner, "alloc.cross_thread.glibc");
+#ifdef APH_USE_MIMALLOC
+    benchCrossThread<MimallocBackend>(runner, "alloc.cross_thread.mimalloc");
+#endif
+    benchCrossThread<AphBackend>(runner, "alloc.cross_thread.aph_malloc");
+
+    return runner.finish();
+}
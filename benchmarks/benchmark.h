@@ -0,0 +1,169 @@
+#ifndef APH_BENCHMARK_H_
+#define APH_BENCHMARK_H_
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace aph::bench
+{
+/*
+ * Minimal benchmark harness shared by the aph_bench_* targets.
+ *
+ * A benchmark is a callable that runs `ops` operations and returns the elapsed nanoseconds, so setup and teardown
+ * can be kept out of the measurement. Every benchmark is warmed up once and then sampled a fixed number of times,
+ * results are reported per operation.
+ *
+ *   --filter <substring>  only run benchmarks whose name contains the substring
+ *   --samples <count>     samples per benchmark (default 15)
+ *   --json <path>         also write the results as JSON, "-" for stdout
+ */
+class Runner
+{
+public:
+    Runner(int argc, char** argv)
+    {
+        for(int i = 1; i < argc; ++i)
+        {
+            std::string_view arg  = argv[i];
+            const char*      next = i + 1 < argc ? argv[i + 1] : nullptr;
+            if(arg == "--filter" && next)
+            {
+                m_filter = argv[++i];
+            }
+            else if(arg == "--samples" && next)
+            {
+                m_sampleCount = std::max(1, std::atoi(argv[++i]));
+            }
+            else if(arg == "--json" && next)
+            {
+                m_jsonPath = argv[++i];
+            }
+            else
+            {
+                std::fprintf(stderr, "usage: %s [--filter <substring>] [--samples <count>] [--json <path>]\n",
+                             argv[0]);
+                std::exit(1);
+            }
+        }
+
+        // keep stdout clean for the JSON report
+        m_table = m_jsonPath == "-" ? stderr : stdout;
+        std::fprintf(m_table, "%-40s %8s %12s %12s %12s %14s\n", "benchmark", "threads", "min(ns)", "median(ns)",
+                     "p90(ns)", "ops/s");
+    }
+
+    static uint64_t now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    // elapsed nanoseconds of func
+    template <typename Func>
+    static uint64_t measure(Func&& func)
+    {
+        uint64_t begin = now();
+        func();
+        return now() - begin;
+    }
+
+    template <typename Func>
+    void run(std::string_view name, uint32_t threadCount, uint64_t ops, Func&& sample)
+    {
+        if(!m_filter.empty() && name.find(m_filter) == std::string_view::npos)
+        {
+            return;
+        }
+
+        // warm up caches, pools and parked threads
+        sample();
+
+        std::vector<double> samples(m_sampleCount);
+        for(double& value : samples)
+        {
+            value = static_cast<double>(sample()) / static_cast<double>(ops);
+        }
+        std::sort(samples.begin(), samples.end());
+
+        Result result{
+            .name     = std::string{name},
+            .threads  = threadCount,
+            .ops      = ops,
+            .minNs    = samples.front(),
+            .medianNs = samples[samples.size() / 2],
+            .p90Ns    = samples[std::min(samples.size() - 1, samples.size() * 9 / 10)],
+        };
+        std::fprintf(m_table, "%-40s %8u %12.1f %12.1f %12.1f %14.0f\n", result.name.c_str(), threadCount,
+                     result.minNs, result.medianNs, result.p90Ns, result.medianNs > 0.0 ? 1e9 / result.medianNs : 0.0);
+        std::fflush(m_table);
+        m_results.push_back(std::move(result));
+    }
+
+    // writes the JSON report if requested, returns the process exit code
+    int finish() const
+    {
+        if(m_jsonPath.empty())
+        {
+            return 0;
+        }
+
+        std::string json = "{\n  \"context\": {\"hardware_concurrency\": " +
+                           std::to_string(std::thread::hardware_concurrency()) +
+                           ", \"samples\": " + std::to_string(m_sampleCount) + "},\n  \"benchmarks\": [";
+        for(std::size_t i = 0; i < m_results.size(); ++i)
+        {
+            const Result& result = m_results[i];
+            char          line[512];
+            std::snprintf(line, sizeof(line),
+                          "%s\n    {\"name\": \"%s\", \"threads\": %u, \"ops\": %llu, \"unit\": \"ns/op\", "
+                          "\"min\": %.2f, \"median\": %.2f, \"p90\": %.2f}",
+                          i ? "," : "", result.name.c_str(), result.threads,
+                          static_cast<unsigned long long>(result.ops), result.minNs, result.medianNs, result.p90Ns);
+            json += line;
+        }
+        json += "\n  ]\n}\n";
+
+        if(m_jsonPath == "-")
+        {
+            std::fputs(json.c_str(), stdout);
+            return 0;
+        }
+
+        std::ofstream out{m_jsonPath};
+        out << json;
+        if(!out)
+        {
+            std::fprintf(stderr, "failed to write %s\n", m_jsonPath.c_str());
+            return 1;
+        }
+        return 0;
+    }
+
+private:
+    struct Result
+    {
+        std::string name;
+        uint32_t    threads  = 0;
+        uint64_t    ops      = 0;
+        double      minNs    = 0.0;
+        double      medianNs = 0.0;
+        double      p90Ns    = 0.0;
+    };
+
+    std::string         m_filter;
+    std::string         m_jsonPath;
+    int                 m_sampleCount = 15;
+    std::FILE*          m_table       = stdout;
+    std::vector<Result> m_results;
+};
+}  // namespace aph::bench
+
+#endif  // APH_BENCHMARK_H_
@@ -0,0 +1,149 @@
+#include "benchmark.h"
+
+#include "common/concurrentHashMap.h"
+
+using namespace aph;
+using bench::Runner;
+
+namespace
+{
+constexpr uint32_t KEY_COUNT = 256;
+
+std::vector<uint32_t> getThreadCounts()
+{
+    std::vector<uint32_t> threadCounts;
+    uint32_t              maxCount = std::max(std::thread::hardware_concurrency(), 1u);
+    for(uint32_t threadCount = 1; threadCount < maxCount; threadCount *= 2)
+    {
+        threadCounts.push_back(threadCount);
+    }
+    threadCounts.push_back(maxCount);
+    return threadCounts;
+}
+
+void spin(uint32_t iterations)
+{
+    volatile float value = 1.0f;
+    for(uint32_t i = 0; i < iterations; ++i)
+    {
+        value = value * 1.0001f + 0.5f;
+    }
+}
+
+// the pattern the shader, pipeline and image view caches used: one mutex, creation while holding it
+template <typename Key, typename T>
+class LockedHashMap
+{
+public:
+    template <typename Factory>
+    T getOrCreate(const Key& key, Factory&& factory)
+    {
+        std::lock_guard<std::mutex> holder{m_lock};
+        auto                        it = m_map.find(key);
+        if(it == m_map.end())
+        {
+            it = m_map.emplace(key, factory()).first;
+        }
+        return it->second;
+    }
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> holder{m_lock};
+        m_map.clear();
+    }
+
+private:
+    std::mutex      m_lock;
+    HashMap<Key, T> m_map;
+};
+
+std::vector<std::string> makePaths()
+{
+    std::vector<std::string> paths;
+    for(uint32_t i = 0; i < KEY_COUNT; ++i)
+    {
+        paths.push_back("shader://pass_" + std::to_string(i) + ".slang");
+    }
+    return paths;
+}
+
+template <typename Func>
+void runThreads(uint32_t threadCount, Func&& func)
+{
+    std::vector<std::thread> threads;
+    for(uint32_t t = 0; t < threadCount; ++t)
+    {
+        threads.emplace_back(func, t);
+    }
+    for(auto& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+// every thread loads all shaders starting at a different one, a miss costs a few microseconds of "compilation"
+template <typename Map>
+void benchLoad(Runner& runner, std::string_view name, uint32_t threadCount)
+{
+    const auto paths = makePaths();
+    Map        map;
+
+    runner.run(name, threadCount, uint64_t{KEY_COUNT} * threadCount, [&]() {
+        map.clear();
+        return Runner::measure([&]() {
+            runThreads(threadCount, [&](uint32_t t) {
+                for(uint32_t i = 0; i < KEY_COUNT; ++i)
+                {
+                    const std::string& path = paths[(i + t * KEY_COUNT / threadCount) % KEY_COUNT];
+                    map.getOrCreate(path, [&]() {
+                        spin(2048);
+                        return static_cast<uint32_t>(path.size());
+                    });
+                }
+            });
+        });
+    });
+}
+
+// warm cache, the steady state of per-frame pipeline and view requests
+template <typename Map>
+void benchLookup(Runner& runner, std::string_view name, uint32_t threadCount)
+{
+    constexpr uint32_t lookupCount = 1 << 16;
+    const auto         paths       = makePaths();
+    Map                map;
+    for(const auto& path : paths)
+    {
+        map.getOrCreate(path, [&]() { return static_cast<uint32_t>(path.size()); });
+    }
+
+    runner.run(name, threadCount, uint64_t{lookupCount} * threadCount, [&]() {
+        return Runner::measure([&]() {
+            runThreads(threadCount, [&](uint32_t t) {
+                uint32_t sum = 0;
+                for(uint32_t i = 0; i < lookupCount; ++i)
+                {
+                    sum += map.getOrCreate(paths[(i * 7 + t) % KEY_COUNT], []() { return 0u; });
+                }
+                spin(sum & 1);
+            });
+        });
+    });
+}
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    Runner runner{argc, argv};
+
+    for(uint32_t threadCount : getThreadCounts())
+    {
+        benchLoad<LockedHashMap<std::string, uint32_t>>(runner, "cache.load.mutex", threadCount);
+        benchLoad<ConcurrentHashMap<std::string, uint32_t>>(runner, "cache.load.sharded", threadCount);
+        benchLookup<LockedHashMap<std::string, uint32_t>>(runner, "cache.lookup.mutex", threadCount);
+        benchLookup<ConcurrentHashMap<std::string, uint32_t>>(runner, "cache.lookup.sharded", threadCount);
+    }
+
+    return runner.finish();
+}
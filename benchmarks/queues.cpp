@@ -0,0 +1,143 @@
+#include "benchmark.h"
+
+#include "threads/mpmcQueue.h"
+#include "threads/threadSafeQueue.h"
+
+using namespace aph;
+using bench::Runner;
+
+namespace
+{
+constexpr uint64_t ITEM_COUNT = 1 << 20;
+constexpr size_t   BATCH_SIZE = 16;
+
+// runs producerCount producers and consumerCount consumers over ITEM_COUNT items, returns the elapsed nanoseconds
+template <typename Produce, typename Consume, typename Finish>
+uint64_t runPipeline(uint32_t producerCount, uint32_t consumerCount, Produce&& produce, Consume&& consume,
+                     Finish&& finish)
+{
+    std::atomic_bool         start{false};
+    std::vector<std::thread> threads;
+    for(uint32_t i = 0; i < consumerCount; ++i)
+    {
+        threads.emplace_back([&]() {
+            while(!start.load(std::memory_order_acquire))
+            {
+            }
+            consume();
+        });
+    }
+    std::vector<std::thread> producers;
+    for(uint32_t i = 0; i < producerCount; ++i)
+    {
+        uint64_t begin = ITEM_COUNT * i / producerCount;
+        uint64_t end   = ITEM_COUNT * (i + 1) / producerCount;
+        producers.emplace_back([&, begin, end]() {
+            while(!start.load(std::memory_order_acquire))
+            {
+            }
+            produce(begin, end);
+        });
+    }
+
+    uint64_t time = Runner::measure([&]() {
+        start.store(true, std::memory_order_release);
+        for(auto& producer : producers)
+        {
+            producer.join();
+        }
+        finish();
+        for(auto& thread : threads)
+        {
+            thread.join();
+        }
+    });
+    return time;
+}
+
+void benchMix(Runner& runner, const char* mix, uint32_t producerCount, uint32_t consumerCount)
+{
+    const uint32_t threadCount = producerCount + consumerCount;
+    const auto     name        = [mix](const char* queue) { return std::string{queue} + "." + mix; };
+
+    runner.run(name("thread_safe_queue"), threadCount, ITEM_COUNT, [&]() {
+        ThreadSafeQueue<uint64_t> queue;
+        std::atomic<uint64_t>     consumed{0};
+        return runPipeline(
+            producerCount, consumerCount,
+            [&](uint64_t begin, uint64_t end) {
+                for(uint64_t i = begin; i < end; ++i)
+                {
+                    queue.push_back(std::move(i));
+                }
+            },
+            [&]() {
+                // no blocking pop, consumers poll until every item has been seen
+                while(consumed.load(std::memory_order_relaxed) < ITEM_COUNT)
+                {
+                    if(queue.pop_front())
+                    {
+                        consumed.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+            },
+            []() {});
+    });
+
+    runner.run(name("mpmc_queue"), threadCount, ITEM_COUNT, [&]() {
+        MPMCQueue<uint64_t> queue{1024};
+        return runPipeline(
+            producerCount, consumerCount,
+            [&](uint64_t begin, uint64_t end) {
+                for(uint64_t i = begin; i < end; ++i)
+                {
+                    queue.push(i);
+                }
+            },
+            [&]() {
+                while(queue.pop())
+                {
+                }
+            },
+            [&]() { queue.close(); });
+    });
+
+    runner.run(name("mpmc_queue_batch16"), threadCount, ITEM_COUNT, [&]() {
+        MPMCQueue<uint64_t> queue{1024};
+        return runPipeline(
+            producerCount, consumerCount,
+            [&](uint64_t begin, uint64_t end) {
+                std::array<uint64_t, BATCH_SIZE> batch;
+                for(uint64_t i = begin; i < end; i += BATCH_SIZE)
+                {
+                    std::size_t count = std::min<uint64_t>(BATCH_SIZE, end - i);
+                    for(std::size_t j = 0; j < count; ++j)
+                    {
+                        batch[j] = i + j;
+                    }
+                    queue.pushBatch(std::span{batch}.first(count));
+                }
+            },
+            [&]() {
+                std::array<uint64_t, BATCH_SIZE> batch;
+                while(queue.popBatch(batch))
+                {
+                }
+            },
+            [&]() { queue.close(); });
+    });
+}
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    Runner runner{argc, argv};
+
+    const uint32_t n = std::max(std::thread::hardware_concurrency() / 2, 2u);
+
+    benchMix(runner, "1:1", 1, 1);
+    benchMix(runner, (std::to_string(n) + ":1").c_str(), n, 1);
+    benchMix(runner, (std::to_string(n) + ":" + std::to_string(n)).c_str(), n, n);
+
+    return runner.finish();
+}
@@ -0,0 +1,273 @@
+#include "benchmark.h"
+
+#include <cmath>
+
+#include "threads/taskGraph.h"
+#include "threads/taskManager.h"
+#include "threads/threadPool.h"
+
+using namespace aph;
+using bench::Runner;
+
+namespace
+{
+std::vector<uint32_t> getThreadCounts()
+{
+    std::vector<uint32_t> threadCounts;
+    uint32_t              maxCount = std::max(std::thread::hardware_concurrency(), 1u);
+    for(uint32_t threadCount = 1; threadCount < maxCount; threadCount *= 2)
+    {
+        threadCounts.push_back(threadCount);
+    }
+    threadCounts.push_back(maxCount);
+    return threadCounts;
+}
+
+// roughly a microsecond of arithmetic that the optimizer cannot drop
+void spin(uint32_t iterations)
+{
+    volatile float value = 1.0f;
+    for(uint32_t i = 0; i < iterations; ++i)
+    {
+        value = value * 1.0001f + 0.5f;
+    }
+}
+
+void benchEmptyTasks(Runner& runner, uint32_t threadCount)
+{
+    constexpr uint64_t taskCount = 1 << 16;
+    TaskManager        taskManager{threadCount, "Bench"};
+
+    runner.run("task.empty", threadCount, taskCount, [&]() {
+        return Runner::measure([&]() {
+            auto group = taskManager.createTaskGroup("empty");
+            for(uint64_t i = 0; i < taskCount; ++i)
+            {
+                group->addTask([]() {});
+            }
+            group->wait();
+            taskManager.removeTaskGroup(group);
+        });
+    });
+}
+
+void benchThroughput(Runner& runner, uint32_t threadCount)
+{
+    constexpr uint64_t taskCount = 1 << 15;
+    TaskManager        taskManager{threadCount, "Bench"};
+
+    runner.run("task.throughput_1us", threadCount, taskCount, [&]() {
+        return Runner::measure([&]() {
+            auto group = taskManager.createTaskGroup("throughput");
+            for(uint64_t i = 0; i < taskCount; ++i)
+            {
+                group->addTask([]() { spin(256); });
+            }
+            group->wait();
+            taskManager.removeTaskGroup(group);
+        });
+    });
+}
+
+void benchParallelFor(Runner& runner, uint32_t threadCount)
+{
+    constexpr uint64_t count = 1 << 24;
+    TaskManager        taskManager{threadCount, "Bench"};
+    std::vector<float> data(count, 1.0f);
+
+    runner.run("task.parallel_for_16m", threadCount, count, [&]() {
+        return Runner::measure([&]() {
+            taskManager.parallelFor({0, count}, 4096, [&data](std::size_t begin, std::size_t end) {
+                for(std::size_t i = begin; i < end; ++i)
+                {
+                    data[i] = std::sqrt(data[i] * 1.0001f + 0.5f);
+                }
+            });
+        });
+    });
+}
+
+void benchDependencyChain(Runner& runner, uint32_t threadCount)
+{
+    constexpr uint64_t chainLength = 256;
+    TaskManager        taskManager{threadCount, "Bench"};
+
+    runner.run("group.chain_latency", threadCount, chainLength, [&]() {
+        std::vector<TaskGroup*> groups(chainLength);
+        for(uint64_t i = 0; i < chainLength; ++i)
+        {
+            groups[i] = taskManager.createTaskGroup("chain");
+            groups[i]->addTask([]() {});
+            if(i > 0)
+            {
+                taskManager.setDependency(groups[i], groups[i - 1]);
+            }
+        }
+        // only the implicit flush dependency of the head keeps the chain from starting
+        for(uint64_t i = 1; i < chainLength; ++i)
+        {
+            groups[i]->flush();
+        }
+
+        uint64_t time = Runner::measure([&]() {
+            groups.front()->flush();
+            groups.back()->wait();
+        });
+
+        for(TaskGroup* group : groups)
+        {
+            taskManager.removeTaskGroup(group);
+        }
+        return time;
+    });
+
+    TaskGraph graph{"chain", TaskPriority::Normal, &taskManager};
+    for(uint64_t i = 0; i < chainLength; ++i)
+    {
+        auto node = graph.addNode([]() {});
+        if(i > 0)
+        {
+            graph.addEdge(node - 1, node);
+        }
+    }
+    runner.run("graph.chain_latency", threadCount, chainLength, [&]() {
+        return Runner::measure([&]() {
+            graph.run();
+            graph.wait();
+        });
+    });
+}
+
+void benchFanOutFanIn(Runner& runner, uint32_t threadCount)
+{
+    constexpr uint64_t width = 1024;
+    TaskManager        taskManager{threadCount, "Bench"};
+
+    TaskGraph graph{"fan", TaskPriority::Normal, &taskManager};
+    auto      root = graph.addNode([]() {});
+    auto      join = graph.addNode([]() {});
+    for(uint64_t i = 0; i < width; ++i)
+    {
+        auto node = graph.addNode([]() { spin(64); });
+        graph.addEdge(root, node);
+        graph.addEdge(node, join);
+    }
+
+    // one op is one full root -> width -> join round
+    runner.run("graph.fan_out_in_1024", threadCount, 1, [&]() {
+        return Runner::measure([&]() {
+            graph.run();
+            graph.wait();
+        });
+    });
+}
+
+void benchThreadPoolFuture(Runner& runner, uint32_t threadCount)
+{
+    constexpr uint64_t taskCount = 1 << 12;
+    ThreadPool<>       pool{threadCount};
+
+    // enqueue and wait for each future in turn, the cost of one round trip
+    runner.run("pool.enqueue_get", threadCount, taskCount, [&]() {
+        return Runner::measure([&]() {
+            for(uint64_t i = 0; i < taskCount; ++i)
+            {
+                pool.enqueue([]() { return 0; }).get();
+            }
+        });
+    });
+
+    // enqueue everything first, the cost of the promise/future pair and the queue
+    runner.run("pool.enqueue_batch", threadCount, taskCount, [&]() {
+        std::vector<std::future<int>> futures;
+        futures.reserve(taskCount);
+        return Runner::measure([&]() {
+            for(uint64_t i = 0; i < taskCount; ++i)
+            {
+                futures.push_back(pool.enqueue([]() { return 0; }));
+            }
+            for(auto& future : futures)
+            {
+                future.get();
+            }
+        });
+    });
+}
+
+void benchWakeupLatency(Runner& runner, uint32_t threadCount)
+{
+    TaskManager taskManager{threadCount, "Bench"};
+
+    // time from submitting a task to it starting after the workers have been idle for idleTime
+    auto wakeup = [&taskManager](std::chrono::microseconds idleTime) {
+        std::this_thread::sleep_for(idleTime);
+
+        std::atomic<uint64_t> startTime = 0;
+        auto                  group     = taskManager.createTaskGroup("wakeup");
+        group->addTask([&startTime]() { startTime.store(Runner::now(), std::memory_order_relaxed); });
+
+        uint64_t submitTime = Runner::now();
+        group->flush();
+        // a blocking wait would run the task on this thread
+        while(!group->poll())
+        {
+            std::this_thread::yield();
+        }
+        taskManager.removeTaskGroup(group);
+        return startTime.load(std::memory_order_relaxed) - submitTime;
+    };
+
+    // every worker has gone to sleep
+    runner.run("task.wakeup_latency", threadCount, 1, [&]() { return wakeup(std::chrono::milliseconds(5)); });
+
+    // short gap between bursts, the idle policy decides whether the workers are still spinning
+    std::vector<uint32_t> spinCounts = {0u, thread::IdlePolicy{}.spinCount, thread::calibrateIdlePolicy().spinCount};
+    std::sort(spinCounts.begin(), spinCounts.end());
+    spinCounts.erase(std::unique(spinCounts.begin(), spinCounts.end()), spinCounts.end());
+    for(uint32_t spinCount : spinCounts)
+    {
+        taskManager.setIdlePolicy({.spinCount = spinCount});
+        runner.run("task.wakeup_latency_after_burst_spin" + std::to_string(spinCount), threadCount, 1,
+                   [&]() { return wakeup(std::chrono::microseconds(20)); });
+    }
+    taskManager.setIdlePolicy({});
+}
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    // per-task debug logs would dominate every measurement
+    Logger::GetInstance().setLogLevel(Logger::Level::Warn);
+
+    Runner runner{argc, argv};
+
+    auto threadCounts = getThreadCounts();
+    // single-threaded and fully parallel
+    std::vector<uint32_t> extremes = {1};
+    if(threadCounts.back() > 1)
+    {
+        extremes.push_back(threadCounts.back());
+    }
+
+    for(uint32_t threadCount : extremes)
+    {
+        benchEmptyTasks(runner, threadCount);
+    }
+    for(uint32_t threadCount : threadCounts)
+    {
+        benchThroughput(runner, threadCount);
+        benchParallelFor(runner, threadCount);
+    }
+    benchDependencyChain(runner, threadCounts.back());
+    for(uint32_t threadCount : threadCounts)
+    {
+        benchFanOutFanIn(runner, threadCount);
+    }
+    for(uint32_t threadCount : extremes)
+    {
+        benchThreadPoolFuture(runner, threadCount);
+        benchWakeupLatency(runner, threadCount);
+    }
+
+    return runner.finish();
+}
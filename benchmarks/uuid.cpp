@@ -0,0 +1,116 @@
+#include "benchmark.h"
+
+#include "common/logger.h"
+#include "common/uuid.h"
+
+using namespace aph;
+using namespace aph::uuid;
+using bench::Runner;
+
+namespace
+{
+constexpr uint32_t UUID_COUNT = 1 << 14;
+
+std::vector<UUID> makeUUIDs()
+{
+    UUIDGenerator<std::mt19937_64> generator{42};
+    std::vector<UUID>              uuids(UUID_COUNT);
+    generator.generate(uuids);
+    return uuids;
+}
+
+// one str() call per uuid, how ids were printed before the batch api
+void benchFormatSingle(Runner& runner)
+{
+    const auto  uuids = makeUUIDs();
+    std::string str(UUID_COUNT * STRING_LENGTH, '\0');
+
+    runner.run("uuid.format.single", 1, UUID_COUNT, [&]() {
+        return Runner::measure([&]() {
+            for(uint32_t i = 0; i < UUID_COUNT; ++i)
+            {
+                uuids[i].str(str.data() + i * STRING_LENGTH);
+            }
+        });
+    });
+}
+
+void benchFormatBatch(Runner& runner, simd::Level level)
+{
+    const auto  uuids = makeUUIDs();
+    std::string str(UUID_COUNT * STRING_LENGTH, '\0');
+
+    runner.run(std::string{"uuid.format.batch."} + simd::toString(level), 1, UUID_COUNT, [&]() {
+        return Runner::measure([&]() { format(uuids, str.data(), level); });
+    });
+}
+
+void benchParseSingle(Runner& runner)
+{
+    const auto  uuids = makeUUIDs();
+    std::string str(UUID_COUNT * STRING_LENGTH, '\0');
+    format(uuids, str.data());
+    std::vector<UUID> parsed(UUID_COUNT);
+
+    runner.run("uuid.parse.single", 1, UUID_COUNT, [&]() {
+        return Runner::measure([&]() {
+            for(uint32_t i = 0; i < UUID_COUNT; ++i)
+            {
+                parsed[i].fromStr(str.data() + i * STRING_LENGTH);
+            }
+        });
+    });
+}
+
+void benchParseBatch(Runner& runner, simd::Level level)
+{
+    const auto  uuids = makeUUIDs();
+    std::string str(UUID_COUNT * STRING_LENGTH, '\0');
+    format(uuids, str.data());
+    std::vector<UUID> parsed(UUID_COUNT);
+
+    runner.run(std::string{"uuid.parse.batch."} + simd::toString(level), 1, UUID_COUNT, [&]() {
+        return Runner::measure([&]() { parse(str.data(), parsed, level); });
+    });
+}
+
+void benchGenerate(Runner& runner)
+{
+    UUIDGenerator<std::mt19937_64> generator{42};
+    std::vector<UUID>              uuids(UUID_COUNT);
+
+    runner.run("uuid.generate.single", 1, UUID_COUNT, [&]() {
+        return Runner::measure([&]() {
+            for(auto& uuid : uuids)
+            {
+                uuid = generator.getUUID();
+            }
+        });
+    });
+    runner.run("uuid.generate.batch", 1, UUID_COUNT, [&]() {
+        return Runner::measure([&]() { generator.generate(uuids); });
+    });
+}
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    // the simd level is logged on first use, keep it out of a report written to stdout
+    Logger::GetInstance().setLogLevel(Logger::Level::Warn);
+
+    Runner runner{argc, argv};
+
+    benchFormatSingle(runner);
+    for(simd::Level level : simd::getSupportedLevels())
+    {
+        benchFormatBatch(runner, level);
+    }
+    benchParseSingle(runner);
+    for(simd::Level level : simd::getSupportedLevels())
+    {
+        benchParseBatch(runner, level);
+    }
+    benchGenerate(runner);
+
+    return runner.finish();
+}
@@ -0,0 +1,91 @@
+#include "benchmark.h"
+
+#include "threads/threadSafeQueue.h"
+#include "threads/workStealingQueue.h"
+
+using namespace aph;
+using bench::Runner;
+
+namespace
+{
+constexpr int ITEM_COUNT = 1 << 20;
+
+// One owner pushes and pops from the bottom while (threadCount - 1) thieves steal from the top, returns the elapsed
+// nanoseconds until every item has been consumed.
+template <typename Queue, typename Push, typename Pop, typename Steal>
+uint64_t measureContention(uint32_t threadCount, Push&& push, Pop&& pop, Steal&& steal)
+{
+    Queue             queue;
+    std::atomic<bool> done{false};
+    std::atomic<int>  consumed{0};
+
+    std::vector<std::thread> thieves;
+    for(uint32_t t = 1; t < threadCount; ++t)
+    {
+        thieves.emplace_back([&]() {
+            while(!done.load(std::memory_order_acquire))
+            {
+                if(steal(queue))
+                {
+                    consumed.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+
+    uint64_t time = Runner::measure([&]() {
+        for(int i = 0; i < ITEM_COUNT; ++i)
+        {
+            push(queue, i);
+            if(i & 1)
+            {
+                if(pop(queue))
+                {
+                    consumed.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        }
+        while(consumed.load(std::memory_order_relaxed) < ITEM_COUNT)
+        {
+            if(pop(queue))
+            {
+                consumed.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    });
+
+    done.store(true, std::memory_order_release);
+    for(auto& t : thieves)
+    {
+        t.join();
+    }
+    return time;
+}
+
+void benchContention(Runner& runner, uint32_t threadCount)
+{
+    runner.run("deque.steal.thread_safe_queue", threadCount, ITEM_COUNT, [&]() {
+        return measureContention<ThreadSafeQueue<int>>(
+            threadCount, [](auto& q, int i) { q.push_back(std::move(i)); },
+            [](auto& q) { return q.pop_back().has_value(); }, [](auto& q) { return q.pop_front().has_value(); });
+    });
+
+    runner.run("deque.steal.work_stealing_queue", threadCount, ITEM_COUNT, [&]() {
+        return measureContention<WorkStealingQueue<int>>(
+            threadCount, [](auto& q, int i) { q.push(i); }, [](auto& q) { return q.pop().has_value(); },
+            [](auto& q) { return q.steal().has_value(); });
+    });
+}
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    Runner runner{argc, argv};
+
+    for(uint32_t threadCount = 1; threadCount <= 64; threadCount *= 2)
+    {
+        benchContention(runner, threadCount);
+    }
+
+    return runner.finish();
+}
@@ -75,7 +75,6 @@ function(aph_compiler_options TARGET)
         # common options
         target_compile_options(${TARGET} PRIVATE
             -fdiagnostics-color=always
-            -mavx2
         )
 
         target_link_options(${TARGET} PRIVATE
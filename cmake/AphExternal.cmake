@@ -52,6 +52,8 @@ CPMAddPackage(
   PATCHES ${APH_PATCH_DIR}/vma.patch
 )
 
+if (APH_ENABLE_MIMALLOC)
+# no override, only the aph_* functions go through mimalloc so the two backends can be compared in one build
 CPMAddPackage(
   NAME mimalloc
   GITHUB_REPOSITORY microsoft/mimalloc
@@ -62,9 +64,10 @@ CPMAddPackage(
       "MI_BUILD_STATIC ON"
       "MI_BUILD_TESTS OFF"
       "MI_USE_CXX ON"
-      "MI_OVERRIDE ON"
+      "MI_OVERRIDE OFF"
   PATCHES ${APH_PATCH_DIR}/mimalloc.patch
 )
+endif()
 
 CPMAddPackage(
   NAME stb
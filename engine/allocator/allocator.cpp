@@ -1,8 +1,13 @@
 #include "allocator.h"
+#include "memoryTracker.h"
 #include <cstdlib>
 #include <cstring>
 #include <malloc.h>
 
+#ifdef APH_USE_MIMALLOC
+    #include <mimalloc.h>
+#endif
+
 namespace
 {
 template <std::integral T>
@@ -10,24 +15,86 @@ constexpr T alignTo(T size, T alignment) noexcept
 {
     return ((size + alignment - 1) & ~(alignment - 1));
 }
+
+// the general heap behind the aph_* functions, glibc or mimalloc depending on APH_ENABLE_MIMALLOC
+#ifdef APH_USE_MIMALLOC
+inline void* backendMalloc(size_t size)
+{
+    return mi_malloc(size);
+}
+inline void* backendMemalign(size_t align, size_t size)
+{
+    return mi_malloc_aligned(size, align);
+}
+inline void* backendCalloc(size_t count, size_t size)
+{
+    return mi_calloc(count, size);
+}
+inline void* backendRealloc(void* ptr, size_t size)
+{
+    return mi_realloc(ptr, size);
+}
+inline void backendFree(void* ptr)
+{
+    mi_free(ptr);
+}
+#else
+inline void* backendMalloc(size_t size)
+{
+    return std::malloc(size);
+}
+inline void* backendMemalign(size_t align, size_t size)
+{
+    return std::aligned_alloc(align, size);
+}
+inline void* backendCalloc(size_t count, size_t size)
+{
+    return std::calloc(count, size);
+}
+inline void* backendRealloc(void* ptr, size_t size)
+{
+    return std::realloc(ptr, size);
+}
+inline void backendFree(void* ptr)
+{
+    std::free(ptr);
+}
+#endif
+
+inline void* trackAllocation(void* ptr, size_t size, const char* f, int l, const char* sf)
+{
+#ifdef APH_MEMORY_TRACKING
+    aph::memory::MemoryTracker::GetInstance().onAllocate(ptr, size, f, l, sf);
+#endif
+    return ptr;
+}
+
+inline size_t trackFree(void* ptr)
+{
+#ifdef APH_MEMORY_TRACKING
+    return aph::memory::MemoryTracker::GetInstance().onFree(ptr);
+#else
+    return 0;
+#endif
+}
 }
 
 namespace aph::memory
 {
 void* malloc_internal(size_t size, const char* f, int l, const char* sf)
 {
-    return std::malloc(size);
+    return trackAllocation(backendMalloc(size), size, f, l, sf);
 }
 
 void* memalign_internal(size_t align, size_t size, const char* f, int l, const char* sf)
 {
     size_t alignedSize = alignTo(size, align);
-    return std::aligned_alloc(align, alignedSize);
+    return trackAllocation(backendMemalign(align, alignedSize), alignedSize, f, l, sf);
 }
 
 void* calloc_internal(size_t count, size_t size, const char* f, int l, const char* sf)
 {
-    return std::calloc(count, size);
+    return trackAllocation(backendCalloc(count, size), count * size, f, l, sf);
 }
 
 void* calloc_memalign(size_t count, size_t alignment, size_t size)
@@ -35,24 +102,35 @@ void* calloc_memalign(size_t count, size_t alignment, size_t size)
     size_t alignedArrayElementSize = alignTo(size, alignment);
     size_t totalBytes              = count * alignedArrayElementSize;
 
-    void* ptr = memalign(alignment, totalBytes);
+    // must come from the same backend as everything aph_free releases
+    void* ptr = backendMemalign(alignment, totalBytes);
 
-    std::memset(ptr, 0, totalBytes);
+    if(ptr)
+    {
+        std::memset(ptr, 0, totalBytes);
+    }
     return ptr;
 }
 
 void* calloc_memalign_internal(size_t count, size_t align, size_t size, const char* f, int l, const char* sf)
 {
-    return calloc_memalign(count, align, size);
+    return trackAllocation(calloc_memalign(count, align, size), count * alignTo(size, align), f, l, sf);
 }
 
 void* realloc_internal(void* ptr, size_t size, const char* f, int l, const char* sf)
 {
-    return std::realloc(ptr, size);
+#ifdef APH_MEMORY_TRACKING
+    // the tracker holds its lock around the realloc, the freed address can't be handed out and tracked elsewhere
+    // before its record is gone
+    return MemoryTracker::GetInstance().reallocate(ptr, size, backendRealloc, f, l, sf);
+#else
+    return backendRealloc(ptr, size);
+#endif
 }
 
 void free_internal(void* ptr, const char* f, int l, const char* sf)
 {
-    std::free(ptr);
+    trackFree(ptr);
+    backendFree(ptr);
 }
 }  // namespace aph::memory
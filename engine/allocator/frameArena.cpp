@@ -0,0 +1,112 @@
+#include "frameArena.h"
+#include <bit>
+
+namespace
+{
+constexpr std::size_t BLOCK_ALIGNMENT = 64;
+}
+
+namespace aph
+{
+FrameArena::FrameArena(uint32_t frameCount, std::size_t frameSize) :
+    m_frames(std::make_unique<Frame[]>(frameCount)),
+    m_frameCount(frameCount)
+{
+    APH_ASSERT(frameCount > 0);
+    frameSize = std::bit_ceil(std::max(frameSize, BLOCK_ALIGNMENT));
+    for(uint32_t i = 0; i < m_frameCount; ++i)
+    {
+        m_frames[i].pBlock   = static_cast<std::byte*>(memory::aph_memalign(BLOCK_ALIGNMENT, frameSize));
+        m_frames[i].capacity = frameSize;
+    }
+}
+
+FrameArena::~FrameArena()
+{
+    for(uint32_t i = 0; i < m_frameCount; ++i)
+    {
+        for(void* ptr : m_frames[i].overflow)
+        {
+            memory::aph_free(ptr);
+        }
+        memory::aph_free(m_frames[i].pBlock);
+    }
+}
+
+void FrameArena::beginFrame(uint32_t frameIndex)
+{
+    APH_ASSERT(frameIndex < m_frameCount);
+    m_frameIndex = frameIndex;
+
+    Frame& frame = m_frames[frameIndex];
+    if(!frame.overflow.empty())
+    {
+        // the block was too small last time, size it for everything the frame asked for
+        std::size_t capacity = std::bit_ceil(frame.offset.load(std::memory_order_relaxed) + frame.overflowSize);
+        MM_LOG_DEBUG("frame arena: frame %u spilled %zu bytes to the heap, growing its block to %zu bytes", frameIndex,
+                     frame.overflowSize, capacity);
+
+        for(void* ptr : frame.overflow)
+        {
+            memory::aph_free(ptr);
+        }
+        frame.overflow.clear();
+        frame.overflowSize = 0;
+
+        memory::aph_free(frame.pBlock);
+        frame.pBlock   = static_cast<std::byte*>(memory::aph_memalign(BLOCK_ALIGNMENT, capacity));
+        frame.capacity = capacity;
+    }
+    frame.offset.store(0, std::memory_order_relaxed);
+}
+
+void* FrameArena::allocate(std::size_t size, std::size_t alignment)
+{
+    APH_ASSERT(std::has_single_bit(alignment));
+    Frame& frame = m_frames[m_frameIndex];
+
+    const auto  base   = reinterpret_cast<uintptr_t>(frame.pBlock);
+    std::size_t offset = frame.offset.load(std::memory_order_relaxed);
+    for(;;)
+    {
+        std::size_t begin = ((base + offset + alignment - 1) & ~(alignment - 1)) - base;
+        std::size_t end   = begin + size;
+        if(end > frame.capacity)
+        {
+            return allocateOverflow(frame, size, alignment);
+        }
+        if(frame.offset.compare_exchange_weak(offset, end, std::memory_order_relaxed))
+        {
+            return frame.pBlock + begin;
+        }
+    }
+}
+
+void* FrameArena::allocateOverflow(Frame& frame, std::size_t size, std::size_t alignment)
+{
+    alignment = std::max(alignment, alignof(std::max_align_t));
+    void* ptr = memory::aph_memalign(alignment, size);
+
+    std::lock_guard<std::mutex> holder{frame.overflowLock};
+    frame.overflow.push_back(ptr);
+    frame.overflowSize += size + alignment;
+    return ptr;
+}
+
+std::size_t FrameArena::getUsedSize() const
+{
+    return m_frames[m_frameIndex].offset.load(std::memory_order_relaxed);
+}
+
+std::size_t FrameArena::getOverflowSize() const
+{
+    const Frame&                frame = m_frames[m_frameIndex];
+    std::lock_guard<std::mutex> holder{frame.overflowLock};
+    return frame.overflowSize;
+}
+
+std::size_t FrameArena::getCapacity() const
+{
+    return m_frames[m_frameIndex].capacity;
+}
+}  // namespace aph
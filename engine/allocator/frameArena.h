@@ -0,0 +1,98 @@
+#ifndef APH_FRAME_ARENA_H_
+#define APH_FRAME_ARENA_H_
+
+#include <memory_resource>
+#include "allocator/allocator.h"
+#include "common/common.h"
+#include "common/smallVector.h"
+
+namespace aph
+{
+/*
+ * Bump allocator for scratch memory that lives for one frame.
+ *
+ * Every frame in flight owns a block. beginFrame(i) recycles the block of frame i in O(1), so the caller has to make
+ * sure nothing still reads what frame i handed out last time (e.g. by waiting on its fence first). Allocation is a
+ * CAS on the block offset and may happen from any thread; beginFrame must not race with allocations.
+ *
+ * Nothing is destroyed on reset, only put trivially destructible objects in the arena. Requests that do not fit the
+ * block fall back to the heap and are released with the frame, the block is then regrown to the high-water mark so
+ * after a warm-up frame the steady state does not touch the general heap at all.
+ *
+ * getResource() adapts the arena to std::pmr, e.g. std::pmr::vector<T> v{arena.getResource()}. Deallocation is a
+ * no-op, reserve containers whose size is known up front so growth does not waste the block.
+ */
+class FrameArena
+{
+public:
+    FrameArena(uint32_t frameCount, std::size_t frameSize = memory::MB);
+    ~FrameArena();
+
+    FrameArena(const FrameArena&)            = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    void beginFrame(uint32_t frameIndex);
+
+    void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+
+    template <typename T>
+    T* allocate(std::size_t count)
+    {
+        return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+    template <typename T, typename... Args>
+    T* create(Args&&... args)
+    {
+        static_assert(std::is_trivially_destructible_v<T>, "the frame arena never runs destructors");
+        return memory::placement_new<T>(allocate(sizeof(T), alignof(T)), std::forward<Args>(args)...);
+    }
+
+    std::pmr::memory_resource* getResource() { return &m_resource; }
+
+    uint32_t getFrameCount() const { return m_frameCount; }
+    uint32_t getFrameIndex() const { return m_frameIndex; }
+
+    // statistics of the current frame
+    std::size_t getUsedSize() const;
+    std::size_t getOverflowSize() const;
+    std::size_t getCapacity() const;
+
+private:
+    struct Frame
+    {
+        std::byte*               pBlock   = {};
+        std::size_t              capacity = {};
+        std::atomic<std::size_t> offset   = {};
+
+        mutable std::mutex overflowLock;
+        SmallVector<void*> overflow;
+        std::size_t        overflowSize = {};
+    };
+
+    class Resource : public std::pmr::memory_resource
+    {
+    public:
+        explicit Resource(FrameArena* pArena) : m_pArena(pArena) {}
+
+    private:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override
+        {
+            return m_pArena->allocate(bytes, alignment);
+        }
+        void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {}
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+        FrameArena* m_pArena = {};
+    };
+
+    void* allocateOverflow(Frame& frame, std::size_t size, std::size_t alignment);
+
+    std::unique_ptr<Frame[]> m_frames;
+    uint32_t                 m_frameCount = {};
+    uint32_t                 m_frameIndex = {};
+    Resource                 m_resource{this};
+};
+}  // namespace aph
+
+#endif  // APH_FRAME_ARENA_H_
@@ -0,0 +1,220 @@
+#include "hugePageArena.h"
+#include <bit>
+
+#if defined(__linux__)
+    #include <sys/mman.h>
+#endif
+
+namespace
+{
+std::size_t alignUp(std::size_t value, std::size_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+#if defined(__linux__)
+struct Range
+{
+    uintptr_t begin = {};
+    uintptr_t end   = {};
+};
+
+// AnonHugePages of every smaps entry that overlaps one of the ranges, capped to the overlap. Neighbouring mappings
+// with the same flags may be merged into one entry by the kernel, so this is an estimate and not exact.
+std::size_t queryTransparentHugePages(const std::vector<Range>& ranges)
+{
+    std::ifstream smaps{"/proc/self/smaps"};
+    if(!smaps || ranges.empty())
+    {
+        return 0;
+    }
+
+    std::size_t result  = 0;
+    std::size_t overlap = 0;
+    std::string line;
+    while(std::getline(smaps, line))
+    {
+        unsigned long begin = 0, end = 0;
+        std::size_t   kb    = 0;
+        if(std::sscanf(line.c_str(), "%lx-%lx ", &begin, &end) == 2)
+        {
+            overlap = 0;
+            for(const Range& range : ranges)
+            {
+                uintptr_t lo = std::max<uintptr_t>(range.begin, begin);
+                uintptr_t hi = std::min<uintptr_t>(range.end, end);
+                overlap += hi > lo ? hi - lo : 0;
+            }
+        }
+        else if(overlap && std::sscanf(line.c_str(), "AnonHugePages: %zu kB", &kb) == 1)
+        {
+            result += std::min(kb * aph::memory::KB, overlap);
+        }
+    }
+    return result;
+}
+#endif
+}  // namespace
+
+namespace aph::memory
+{
+HugePageArena::~HugePageArena()
+{
+    for(auto& [ptr, block] : m_blocks)
+    {
+        unmap(ptr, block);
+    }
+}
+
+void* HugePageArena::allocate(std::size_t size, std::size_t alignment)
+{
+    APH_ASSERT(std::has_single_bit(alignment));
+    Block block{.size = size};
+
+    void* ptr = size >= m_threshold ? map(size, alignment, block) : nullptr;
+    if(!ptr)
+    {
+        block.backing = Backing::Heap;
+        ptr           = aph_memalign(std::max(alignment, alignof(std::max_align_t)), size);
+        if(!ptr)
+        {
+            return nullptr;
+        }
+    }
+
+    std::lock_guard<std::mutex> holder{m_lock};
+    m_blocks[ptr] = block;
+    return ptr;
+}
+
+void HugePageArena::free(void* ptr)
+{
+    if(!ptr)
+    {
+        return;
+    }
+
+    Block block;
+    {
+        std::lock_guard<std::mutex> holder{m_lock};
+        auto                        it = m_blocks.find(ptr);
+        if(it == m_blocks.end())
+        {
+            MM_LOG_ERR("huge page arena: %p was not allocated from this arena.", ptr);
+            APH_ASSERT(false);
+            return;
+        }
+        block = it->second;
+        m_blocks.erase(it);
+    }
+    unmap(ptr, block);
+}
+
+void* HugePageArena::map(std::size_t size, std::size_t alignment, Block& block)
+{
+#if defined(__linux__)
+    const std::size_t mapped = alignUp(size, HUGE_PAGE_SIZE);
+
+    // explicit huge pages, only if the administrator reserved a pool (vm.nr_hugepages)
+    if(alignment <= HUGE_PAGE_SIZE)
+    {
+        void* ptr = mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if(ptr != MAP_FAILED)
+        {
+            block.mapped  = mapped;
+            block.backing = Backing::HugeTlb;
+            return ptr;
+        }
+    }
+
+    // transparent huge pages need a huge page aligned range, over-map and trim
+    alignment                  = std::max(alignment, HUGE_PAGE_SIZE);
+    const std::size_t reserved = mapped + alignment;
+    void*             base     = mmap(nullptr, reserved, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(base == MAP_FAILED)
+    {
+        MM_LOG_WARN("huge page arena: failed to map %zu bytes, falling back to the heap.", mapped);
+        return nullptr;
+    }
+
+    const uintptr_t begin   = reinterpret_cast<uintptr_t>(base);
+    const uintptr_t aligned = alignUp(begin, alignment);
+    if(aligned > begin)
+    {
+        munmap(base, aligned - begin);
+    }
+    if(begin + reserved > aligned + mapped)
+    {
+        munmap(reinterpret_cast<void*>(aligned + mapped), begin + reserved - aligned - mapped);
+    }
+
+    void* ptr = reinterpret_cast<void*>(aligned);
+    // fails when THP is disabled system wide, the mapping is still usable with regular pages
+    if(madvise(ptr, mapped, MADV_HUGEPAGE) != 0)
+    {
+        MM_LOG_DEBUG("huge page arena: MADV_HUGEPAGE is not available, %zu bytes stay on regular pages.", mapped);
+    }
+    block.mapped  = mapped;
+    block.backing = Backing::Transparent;
+    return ptr;
+#else
+    return nullptr;
+#endif
+}
+
+void HugePageArena::unmap(void* ptr, const Block& block)
+{
+    if(block.backing == Backing::Heap)
+    {
+        aph_free(ptr);
+        return;
+    }
+#if defined(__linux__)
+    munmap(ptr, block.mapped);
+#endif
+}
+
+HugePageStats HugePageArena::getStats() const
+{
+    HugePageStats stats;
+#if defined(__linux__)
+    std::vector<Range> transparent;
+#endif
+    {
+        std::lock_guard<std::mutex> holder{m_lock};
+        for(const auto& [ptr, block] : m_blocks)
+        {
+            stats.liveCount++;
+            stats.requestedBytes += block.size;
+            switch(block.backing)
+            {
+            case Backing::Heap:
+                stats.heapBytes += block.size;
+                break;
+            case Backing::HugeTlb:
+                stats.mappedBytes += block.mapped;
+                stats.hugeTlbBytes += block.mapped;
+                break;
+            case Backing::Transparent:
+                stats.mappedBytes += block.mapped;
+#if defined(__linux__)
+                transparent.push_back({reinterpret_cast<uintptr_t>(ptr),
+                                       reinterpret_cast<uintptr_t>(ptr) + block.mapped});
+#endif
+                break;
+            }
+        }
+    }
+
+#if defined(__linux__)
+    // outside the lock, reading smaps walks the page tables of the whole process
+    stats.thpBytes = queryTransparentHugePages(transparent);
+#endif
+    if(stats.mappedBytes)
+    {
+        stats.coverage =
+            static_cast<double>(stats.hugeTlbBytes + stats.thpBytes) / static_cast<double>(stats.mappedBytes);
+    }
+    return stats;
+}
+}  // namespace aph::memory
@@ -0,0 +1,100 @@
+#ifndef APH_HUGE_PAGE_ARENA_H_
+#define APH_HUGE_PAGE_ARENA_H_
+
+#include <memory_resource>
+#include "allocator/allocator.h"
+#include "common/common.h"
+#include "common/hash.h"
+#include "common/singleton.h"
+
+namespace aph::memory
+{
+constexpr std::size_t HUGE_PAGE_SIZE = 2 * MB;
+
+struct HugePageStats
+{
+    std::size_t liveCount      = 0;  // live allocations, either path
+    std::size_t requestedBytes = 0;  // bytes asked for by the live allocations
+    std::size_t heapBytes      = 0;  // below the threshold, or no huge page support, served by aph_memalign
+    std::size_t mappedBytes    = 0;  // mapped for allocations at or above the threshold, rounded to huge pages
+    std::size_t hugeTlbBytes   = 0;  // part of mappedBytes from the MAP_HUGETLB pool
+    std::size_t thpBytes       = 0;  // part of mappedBytes currently backed by transparent huge pages
+    double      coverage       = 0;  // (hugeTlbBytes + thpBytes) / mappedBytes
+};
+
+/*
+ * Source for large, long lived blobs (decoded images, geometry byte arrays) that are walked linearly and would
+ * otherwise spread over thousands of 4K pages and TLB entries.
+ *
+ * Allocations at or above the threshold get their own mapping rounded up to HUGE_PAGE_SIZE: explicit huge pages from
+ * the hugetlbfs pool (MAP_HUGETLB) when it has room, otherwise a huge page aligned anonymous mapping advised with
+ * MADV_HUGEPAGE so the kernel backs it with transparent huge pages. Smaller allocations, and everything on platforms
+ * without huge page support, go to aph_memalign.
+ *
+ * getStats() reports how much of the mapped memory is actually on huge pages, for transparent huge pages this reads
+ * /proc/self/smaps and is meant for load time diagnostics, not for every frame.
+ */
+class HugePageArena : public Singleton<HugePageArena>
+{
+public:
+    static constexpr std::size_t DEFAULT_THRESHOLD = 4 * MB;
+
+    explicit HugePageArena(std::size_t threshold = DEFAULT_THRESHOLD) : m_threshold(threshold) {}
+    ~HugePageArena() override;
+
+    void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+    void  free(void* ptr);
+
+    // for std::pmr containers, e.g. std::pmr::vector<uint8_t> blob{arena.getResource()}
+    std::pmr::memory_resource* getResource() { return &m_resource; }
+    std::size_t                getThreshold() const { return m_threshold; }
+
+    HugePageStats getStats() const;
+
+private:
+    enum class Backing : uint8_t
+    {
+        Heap,
+        HugeTlb,
+        Transparent,
+    };
+
+    struct Block
+    {
+        std::size_t size    = {};
+        std::size_t mapped  = {};
+        Backing     backing = {};
+    };
+
+    class Resource : public std::pmr::memory_resource
+    {
+    public:
+        explicit Resource(HugePageArena* pArena) : m_pArena(pArena) {}
+
+    private:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override
+        {
+            void* ptr = m_pArena->allocate(bytes, alignment);
+            if(!ptr)
+            {
+                throw std::bad_alloc{};
+            }
+            return ptr;
+        }
+        void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override { m_pArena->free(p); }
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+        HugePageArena* m_pArena = {};
+    };
+
+    void* map(std::size_t size, std::size_t alignment, Block& block);
+    void  unmap(void* ptr, const Block& block);
+
+    std::size_t           m_threshold = {};
+    Resource              m_resource{this};
+    mutable std::mutex    m_lock;
+    HashMap<void*, Block> m_blocks;
+};
+}  // namespace aph::memory
+
+#endif  // APH_HUGE_PAGE_ARENA_H_
@@ -0,0 +1,84 @@
+#include "memoryHeap.h"
+#include "common/common.h"
+
+#ifdef APH_USE_MIMALLOC
+    #include <mimalloc.h>
+#endif
+
+namespace aph::memory
+{
+MemoryHeap::MemoryHeap(std::string name) : m_name(std::move(name))
+{
+#ifdef APH_USE_MIMALLOC
+    m_pHeap = mi_heap_new();
+    m_owner = std::this_thread::get_id();
+#endif
+}
+
+MemoryHeap::~MemoryHeap()
+{
+    releaseAll();
+}
+
+void* MemoryHeap::allocate(std::size_t size, std::size_t alignment)
+{
+#ifdef APH_USE_MIMALLOC
+    // mi_heap_t is thread affine, only its owner may allocate from it
+    APH_ASSERT(std::this_thread::get_id() == m_owner);
+    return mi_heap_malloc_aligned(m_pHeap, size, alignment);
+#else
+    alignment = std::max(alignment, alignof(std::max_align_t));
+    void* ptr = std::aligned_alloc(alignment, (size + alignment - 1) & ~(alignment - 1));
+    if(ptr)
+    {
+        std::lock_guard<std::mutex> holder{m_lock};
+        m_blocks.insert(ptr);
+    }
+    return ptr;
+#endif
+}
+
+void MemoryHeap::free(void* ptr)
+{
+    if(!ptr)
+    {
+        return;
+    }
+#ifdef APH_USE_MIMALLOC
+    mi_free(ptr);
+#else
+    {
+        std::lock_guard<std::mutex> holder{m_lock};
+        [[maybe_unused]] auto       erased = m_blocks.erase(ptr);
+        APH_ASSERT(erased && "the block does not belong to this heap");
+    }
+    std::free(ptr);
+#endif
+}
+
+void MemoryHeap::reset()
+{
+    releaseAll();
+#ifdef APH_USE_MIMALLOC
+    m_pHeap = mi_heap_new();
+    m_owner = std::this_thread::get_id();
+#endif
+}
+
+void MemoryHeap::releaseAll()
+{
+#ifdef APH_USE_MIMALLOC
+    APH_ASSERT(std::this_thread::get_id() == m_owner);
+    // frees every block of the heap without walking them one by one
+    mi_heap_destroy(m_pHeap);
+    m_pHeap = nullptr;
+#else
+    std::lock_guard<std::mutex> holder{m_lock};
+    for(void* ptr : m_blocks)
+    {
+        std::free(ptr);
+    }
+    m_blocks.clear();
+#endif
+}
+}  // namespace aph::memory
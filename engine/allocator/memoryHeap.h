@@ -0,0 +1,73 @@
+#ifndef APH_MEMORY_HEAP_H_
+#define APH_MEMORY_HEAP_H_
+
+#include <memory_resource>
+#include "common/hash.h"
+
+#ifdef APH_USE_MIMALLOC
+struct mi_heap_s;
+#endif
+
+namespace aph::memory
+{
+/*
+ * Heap owned by one subsystem, everything allocated from it is released at once by reset() or by destroying the heap,
+ * e.g. a loader heap dropped after a level has been uploaded.
+ *
+ * With APH_ENABLE_MIMALLOC this is a dedicated mi_heap_t: allocate, reset and destroy on the thread that created the
+ * heap, blocks may be freed on any thread. The fallback tracks live blocks in a locked set on top of malloc and has
+ * no thread restriction.
+ */
+class MemoryHeap
+{
+public:
+    explicit MemoryHeap(std::string name);
+    ~MemoryHeap();
+
+    MemoryHeap(const MemoryHeap&)            = delete;
+    MemoryHeap& operator=(const MemoryHeap&) = delete;
+
+    void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+    void  free(void* ptr);
+    void  reset();
+
+    std::pmr::memory_resource* getResource() { return &m_resource; }
+    const std::string&         getName() const { return m_name; }
+
+private:
+    class Resource : public std::pmr::memory_resource
+    {
+    public:
+        explicit Resource(MemoryHeap* pHeap) : m_pHeap(pHeap) {}
+
+    private:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override
+        {
+            void* ptr = m_pHeap->allocate(bytes, alignment);
+            if(!ptr)
+            {
+                throw std::bad_alloc{};
+            }
+            return ptr;
+        }
+        void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override { m_pHeap->free(p); }
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+        MemoryHeap* m_pHeap = {};
+    };
+
+    void releaseAll();
+
+    std::string m_name;
+    Resource    m_resource{this};
+#ifdef APH_USE_MIMALLOC
+    mi_heap_s*      m_pHeap = {};
+    std::thread::id m_owner = {};
+#else
+    std::mutex     m_lock;
+    HashSet<void*> m_blocks;
+#endif
+};
+}  // namespace aph::memory
+
+#endif  // APH_MEMORY_HEAP_H_
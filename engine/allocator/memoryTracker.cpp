@@ -0,0 +1,412 @@
+#include "memoryTracker.h"
+#include <cstdlib>
+#include "common/logger.h"
+
+namespace
+{
+thread_local const char* t_memoryTag = nullptr;
+
+// engine/<subsystem>/..., otherwise the directory of the file
+std::string getSubsystemName(std::string_view file)
+{
+    for(std::string_view root : {"engine/", "engine\\"})
+    {
+        if(auto pos = file.rfind(root); pos != std::string_view::npos)
+        {
+            std::string_view rest = file.substr(pos + root.size());
+            auto             end  = rest.find_first_of("/\\");
+            return std::string{end == std::string_view::npos ? "engine" : rest.substr(0, end)};
+        }
+    }
+
+    auto end = file.find_last_of("/\\");
+    if(end == std::string_view::npos || end == 0)
+    {
+        return "unknown";
+    }
+    auto begin = file.find_last_of("/\\", end - 1);
+    begin      = begin == std::string_view::npos ? 0 : begin + 1;
+    return std::string{file.substr(begin, end - begin)};
+}
+
+void addAllocation(aph::memory::MemoryCounters& counters, std::size_t size)
+{
+    counters.liveBytes += size;
+    counters.liveCount++;
+    counters.allocCount++;
+    counters.peakBytes = std::max(counters.peakBytes, counters.liveBytes);
+}
+
+void removeAllocation(aph::memory::MemoryCounters& counters, std::size_t size)
+{
+    counters.liveBytes -= size;
+    counters.liveCount--;
+}
+
+std::size_t getSortValue(const aph::memory::MemoryCounters& counters, aph::memory::MemorySortKey sortKey)
+{
+    switch(sortKey)
+    {
+    case aph::memory::MemorySortKey::PeakBytes:
+        return counters.peakBytes;
+    case aph::memory::MemorySortKey::AllocCount:
+        return counters.allocCount;
+    case aph::memory::MemorySortKey::LiveBytes:
+    default:
+        return counters.liveBytes;
+    }
+}
+
+std::string formatBytes(std::size_t bytes)
+{
+    constexpr const char* units[] = {"B", "KiB", "MiB", "GiB"};
+    double                value   = static_cast<double>(bytes);
+    std::size_t           unit    = 0;
+    while(value >= 1024.0 && unit + 1 < std::size(units))
+    {
+        value /= 1024.0;
+        unit++;
+    }
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), unit ? "%.1f %s" : "%.0f %s", value, units[unit]);
+    return buffer;
+}
+
+std::string escapeJson(std::string_view str)
+{
+    std::string escaped;
+    escaped.reserve(str.size());
+    for(char c : str)
+    {
+        if(c == '"' || c == '\\')
+        {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+std::string countersToJson(const aph::memory::MemoryCounters& counters)
+{
+    char buffer[160];
+    std::snprintf(buffer, sizeof(buffer),
+                  "\"liveBytes\": %zu, \"liveCount\": %zu, \"allocCount\": %zu, \"peakBytes\": %zu",
+                  counters.liveBytes, counters.liveCount, counters.allocCount, counters.peakBytes);
+    return buffer;
+}
+}  // namespace
+
+namespace aph::memory
+{
+MemoryTagScope::MemoryTagScope(const char* tag) : m_previous(t_memoryTag)
+{
+    t_memoryTag = tag;
+}
+
+MemoryTagScope::~MemoryTagScope()
+{
+    t_memoryTag = m_previous;
+}
+
+const char* MemoryTagScope::GetCurrent()
+{
+    return t_memoryTag;
+}
+
+std::size_t MemoryTracker::CallsiteKeyHash::operator()(const CallsiteKey& key) const
+{
+    std::size_t hash = std::hash<const void*>{}(key.file);
+    for(std::size_t value : {std::hash<const void*>{}(key.function), std::hash<int>{}(key.line),
+                             std::hash<const void*>{}(key.tag)})
+    {
+        hash ^= value + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+    }
+    return hash * 0xbf58476d1ce4e5b9ull;
+}
+
+MemoryTracker::~MemoryTracker()
+{
+    printLeaksAtExit();
+}
+
+MemoryTracker& MemoryTracker::GetInstance()
+{
+    // leaked on purpose, a function-local static would be destroyed before the static objects built ahead of the first
+    // tracked allocation, and their frees would then reach a dead tracker
+    static MemoryTracker* pTracker = []() {
+        auto* pInstance = new MemoryTracker{};
+        std::atexit([]() { GetInstance().printLeaksAtExit(); });
+        std::at_quick_exit([]() { GetInstance().printLeaksAtExit(); });
+        return pInstance;
+    }();
+    return *pTracker;
+}
+
+void MemoryTracker::onAllocate(void* ptr, std::size_t size, const char* file, int line, const char* function)
+{
+    if(!ptr)
+    {
+        return;
+    }
+
+    const char*                 tag = t_memoryTag;
+    std::lock_guard<std::mutex> holder{m_lock};
+    addRecord(ptr, size, file, line, function, tag);
+}
+
+std::size_t MemoryTracker::onFree(void* ptr)
+{
+    if(!ptr)
+    {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> holder{m_lock};
+    return removeRecord(ptr);
+}
+
+void* MemoryTracker::reallocate(void* ptr, std::size_t size, void* (*reallocFn)(void*, std::size_t),
+                                const char* file, int line, const char* function)
+{
+    // the old block is only known by its address once realloc succeeded, volatile keeps gcc's -Wuse-after-free from
+    // tracing that key back to the freed pointer
+    const volatile std::uintptr_t oldAddress = reinterpret_cast<std::uintptr_t>(ptr);
+
+    const char*                 tag = t_memoryTag;
+    std::lock_guard<std::mutex> holder{m_lock};
+
+    void* newPtr = reallocFn(ptr, size);
+    if(!newPtr && size)
+    {
+        // a failed realloc leaves the old block alive and still owned by its original callsite
+        return nullptr;
+    }
+
+    if(oldAddress)
+    {
+        removeRecord(reinterpret_cast<void*>(oldAddress));
+    }
+    if(newPtr)
+    {
+        addRecord(newPtr, size, file, line, function, tag);
+    }
+    return newPtr;
+}
+
+void MemoryTracker::addRecord(void* ptr, std::size_t size, const char* file, int line, const char* function,
+                              const char* tag)
+{
+    auto& pCallsite = m_callsites[{file, function, line, tag}];
+    if(!pCallsite)
+    {
+        pCallsite = std::make_unique<Callsite>(Callsite{
+            .key       = {file, function, line, tag},
+            .subsystem = tag ? std::string{tag} : getSubsystemName(file ? file : ""),
+        });
+        auto& pSubsystem = m_subsystems[pCallsite->subsystem];
+        if(!pSubsystem)
+        {
+            pSubsystem = std::make_unique<MemoryCounters>();
+        }
+        pCallsite->pSubsystem = pSubsystem.get();
+    }
+
+    // an address handed out twice means the free went around the tracker, drop the stale record
+    if(auto it = m_allocations.find(ptr); it != m_allocations.end())
+    {
+        removeAllocation(it->second.pCallsite->counters, it->second.size);
+        removeAllocation(*it->second.pCallsite->pSubsystem, it->second.size);
+        removeAllocation(m_total, it->second.size);
+    }
+
+    addAllocation(pCallsite->counters, size);
+    addAllocation(*pCallsite->pSubsystem, size);
+    addAllocation(m_total, size);
+    m_allocations[ptr] = {size, pCallsite.get()};
+}
+
+std::size_t MemoryTracker::removeRecord(void* ptr)
+{
+    auto it = m_allocations.find(ptr);
+    if(it == m_allocations.end())
+    {
+        return 0;
+    }
+
+    std::size_t size = it->second.size;
+    removeAllocation(it->second.pCallsite->counters, size);
+    removeAllocation(*it->second.pCallsite->pSubsystem, size);
+    removeAllocation(m_total, size);
+    m_allocations.erase(it);
+    return size;
+}
+
+MemoryCounters MemoryTracker::getTotal() const
+{
+    std::lock_guard<std::mutex> holder{m_lock};
+    return m_total;
+}
+
+SmallVector<MemoryCallsiteStats> MemoryTracker::getCallsites(MemorySortKey sortKey) const
+{
+    SmallVector<MemoryCallsiteStats> callsites;
+    {
+        std::lock_guard<std::mutex> holder{m_lock};
+        callsites.reserve(m_callsites.size());
+        for(const auto& [key, pCallsite] : m_callsites)
+        {
+            callsites.push_back({
+                .file      = key.file,
+                .function  = key.function,
+                .line      = key.line,
+                .subsystem = pCallsite->subsystem,
+                .counters  = pCallsite->counters,
+            });
+        }
+    }
+
+    std::sort(callsites.begin(), callsites.end(), [sortKey](const auto& lhs, const auto& rhs) {
+        return getSortValue(lhs.counters, sortKey) > getSortValue(rhs.counters, sortKey);
+    });
+    return callsites;
+}
+
+SmallVector<MemorySubsystemStats> MemoryTracker::getSubsystems(MemorySortKey sortKey) const
+{
+    SmallVector<MemorySubsystemStats> subsystems;
+    {
+        std::lock_guard<std::mutex> holder{m_lock};
+        subsystems.reserve(m_subsystems.size());
+        for(const auto& [name, pCounters] : m_subsystems)
+        {
+            subsystems.push_back({.name = name, .counters = *pCounters});
+        }
+    }
+
+    std::sort(subsystems.begin(), subsystems.end(), [sortKey](const auto& lhs, const auto& rhs) {
+        return getSortValue(lhs.counters, sortKey) > getSortValue(rhs.counters, sortKey);
+    });
+    return subsystems;
+}
+
+std::string MemoryTracker::report(MemorySortKey sortKey, std::size_t maxCallsites) const
+{
+    MemoryCounters total      = getTotal();
+    auto           subsystems = getSubsystems(sortKey);
+    auto           callsites  = getCallsites(sortKey);
+
+    std::string result;
+    char        line[1024];
+    std::snprintf(line, sizeof(line), "memory: %s live in %zu allocations, peak %s, %zu allocations in total\n",
+                  formatBytes(total.liveBytes).c_str(), total.liveCount, formatBytes(total.peakBytes).c_str(),
+                  total.allocCount);
+    result += line;
+
+    std::snprintf(line, sizeof(line), "%-20s %12s %12s %10s %12s\n", "subsystem", "live", "peak", "live#", "allocs");
+    result += line;
+    for(const auto& subsystem : subsystems)
+    {
+        std::snprintf(line, sizeof(line), "%-20s %12s %12s %10zu %12zu\n", subsystem.name.c_str(),
+                      formatBytes(subsystem.counters.liveBytes).c_str(),
+                      formatBytes(subsystem.counters.peakBytes).c_str(), subsystem.counters.liveCount,
+                      subsystem.counters.allocCount);
+        result += line;
+    }
+
+    std::snprintf(line, sizeof(line), "%12s %12s %10s %12s  %s\n", "live", "peak", "live#", "allocs", "callsite");
+    result += line;
+    for(std::size_t i = 0; i < std::min(maxCallsites, callsites.size()); ++i)
+    {
+        const auto& callsite = callsites[i];
+        std::snprintf(line, sizeof(line), "%12s %12s %10zu %12zu  %s:%d [%s] %s\n",
+                      formatBytes(callsite.counters.liveBytes).c_str(),
+                      formatBytes(callsite.counters.peakBytes).c_str(), callsite.counters.liveCount,
+                      callsite.counters.allocCount, callsite.file ? callsite.file : "?", callsite.line,
+                      callsite.subsystem.c_str(), callsite.function ? callsite.function : "?");
+        result += line;
+    }
+    return result;
+}
+
+std::string MemoryTracker::toJson() const
+{
+    MemoryCounters total      = getTotal();
+    auto           subsystems = getSubsystems();
+    auto           callsites  = getCallsites();
+
+    std::string json = "{\n  \"total\": {" + countersToJson(total) + "},\n  \"subsystems\": [";
+    for(std::size_t i = 0; i < subsystems.size(); ++i)
+    {
+        json += (i ? ",\n    {\"name\": \"" : "\n    {\"name\": \"") + escapeJson(subsystems[i].name) + "\", " +
+                countersToJson(subsystems[i].counters) + "}";
+    }
+    json += "\n  ],\n  \"callsites\": [";
+    for(std::size_t i = 0; i < callsites.size(); ++i)
+    {
+        const auto& callsite = callsites[i];
+        json += std::string{i ? ",\n    {" : "\n    {"} + "\"file\": \"" +
+                escapeJson(callsite.file ? callsite.file : "") + "\", \"line\": " + std::to_string(callsite.line) +
+                ", \"function\": \"" + escapeJson(callsite.function ? callsite.function : "") +
+                "\", \"subsystem\": \"" + escapeJson(callsite.subsystem) + "\", " + countersToJson(callsite.counters) +
+                "}";
+    }
+    json += "\n  ]\n}\n";
+    return json;
+}
+
+bool MemoryTracker::writeJson(const std::string& path) const
+{
+    std::ofstream out{path};
+    out << toJson();
+    if(!out)
+    {
+        MM_LOG_ERR("failed to write the memory snapshot to %s", path);
+        return false;
+    }
+    return true;
+}
+
+std::size_t MemoryTracker::reportLeaks() const
+{
+    MemoryCounters total = getTotal();
+    if(total.liveCount)
+    {
+        MM_LOG_WARN("%s", formatLeaks(32));
+    }
+    return total.liveCount;
+}
+
+void MemoryTracker::printLeaksAtExit() const
+{
+    if(m_reportLeaksOnExit && getTotal().liveCount)
+    {
+        std::fputs(formatLeaks(16).c_str(), stderr);
+    }
+}
+
+std::string MemoryTracker::formatLeaks(std::size_t maxCallsites) const
+{
+    MemoryCounters total = getTotal();
+    std::string    result;
+    char           line[1024];
+    std::snprintf(line, sizeof(line), "memory leaks: %zu allocations, %s still live\n", total.liveCount,
+                  formatBytes(total.liveBytes).c_str());
+    result += line;
+
+    std::size_t count = 0;
+    for(const auto& callsite : getCallsites())
+    {
+        if(callsite.counters.liveCount == 0 || count++ == maxCallsites)
+        {
+            break;
+        }
+        std::snprintf(line, sizeof(line), "  %12s in %zu allocations  %s:%d [%s] %s\n",
+                      formatBytes(callsite.counters.liveBytes).c_str(), callsite.counters.liveCount,
+                      callsite.file ? callsite.file : "?", callsite.line, callsite.subsystem.c_str(),
+                      callsite.function ? callsite.function : "?");
+        result += line;
+    }
+    return result;
+}
+}  // namespace aph::memory
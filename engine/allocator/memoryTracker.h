@@ -0,0 +1,150 @@
+#ifndef APH_MEMORY_TRACKER_H_
+#define APH_MEMORY_TRACKER_H_
+
+#include <memory>
+#include <mutex>
+#include "common/hash.h"
+#include "common/smallVector.h"
+
+namespace aph::memory
+{
+struct MemoryCounters
+{
+    std::size_t liveBytes  = 0;
+    std::size_t liveCount  = 0;
+    std::size_t allocCount = 0;
+    std::size_t peakBytes  = 0;
+};
+
+struct MemoryCallsiteStats
+{
+    const char*    file      = {};
+    const char*    function  = {};
+    int            line      = {};
+    std::string    subsystem = {};
+    MemoryCounters counters  = {};
+};
+
+struct MemorySubsystemStats
+{
+    std::string    name     = {};
+    MemoryCounters counters = {};
+};
+
+enum class MemorySortKey
+{
+    LiveBytes,
+    PeakBytes,
+    AllocCount,
+};
+
+// tags allocations made by this thread until the scope ends, the tag must outlive the tracker (e.g. a literal)
+class MemoryTagScope
+{
+public:
+    explicit MemoryTagScope(const char* tag);
+    ~MemoryTagScope();
+
+    MemoryTagScope(const MemoryTagScope&)            = delete;
+    MemoryTagScope& operator=(const MemoryTagScope&) = delete;
+
+    static const char* GetCurrent();
+
+private:
+    const char* m_previous = {};
+};
+
+/*
+ * Callsite level accounting for the aph_* allocation functions.
+ *
+ * Built with APH_MEMORY_TRACKING (cmake -DAPH_ENABLE_MEMORY_TRACKING=ON) every allocation is attributed to the
+ * file/line/function it came from and to a subsystem: the innermost MemoryTagScope on the allocating thread, or the
+ * engine directory of the callsite (engine/renderer/... -> "renderer"). Live bytes, allocation counts and peaks are
+ * kept per callsite, per subsystem and in total, a report or a JSON snapshot can be taken at any time.
+ *
+ * The global tracker is never destroyed, static objects still free their memory through it after main returns. It
+ * reports whatever is live from an atexit handler instead, other trackers report when they are destroyed.
+ * Bookkeeping takes one mutex per allocation, this is a diagnostic mode and not meant for shipping builds.
+ */
+class MemoryTracker
+{
+public:
+    explicit MemoryTracker(bool reportLeaksOnExit = true) : m_reportLeaksOnExit(reportLeaksOnExit) {}
+    ~MemoryTracker();
+
+    MemoryTracker(const MemoryTracker&)            = delete;
+    MemoryTracker& operator=(const MemoryTracker&) = delete;
+
+    // the tracker behind the aph_* functions
+    static MemoryTracker& GetInstance();
+
+    void onAllocate(void* ptr, std::size_t size, const char* file, int line, const char* function);
+    // returns the size of the allocation, 0 if the pointer is unknown
+    std::size_t onFree(void* ptr);
+    // runs reallocFn under the tracker's lock, so no other thread can be handed the old address before its record
+    // moves to the new block, a failed realloc leaves the old record in place
+    void* reallocate(void* ptr, std::size_t size, void* (*reallocFn)(void*, std::size_t), const char* file, int line,
+                     const char* function);
+
+    MemoryCounters                    getTotal() const;
+    SmallVector<MemoryCallsiteStats>  getCallsites(MemorySortKey sortKey = MemorySortKey::LiveBytes) const;
+    SmallVector<MemorySubsystemStats> getSubsystems(MemorySortKey sortKey = MemorySortKey::LiveBytes) const;
+
+    // text table of the top callsites and all subsystems
+    std::string report(MemorySortKey sortKey = MemorySortKey::LiveBytes, std::size_t maxCallsites = 32) const;
+    std::string toJson() const;
+    bool        writeJson(const std::string& path) const;
+
+    // callsites that still own memory, logged as leaks, returns the number of leaked allocations
+    std::size_t reportLeaks() const;
+
+private:
+    struct CallsiteKey
+    {
+        const char* file     = {};
+        const char* function = {};
+        int         line     = {};
+        const char* tag      = {};
+
+        bool operator==(const CallsiteKey&) const = default;
+    };
+
+    struct CallsiteKeyHash
+    {
+        using is_avalanching = void;
+        std::size_t operator()(const CallsiteKey& key) const;
+    };
+
+    struct Callsite
+    {
+        CallsiteKey     key;
+        std::string     subsystem;
+        MemoryCounters  counters;
+        MemoryCounters* pSubsystem = {};
+    };
+
+    struct Allocation
+    {
+        std::size_t size      = {};
+        Callsite*   pCallsite = {};
+    };
+
+    // both expect m_lock to be held
+    void        addRecord(void* ptr, std::size_t size, const char* file, int line, const char* function,
+                          const char* tag);
+    std::size_t removeRecord(void* ptr);
+
+    std::string formatLeaks(std::size_t maxCallsites) const;
+    // writes to stderr, the logger may already be gone at exit
+    void printLeaksAtExit() const;
+
+    mutable std::mutex                                               m_lock;
+    HashMap<CallsiteKey, std::unique_ptr<Callsite>, CallsiteKeyHash> m_callsites;
+    HashMap<std::string, std::unique_ptr<MemoryCounters>>            m_subsystems;
+    HashMap<void*, Allocation>                                       m_allocations;
+    MemoryCounters                                                   m_total;
+    bool                                                             m_reportLeaksOnExit = true;
+};
+}  // namespace aph::memory
+
+#endif  // APH_MEMORY_TRACKER_H_
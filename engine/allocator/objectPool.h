@@ -1,11 +1,22 @@
 #ifndef OBJECTPOOL_H_
 #define OBJECTPOOL_H_
 
+#include <span>
 #include "allocator/allocator.h"
+#include "common/common.h"
 #include "common/smallVector.h"
 
 namespace aph
 {
+enum class PoolDepot
+{
+    Locked,    // free objects in a mutex protected list
+    LockFree,  // Treiber stack of object batches
+};
+
+template <typename T, PoolDepot Depot>
+class ThreadSafeObjectPool;
+
 template <typename T>
 class ObjectPool
 {
@@ -53,34 +64,435 @@ protected:
     };
 
     SmallVector<std::unique_ptr<T, MallocDeleter>> m_memory;
+
+private:
+    // pooled types befriend ObjectPool<T> only, the thread-safe pool constructs through it
+    template <typename U, PoolDepot Depot>
+    friend class ThreadSafeObjectPool;
+
+    template <typename... P>
+    static void Construct(T* ptr, P&&... p)
+    {
+        new(ptr) T(std::forward<P>(p)...);
+    }
+
+    static void Destroy(T* ptr) { ptr->~T(); }
+};
+
+namespace detail
+{
+constexpr uint32_t POOL_MAGAZINE_SIZE       = 32;
+constexpr uint32_t POOL_MAX_THREAD_SLOTS    = 64;
+constexpr uint32_t POOL_INVALID_THREAD_SLOT = ~0u;
+
+// dense index of the calling thread, handed back on thread exit so the next thread inherits its magazines
+class PoolThreadSlots
+{
+public:
+    static uint32_t get()
+    {
+        thread_local Holder holder;
+        return holder.slot;
+    }
+
+private:
+    struct Registry
+    {
+        std::mutex            lock;
+        SmallVector<uint32_t> freeSlots;
+        uint32_t              nextSlot = 0;
+    };
+
+    static Registry& GetRegistry()
+    {
+        static Registry registry;
+        return registry;
+    }
+
+    struct Holder
+    {
+        Holder()
+        {
+            Registry&                   registry = GetRegistry();
+            std::lock_guard<std::mutex> holder{registry.lock};
+            if(!registry.freeSlots.empty())
+            {
+                slot = registry.freeSlots.back();
+                registry.freeSlots.pop_back();
+            }
+            else if(registry.nextSlot < POOL_MAX_THREAD_SLOTS)
+            {
+                slot = registry.nextSlot++;
+            }
+        }
+
+        ~Holder()
+        {
+            if(slot != POOL_INVALID_THREAD_SLOT)
+            {
+                Registry&                   registry = GetRegistry();
+                std::lock_guard<std::mutex> holder{registry.lock};
+                registry.freeSlots.push_back(slot);
+            }
+        }
+
+        uint32_t slot = POOL_INVALID_THREAD_SLOT;
+    };
+};
+
+// link stored in the memory of a free object
+struct PoolFreeNode
+{
+    PoolFreeNode* next      = {};
+    PoolFreeNode* nextBatch = {};
+    uint32_t      count     = {};
 };
 
 template <typename T>
-class ThreadSafeObjectPool : private ObjectPool<T>
+class PoolBlocks
 {
 public:
-    template <typename... P>
-    T* allocate(P&&... p)
+    union Slot
+    {
+        PoolFreeNode node;
+        alignas(T) std::byte storage[sizeof(T)];
+    };
+
+    ~PoolBlocks() { clear(); }
+
+    // allocates the next block, empty if out of memory
+    std::span<Slot> grow()
+    {
+        unsigned num_objects = 64u << m_memory.size();
+        Slot*    ptr =
+            static_cast<Slot*>(memory::aph_memalign(std::max<size_t>(64, alignof(Slot)), num_objects * sizeof(Slot)));
+        if(!ptr)
+            return {};
+        m_memory.push_back(ptr);
+        return {ptr, num_objects};
+    }
+
+    void clear()
+    {
+        for(Slot* ptr : m_memory)
+        {
+            memory::aph_free(ptr);
+        }
+        m_memory.clear();
+    }
+
+    // objects in every block allocated so far, block i holds 64 << i
+    std::size_t capacity() const { return 64 * ((std::size_t{1} << m_memory.size()) - 1); }
+
+private:
+    SmallVector<Slot*> m_memory;
+};
+
+template <typename T>
+class LockedPoolDepot
+{
+public:
+    std::size_t pop(T** ppObjects, std::size_t count)
     {
         std::lock_guard<std::mutex> holder{m_lock};
-        return ObjectPool<T>::allocate(std::forward<P>(p)...);
+        if(m_vacants.empty())
+        {
+            grow();
+        }
+
+        count = std::min(count, m_vacants.size());
+        std::copy(m_vacants.end() - count, m_vacants.end(), ppObjects);
+        m_vacants.resize(m_vacants.size() - count);
+        return count;
     }
 
-    void free(T* ptr)
+    void push(T* const* ppObjects, std::size_t count)
     {
-        // TODO only lock vector push operation
         std::lock_guard<std::mutex> holder{m_lock};
-        ObjectPool<T>::free(ptr);
+        m_vacants.insert(m_vacants.end(), ppObjects, ppObjects + count);
+    }
+
+    void reserve(std::size_t count)
+    {
+        std::lock_guard<std::mutex> holder{m_lock};
+        while(m_blocks.capacity() < count && grow())
+        {
+        }
     }
 
     void clear()
     {
         std::lock_guard<std::mutex> holder{m_lock};
-        ObjectPool<T>::clear();
+        m_vacants.clear();
+        m_blocks.clear();
+    }
+
+    std::size_t capacity() const
+    {
+        std::lock_guard<std::mutex> holder{m_lock};
+        return m_blocks.capacity();
+    }
+
+private:
+    // called with m_lock held, returns false if out of memory
+    bool grow()
+    {
+        auto slots = m_blocks.grow();
+        // room for every object of every block, pushing freed objects back never reallocates
+        m_vacants.reserve(m_blocks.capacity());
+        for(auto& slot : slots)
+        {
+            m_vacants.push_back(reinterpret_cast<T*>(&slot));
+        }
+        return !slots.empty();
+    }
+
+    mutable std::mutex m_lock;
+    SmallVector<T*>    m_vacants;
+    PoolBlocks<T>      m_blocks;
+};
+
+// free objects are chained through their own memory, a batch is pushed and popped with one CAS. the head carries a
+// 16 bit tag in the unused upper pointer bits against ABA, block memory is only released by clear() so a stale read
+// of a batch link is harmless
+template <typename T>
+class LockFreePoolDepot
+{
+public:
+    std::size_t pop(T** ppObjects, std::size_t count)
+    {
+        PoolFreeNode* pBatch = popBatch();
+        if(!pBatch && !(pBatch = grow()))
+        {
+            return 0;
+        }
+
+        uint32_t      total  = pBatch->count;
+        std::size_t   popped = 0;
+        PoolFreeNode* pNode  = pBatch;
+        for(; pNode && popped < count; pNode = pNode->next)
+        {
+            ppObjects[popped++] = reinterpret_cast<T*>(pNode);
+        }
+        if(pNode)
+        {
+            pNode->count = total - popped;
+            pushBatch(pNode);
+        }
+        return popped;
+    }
+
+    void push(T* const* ppObjects, std::size_t count)
+    {
+        APH_ASSERT(count > 0);
+        for(std::size_t i = 0; i < count; ++i)
+        {
+            reinterpret_cast<PoolFreeNode*>(ppObjects[i])->next =
+                i + 1 < count ? reinterpret_cast<PoolFreeNode*>(ppObjects[i + 1]) : nullptr;
+        }
+        auto* pBatch  = reinterpret_cast<PoolFreeNode*>(ppObjects[0]);
+        pBatch->count = count;
+        pushBatch(pBatch);
+    }
+
+    void reserve(std::size_t count)
+    {
+        while(capacity() < count)
+        {
+            PoolFreeNode* pBatch = grow();
+            if(!pBatch)
+            {
+                return;
+            }
+            pushBatch(pBatch);
+        }
+    }
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> holder{m_growLock};
+        m_head.store(0, std::memory_order_relaxed);
+        m_blocks.clear();
+    }
+
+    std::size_t capacity() const
+    {
+        std::lock_guard<std::mutex> holder{m_growLock};
+        return m_blocks.capacity();
     }
 
 private:
-    std::mutex m_lock;
+    static constexpr uint64_t POINTER_MASK = (uint64_t{1} << 48) - 1;
+
+    static PoolFreeNode* toNode(uint64_t head) { return reinterpret_cast<PoolFreeNode*>(head & POINTER_MASK); }
+    static uint64_t      pack(PoolFreeNode* pNode, uint64_t head)
+    {
+        APH_ASSERT((reinterpret_cast<uint64_t>(pNode) & ~POINTER_MASK) == 0);
+        return reinterpret_cast<uint64_t>(pNode) | ((head & ~POINTER_MASK) + (POINTER_MASK + 1));
+    }
+
+    void pushBatch(PoolFreeNode* pBatch)
+    {
+        uint64_t head = m_head.load(std::memory_order_relaxed);
+        do
+        {
+            std::atomic_ref<PoolFreeNode*>{pBatch->nextBatch}.store(toNode(head), std::memory_order_relaxed);
+        } while(!m_head.compare_exchange_weak(head, pack(pBatch, head), std::memory_order_release,
+                                              std::memory_order_relaxed));
+    }
+
+    PoolFreeNode* popBatch()
+    {
+        uint64_t head = m_head.load(std::memory_order_acquire);
+        while(PoolFreeNode* pBatch = toNode(head))
+        {
+            PoolFreeNode* pNext = std::atomic_ref<PoolFreeNode*>{pBatch->nextBatch}.load(std::memory_order_relaxed);
+            if(m_head.compare_exchange_weak(head, pack(pNext, head), std::memory_order_acquire,
+                                            std::memory_order_acquire))
+            {
+                return pBatch;
+            }
+        }
+        return nullptr;
+    }
+
+    // carves a new block into batches, keeps the first one for the caller
+    PoolFreeNode* grow()
+    {
+        std::lock_guard<std::mutex> holder{m_growLock};
+        auto                        slots = m_blocks.grow();
+        PoolFreeNode*               pKept = nullptr;
+        for(std::size_t offset = 0; offset < slots.size(); offset += POOL_MAGAZINE_SIZE)
+        {
+            std::size_t count = std::min<std::size_t>(POOL_MAGAZINE_SIZE, slots.size() - offset);
+            for(std::size_t i = 0; i < count; ++i)
+            {
+                slots[offset + i].node = {.next = i + 1 < count ? &slots[offset + i + 1].node : nullptr};
+            }
+            slots[offset].node.count = count;
+            if(!pKept)
+            {
+                pKept = &slots[offset].node;
+            }
+            else
+            {
+                pushBatch(&slots[offset].node);
+            }
+        }
+        return pKept;
+    }
+
+    std::atomic<uint64_t> m_head = {};
+    mutable std::mutex    m_growLock;
+    PoolBlocks<T>         m_blocks;
+};
+}  // namespace detail
+
+/*
+ * Object pool shared by any number of threads.
+ *
+ * Every thread caches free objects in its own magazine, so allocate and free normally touch no shared state. An empty
+ * magazine takes POOL_MAGAZINE_SIZE objects from the depot at once and a full one hands as many back, the depot is
+ * touched once per that many operations. Objects may be freed on any thread, they just join that thread's magazine.
+ * Magazines belong to a thread slot rather than a thread, a thread reusing the slot inherits the cached objects;
+ * threads beyond POOL_MAX_THREAD_SLOTS go straight to the depot.
+ *
+ * The depot is a locked free list, PoolDepot::LockFree swaps it for a Treiber stack. clear() must not run concurrently
+ * with allocate or free.
+ */
+template <typename T, PoolDepot Depot = PoolDepot::Locked>
+class ThreadSafeObjectPool
+{
+public:
+    template <typename... P>
+    T* allocate(P&&... p)
+    {
+        T* ptr = nullptr;
+        if(Magazine* pMagazine = getMagazine())
+        {
+            if(pMagazine->count == 0)
+            {
+                pMagazine->count = m_depot.pop(pMagazine->objects.data(), detail::POOL_MAGAZINE_SIZE);
+                if(pMagazine->count == 0)
+                    return nullptr;
+            }
+            ptr = pMagazine->objects[--pMagazine->count];
+        }
+        else if(!m_depot.pop(&ptr, 1))
+        {
+            return nullptr;
+        }
+
+        ObjectPool<T>::Construct(ptr, std::forward<P>(p)...);
+        return ptr;
+    }
+
+    void free(T* ptr)
+    {
+        ObjectPool<T>::Destroy(ptr);
+        if(Magazine* pMagazine = getMagazine())
+        {
+            if(pMagazine->count == pMagazine->objects.size())
+            {
+                pMagazine->count -= detail::POOL_MAGAZINE_SIZE;
+                m_depot.push(pMagazine->objects.data() + pMagazine->count, detail::POOL_MAGAZINE_SIZE);
+            }
+            pMagazine->objects[pMagazine->count++] = ptr;
+        }
+        else
+        {
+            m_depot.push(&ptr, 1);
+        }
+    }
+
+    void clear()
+    {
+        for(auto& pMagazine : m_magazines)
+        {
+            pMagazine.reset();
+        }
+        m_depot.clear();
+    }
+
+    // creates the calling thread's magazine ahead of time, so its first allocate or free does not hit the heap
+    void prepareThread() { getMagazine(); }
+
+    // carves out at least count objects ahead of time. Up to 2 * POOL_MAGAZINE_SIZE objects can sit in the magazine
+    // of each thread, a pool reserving that much per thread on top of what is live at once never grows.
+    void reserve(std::size_t count) { m_depot.reserve(count); }
+
+    // objects carved out of the backing memory so far, live or cached in a magazine or the depot. A pool whose
+    // objects are all handed back stops growing once it is warm.
+    std::size_t getCapacity() const { return m_depot.capacity(); }
+
+private:
+    struct Magazine
+    {
+        std::array<T*, 2 * detail::POOL_MAGAZINE_SIZE> objects;
+        uint32_t                                       count;
+    };
+
+    Magazine* getMagazine()
+    {
+        uint32_t slot = detail::PoolThreadSlots::get();
+        if(slot == detail::POOL_INVALID_THREAD_SLOT)
+        {
+            return nullptr;
+        }
+        // only the thread holding the slot touches it
+        auto& pMagazine = m_magazines[slot];
+        if(!pMagazine)
+        {
+            pMagazine = std::make_unique<Magazine>();
+        }
+        return pMagazine.get();
+    }
+
+    using DepotType = std::conditional_t<Depot == PoolDepot::LockFree, detail::LockFreePoolDepot<T>,
+                                         detail::LockedPoolDepot<T>>;
+
+    std::array<std::unique_ptr<Magazine>, detail::POOL_MAX_THREAD_SLOTS> m_magazines;
+    DepotType                                                           m_depot;
 };
 }  // namespace aph
 
@@ -0,0 +1,205 @@
+#ifndef APH_SLOT_MAP_H_
+#define APH_SLOT_MAP_H_
+
+#include <span>
+#include <tuple>
+#include "common/common.h"
+
+namespace aph
+{
+// 32 bit generational id, small enough to live in GPU visible tables
+template <typename T>
+class Handle
+{
+public:
+    static constexpr uint32_t INDEX_BITS      = 20;
+    static constexpr uint32_t GENERATION_BITS = 32 - INDEX_BITS;
+    static constexpr uint32_t MAX_INDEX       = (1u << INDEX_BITS) - 1;
+    static constexpr uint32_t MAX_GENERATION  = (1u << GENERATION_BITS) - 1;
+
+    constexpr Handle() = default;
+    constexpr Handle(uint32_t index, uint32_t generation) : m_value((generation << INDEX_BITS) | index)
+    {
+        APH_ASSERT(index <= MAX_INDEX && generation <= MAX_GENERATION);
+    }
+
+    static constexpr Handle FromRaw(uint32_t value)
+    {
+        Handle handle;
+        handle.m_value = value;
+        return handle;
+    }
+
+    constexpr uint32_t getIndex() const { return m_value & MAX_INDEX; }
+    constexpr uint32_t getGeneration() const { return m_value >> INDEX_BITS; }
+    constexpr uint32_t getRaw() const { return m_value; }
+
+    // live slots never have generation 0, a default constructed handle is always null
+    constexpr bool isNull() const { return getGeneration() == 0; }
+    constexpr explicit operator bool() const { return !isNull(); }
+
+    constexpr bool operator==(const Handle&) const = default;
+
+private:
+    uint32_t m_value = 0;
+};
+
+/*
+ * Generational slot map.
+ *
+ * Every field type is stored in its own dense array (SoA), so a pass over e.g. only the hot field touches only that
+ * array. A handle resolves through a sparse slot table to the dense position without hashing, erasing swaps the last
+ * element into the hole. Each slot carries a generation that is bumped on erase: a handle to an erased element no
+ * longer matches and every lookup with it fails instead of aliasing whatever reuses the slot. A slot whose
+ * generation reaches MAX_GENERATION is retired instead of wrapping, so an old handle can never match again; a heavily
+ * churned map grows by one slot every MAX_GENERATION erases of the same slot.
+ *
+ * Dense positions and field pointers are only stable until the next insert/erase. Not thread safe.
+ */
+template <typename Tag, typename... Fields>
+class SlotMap
+{
+    static_assert(sizeof...(Fields) > 0, "slot map needs at least one field");
+
+public:
+    using HandleType = Handle<Tag>;
+
+    template <std::size_t I>
+    using FieldType = std::tuple_element_t<I, std::tuple<Fields...>>;
+
+    template <typename... Args>
+    HandleType insert(Args&&... fields)
+    {
+        static_assert(sizeof...(Args) == sizeof...(Fields));
+
+        uint32_t index = m_freeHead;
+        if(index == INVALID_INDEX)
+        {
+            APH_ASSERT(m_slots.size() <= HandleType::MAX_INDEX);
+            index = static_cast<uint32_t>(m_slots.size());
+            m_slots.push_back({});
+        }
+        else
+        {
+            m_freeHead = m_slots[index].denseIndex;
+        }
+
+        Slot& slot      = m_slots[index];
+        slot.denseIndex = static_cast<uint32_t>(m_denseToSlot.size());
+        m_denseToSlot.push_back(index);
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            (std::get<I>(m_fields).emplace_back(std::forward<Args>(fields)), ...);
+        }(std::index_sequence_for<Fields...>{});
+
+        return {index, slot.generation};
+    }
+
+    bool erase(HandleType handle)
+    {
+        if(!contains(handle))
+        {
+            return false;
+        }
+
+        Slot&    slot      = m_slots[handle.getIndex()];
+        uint32_t hole      = slot.denseIndex;
+        uint32_t lastDense = static_cast<uint32_t>(m_denseToSlot.size() - 1);
+        if(hole != lastDense)
+        {
+            std::apply([&](auto&... field) { ((field[hole] = std::move(field[lastDense])), ...); }, m_fields);
+            m_denseToSlot[hole]                     = m_denseToSlot[lastDense];
+            m_slots[m_denseToSlot[hole]].denseIndex = hole;
+        }
+        std::apply([](auto&... field) { (field.pop_back(), ...); }, m_fields);
+        m_denseToSlot.pop_back();
+
+        if(slot.generation == HandleType::MAX_GENERATION)
+        {
+            // generation 0 matches no handle, the slot is never handed out again
+            slot.generation = 0;
+            slot.denseIndex = INVALID_INDEX;
+            return true;
+        }
+
+        slot.generation++;
+        slot.denseIndex = m_freeHead;
+        m_freeHead      = handle.getIndex();
+        return true;
+    }
+
+    bool contains(HandleType handle) const
+    {
+        return !handle.isNull() && handle.getIndex() < m_slots.size() &&
+               m_slots[handle.getIndex()].generation == handle.getGeneration();
+    }
+
+    // nullptr for a null or stale handle
+    template <std::size_t I = 0>
+    FieldType<I>* get(HandleType handle)
+    {
+        return contains(handle) ? &std::get<I>(m_fields)[m_slots[handle.getIndex()].denseIndex] : nullptr;
+    }
+
+    template <std::size_t I = 0>
+    const FieldType<I>* get(HandleType handle) const
+    {
+        return contains(handle) ? &std::get<I>(m_fields)[m_slots[handle.getIndex()].denseIndex] : nullptr;
+    }
+
+    // the densely packed field of every live element, in the same order as getHandle()
+    template <std::size_t I = 0>
+    std::span<FieldType<I>> getDense()
+    {
+        return std::get<I>(m_fields);
+    }
+
+    template <std::size_t I = 0>
+    std::span<const FieldType<I>> getDense() const
+    {
+        return std::get<I>(m_fields);
+    }
+
+    HandleType getHandle(uint32_t denseIndex) const
+    {
+        APH_ASSERT(denseIndex < m_denseToSlot.size());
+        uint32_t index = m_denseToSlot[denseIndex];
+        return {index, m_slots[index].generation};
+    }
+
+    uint32_t size() const { return static_cast<uint32_t>(m_denseToSlot.size()); }
+    bool     empty() const { return m_denseToSlot.empty(); }
+
+    void reserve(uint32_t count)
+    {
+        m_slots.reserve(count);
+        m_denseToSlot.reserve(count);
+        std::apply([count](auto&... field) { (field.reserve(count), ...); }, m_fields);
+    }
+
+    // invalidates every outstanding handle
+    void clear()
+    {
+        while(!empty())
+        {
+            erase(getHandle(size() - 1));
+        }
+    }
+
+private:
+    static constexpr uint32_t INVALID_INDEX = ~0u;
+
+    struct Slot
+    {
+        // dense position while live, next free slot while vacant
+        uint32_t denseIndex = INVALID_INDEX;
+        uint32_t generation = 1;
+    };
+
+    std::vector<Slot>                  m_slots;
+    std::vector<uint32_t>              m_denseToSlot;
+    std::tuple<std::vector<Fields>...> m_fields;
+    uint32_t                           m_freeHead = INVALID_INDEX;
+};
+}  // namespace aph
+
+#endif  // APH_SLOT_MAP_H_
@@ -4,11 +4,13 @@
 #include <volk.h>
 #include "api/gpuResource.h"
 #include "allocator/objectPool.h"
+#include "allocator/slotMap.h"
 
 namespace aph::vk
 {
 class Device;
 class Buffer;
+class DeviceAllocation;
 
 struct BufferCreateInfo
 {
@@ -22,15 +24,18 @@ class Buffer : public ResourceHandle<VkBuffer, BufferCreateInfo>
 {
     friend class ObjectPool<Buffer>;
     friend class CommandBuffer;
+    friend class Device;
 
 public:
-    uint32_t      getSize() const { return m_createInfo.size; }
-    uint32_t      getOffset() const { return m_createInfo.alignment; }
-    ResourceState getResourceState() const { return m_resourceState; }
+    uint32_t                 getSize() const { return m_createInfo.size; }
+    uint32_t                 getOffset() const { return m_createInfo.alignment; }
+    ResourceState            getResourceState() const { return m_resourceState; }
+    Handle<DeviceAllocation> getAllocation() const { return m_allocation; }
 
 private:
     Buffer(const CreateInfoType& createInfo, HandleType handle);
-    ResourceState m_resourceState = ResourceState::Undefined;
+    ResourceState            m_resourceState = ResourceState::Undefined;
+    Handle<DeviceAllocation> m_allocation    = {};
 };
 }  // namespace aph::vk
 
@@ -416,8 +416,8 @@ void CommandBuffer::endDebugLabel()
     vkCmdEndDebugUtilsLabelEXT(getHandle());
 #endif
 }
-void CommandBuffer::insertBarrier(const std::vector<BufferBarrier>& pBufferBarriers,
-                                  const std::vector<ImageBarrier>&  pImageBarriers)
+void CommandBuffer::insertBarrier(std::span<const BufferBarrier> pBufferBarriers,
+                                  std::span<const ImageBarrier>  pImageBarriers)
 {
     uint32_t numTextureBarriers = pImageBarriers.size();
     uint32_t numBufferBarriers  = pBufferBarriers.size();
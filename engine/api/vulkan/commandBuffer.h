@@ -1,6 +1,7 @@
 #ifndef COMMANDBUFFER_H_
 #define COMMANDBUFFER_H_
 
+#include <span>
 #include "api/vulkan/descriptorSet.h"
 #include "api/vulkan/shader.h"
 #include "vkUtils.h"
@@ -176,10 +177,12 @@ public:
     void writeTimeStamp(VkPipelineStageFlagBits stage, VkQueryPool pool, uint32_t queryIndex);
 
 public:
+    // the vector overloads take braced lists, per-frame callers can pass a std::array instead
     void insertBarrier(const std::vector<ImageBarrier>& pImageBarriers) { insertBarrier({}, pImageBarriers); }
     void insertBarrier(const std::vector<BufferBarrier>& pBufferBarriers) { insertBarrier(pBufferBarriers, {}); }
-    void insertBarrier(const std::vector<BufferBarrier>& pBufferBarriers,
-                       const std::vector<ImageBarrier>&  pImageBarriers);
+    void insertBarrier(std::span<const ImageBarrier> pImageBarriers) { insertBarrier({}, pImageBarriers); }
+    void insertBarrier(std::span<const BufferBarrier> pBufferBarriers,
+                       std::span<const ImageBarrier>  pImageBarriers);
     void transitionImageLayout(Image* pImage, ResourceState newState);
 
 public:
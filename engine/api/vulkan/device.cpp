@@ -530,7 +530,7 @@ Result Device::create(const BufferCreateInfo& createInfo, Buffer** ppBuffer, std
     m_table.vkCreateBuffer(getHandle(), &bufferInfo, vkAllocator(), &buffer);
     _VR(utils::setDebugObjectName(getHandle(), VK_OBJECT_TYPE_BUFFER, reinterpret_cast<uint64_t>(buffer), debugName))
     *ppBuffer = m_resourcePool.buffer.allocate(createInfo, buffer);
-    m_resourcePool.gpu->allocate(*ppBuffer);
+    (*ppBuffer)->m_allocation = m_resourcePool.gpu->allocate(*ppBuffer);
 
     return Result::Success;
 }
@@ -560,7 +560,7 @@ Result Device::create(const ImageCreateInfo& createInfo, Image** ppImage, std::s
     m_table.vkCreateImage(getHandle(), &imageCreateInfo, vkAllocator(), &image);
     _VR(utils::setDebugObjectName(getHandle(), VK_OBJECT_TYPE_IMAGE, reinterpret_cast<uint64_t>(image), debugName))
     *ppImage = m_resourcePool.image.allocate(this, createInfo, image);
-    m_resourcePool.gpu->allocate(*ppImage);
+    (*ppImage)->m_allocation = m_resourcePool.gpu->allocate(*ppImage);
 
     return Result::Success;
 }
@@ -934,9 +934,9 @@ Result Device::releaseCommandPool(CommandPool* pPool)
     delete pPool;
     return Result::Success;
 }
-void Device::executeSingleCommands(Queue* queue, const CmdRecordCallBack&& func,
-                                   const std::vector<Semaphore*>& waitSems, const std::vector<Semaphore*>& signalSems,
-                                   Fence* pFence)
+void Device::executeSingleCommands(Queue* queue, const CmdRecordCallBack&& func, std::span<Semaphore* const> waitSems,
+                                   std::span<Semaphore* const> signalSems, Fence* pFence,
+                                   std::pmr::memory_resource* pScratch)
 {
     APH_PROFILER_SCOPE();
 
@@ -948,16 +948,20 @@ void Device::executeSingleCommands(Queue* queue, const CmdRecordCallBack&& func,
     func(cmd);
     _VR(cmd->end());
 
-    QueueSubmitInfo submitInfo{.commandBuffers = {cmd}, .waitSemaphores = waitSems, .signalSemaphores = signalSems};
+    QueueSubmitInfo submitInfo{
+        .commandBuffers   = {{cmd}, pScratch},
+        .waitSemaphores   = {waitSems.begin(), waitSems.end(), pScratch},
+        .signalSemaphores = {signalSems.begin(), signalSems.end(), pScratch},
+    };
     if(!pFence)
     {
         auto fence = acquireFence(false);
-        APH_VR(queue->submit({submitInfo}, fence));
+        APH_VR(queue->submit({&submitInfo, 1}, fence, pScratch));
         fence->wait();
     }
     else
     {
-        APH_VR(queue->submit({submitInfo}, pFence));
+        APH_VR(queue->submit({&submitInfo, 1}, pFence, pScratch));
         // TODO async with caller
         pFence->wait();
     }
@@ -67,9 +67,10 @@ public:
     Result       releaseCommandPool(CommandPool* pPool);
 
     using CmdRecordCallBack = std::function<void(CommandBuffer* pCmdBuffer)>;
-    void executeSingleCommands(Queue* queue, const CmdRecordCallBack&& func,
-                               const std::vector<Semaphore*>& waitSems   = {},
-                               const std::vector<Semaphore*>& signalSems = {}, Fence* pFence = nullptr);
+    // pScratch backs the submit info, e.g. the frame arena's resource when called every frame
+    void executeSingleCommands(Queue* queue, const CmdRecordCallBack&& func, std::span<Semaphore* const> waitSems = {},
+                               std::span<Semaphore* const> signalSems = {}, Fence* pFence = nullptr,
+                               std::pmr::memory_resource* pScratch = std::pmr::get_default_resource());
 
 public:
     Result flushMemory(VkDeviceMemory memory, MemoryRange range = {});
@@ -65,14 +65,14 @@ VMADeviceAllocator::VMADeviceAllocator(Instance* pInstance, Device* pDevice)
 
 VMADeviceAllocator::~VMADeviceAllocator()
 {
-    vmaDestroyAllocator(m_allocator);
     clear();
+    vmaDestroyAllocator(m_allocator);
 }
 
-DeviceAllocation* VMADeviceAllocator::allocate(Buffer* pBuffer)
+DeviceAllocationHandle VMADeviceAllocator::allocate(Buffer* pBuffer)
 {
     std::lock_guard<std::mutex> lock{m_allocationLock};
-    APH_ASSERT(!m_bufferMemoryMap.contains(pBuffer));
+    APH_ASSERT(!m_allocations.contains(pBuffer->getAllocation()));
 
     const auto& bufferCI = pBuffer->getCreateInfo();
 
@@ -87,13 +87,12 @@ DeviceAllocation* VMADeviceAllocator::allocate(Buffer* pBuffer)
     VmaAllocation           allocation;
     vmaAllocateMemoryForBuffer(m_allocator, pBuffer->getHandle(), &allocCreateInfo, &allocation, &allocInfo);
     vmaBindBufferMemory(m_allocator, allocation, pBuffer->getHandle());
-    m_bufferMemoryMap[pBuffer]    = std::make_unique<VMADeviceAllocation>(allocation, allocInfo);
-    return m_bufferMemoryMap[pBuffer].get();
+    return m_allocations.insert(allocation, allocInfo);
 }
-DeviceAllocation* VMADeviceAllocator::allocate(Image* pImage)
+DeviceAllocationHandle VMADeviceAllocator::allocate(Image* pImage)
 {
     std::lock_guard<std::mutex> lock{m_allocationLock};
-    APH_ASSERT(!m_imageMemoryMap.contains(pImage));
+    APH_ASSERT(!m_allocations.contains(pImage->getAllocation()));
 
     const auto& bufferCI = pImage->getCreateInfo();
 
@@ -108,56 +107,71 @@ DeviceAllocation* VMADeviceAllocator::allocate(Image* pImage)
     VmaAllocation           allocation;
     vmaAllocateMemoryForImage(m_allocator, pImage->getHandle(), &allocCreateInfo, &allocation, &allocInfo);
     vmaBindImageMemory(m_allocator, allocation, pImage->getHandle());
-    m_imageMemoryMap[pImage]      = std::make_unique<VMADeviceAllocation>(allocation, allocInfo);
-    return m_imageMemoryMap[pImage].get();
+    return m_allocations.insert(allocation, allocInfo);
 }
 void VMADeviceAllocator::free(Image* pImage)
 {
     std::lock_guard<std::mutex> lock{m_allocationLock};
-    APH_ASSERT(m_imageMemoryMap.contains(pImage));
-    vmaFreeMemory(m_allocator, m_imageMemoryMap[pImage]->getHandle());
-    m_imageMemoryMap.erase(pImage);
+    free(pImage->getAllocation());
 }
 void VMADeviceAllocator::free(Buffer* pBuffer)
 {
     std::lock_guard<std::mutex> lock{m_allocationLock};
-    APH_ASSERT(m_bufferMemoryMap.contains(pBuffer));
-    vmaFreeMemory(m_allocator, m_bufferMemoryMap[pBuffer]->getHandle());
-    m_bufferMemoryMap.erase(pBuffer);
+    free(pBuffer->getAllocation());
 }
 Result VMADeviceAllocator::map(Buffer* pBuffer, void** ppData)
 {
     std::lock_guard<std::mutex> lock{m_allocationLock};
-    APH_ASSERT(m_bufferMemoryMap.contains(pBuffer));
-    return utils::getResult(vmaMapMemory(m_allocator, m_bufferMemoryMap[pBuffer]->getHandle(), ppData));
+    return utils::getResult(vmaMapMemory(m_allocator, getAllocation(pBuffer->getAllocation()), ppData));
 }
 Result VMADeviceAllocator::map(Image* pImage, void** ppData)
 {
     std::lock_guard<std::mutex> lock{m_allocationLock};
-    APH_ASSERT(m_imageMemoryMap.contains(pImage));
-    return utils::getResult(vmaMapMemory(m_allocator, m_imageMemoryMap[pImage]->getHandle(), ppData));
+    return utils::getResult(vmaMapMemory(m_allocator, getAllocation(pImage->getAllocation()), ppData));
 }
 void VMADeviceAllocator::unMap(Buffer* pBuffer)
 {
     std::lock_guard<std::mutex> lock{m_allocationLock};
-    APH_ASSERT(m_bufferMemoryMap.contains(pBuffer));
-    vmaUnmapMemory(m_allocator, m_bufferMemoryMap[pBuffer]->getHandle());
+    vmaUnmapMemory(m_allocator, getAllocation(pBuffer->getAllocation()));
 }
 void VMADeviceAllocator::unMap(Image* pImage)
 {
     std::lock_guard<std::mutex> lock{m_allocationLock};
-    APH_ASSERT(m_imageMemoryMap.contains(pImage));
-    vmaUnmapMemory(m_allocator, m_imageMemoryMap[pImage]->getHandle());
+    vmaUnmapMemory(m_allocator, getAllocation(pImage->getAllocation()));
+}
+DeviceAllocationInfo VMADeviceAllocator::getInfo(DeviceAllocationHandle allocation)
+{
+    std::lock_guard<std::mutex> lock{m_allocationLock};
+    const VmaAllocationInfo*    pInfo = m_allocations.get<1>(allocation);
+    APH_ASSERT(pInfo);
+    return pInfo ? DeviceAllocationInfo{pInfo->offset, pInfo->size} : DeviceAllocationInfo{};
 }
 void VMADeviceAllocator::clear()
 {
-    for(auto& [image, allocation] : m_imageMemoryMap)
+    std::lock_guard<std::mutex> lock{m_allocationLock};
+    for(VmaAllocation allocation : m_allocations.getDense())
+    {
+        vmaFreeMemory(m_allocator, allocation);
+    }
+    m_allocations.clear();
+}
+VmaAllocation VMADeviceAllocator::getAllocation(DeviceAllocationHandle allocation)
+{
+    VmaAllocation* pAllocation = m_allocations.get(allocation);
+    if(!pAllocation)
     {
-        free(image);
+        VK_LOG_ERR("stale device allocation handle %#x.", allocation.getRaw());
+        APH_ASSERT(false);
+        return nullptr;
     }
-    for(auto& [buffer, allocation] : m_bufferMemoryMap)
+    return *pAllocation;
+}
+void VMADeviceAllocator::free(DeviceAllocationHandle allocation)
+{
+    if(VmaAllocation vmaAllocation = getAllocation(allocation))
     {
-        free(buffer);
+        vmaFreeMemory(m_allocator, vmaAllocation);
+        m_allocations.erase(allocation);
     }
 }
 }  // namespace aph::vk
@@ -2,6 +2,7 @@
 #define APH_VK_ALLOCATOR_H_
 
 #include "device.h"
+#include "allocator/slotMap.h"
 
 #define VMA_STATIC_VULKAN_FUNCTIONS 0
 #define VMA_DYNAMIC_VULKAN_FUNCTIONS 0
@@ -14,13 +15,14 @@ class Buffer;
 class Image;
 class Device;
 
-class DeviceAllocation
-{
-public:
-    virtual ~DeviceAllocation() = default;
+// tag type of the handles device allocators give out
+class DeviceAllocation;
+using DeviceAllocationHandle = Handle<DeviceAllocation>;
 
-    virtual std::size_t getOffset() = 0;
-    virtual std::size_t getSize()   = 0;
+struct DeviceAllocationInfo
+{
+    std::size_t offset = {};
+    std::size_t size   = {};
 };
 
 class DeviceAllocator
@@ -28,37 +30,16 @@ class DeviceAllocator
 public:
     virtual ~DeviceAllocator() = default;
 
-    virtual Result            map(Buffer* pBuffer, void** ppData) = 0;
-    virtual Result            map(Image* pImage, void** ppData)   = 0;
-    virtual void              unMap(Buffer* pBuffer)              = 0;
-    virtual void              unMap(Image* pImage)                = 0;
-    virtual DeviceAllocation* allocate(Buffer* pBuffer)           = 0;
-    virtual DeviceAllocation* allocate(Image* pImage)             = 0;
-    virtual void              free(Image* pImage)                 = 0;
-    virtual void              free(Buffer* pBuffer)               = 0;
-    virtual void              clear()                             = 0;
-};
-
-class VMADeviceAllocation final : public DeviceAllocation
-{
-public:
-    VMADeviceAllocation(VmaAllocation allocation, const VmaAllocationInfo& allocationInfo) :
-        m_allocation(allocation),
-        m_allocationInfo(allocationInfo)
-    {
-    }
-    ~VMADeviceAllocation() override = default;
-
-    std::size_t getOffset() override { return m_allocationInfo.offset; }
-    std::size_t getSize() override { return m_allocationInfo.size; }
-
-public:
-    VmaAllocation            getHandle() const { return m_allocation; }
-    const VmaAllocationInfo& getInfo() const { return m_allocationInfo; }
-
-private:
-    VmaAllocation     m_allocation;
-    VmaAllocationInfo m_allocationInfo;
+    virtual Result                 map(Buffer* pBuffer, void** ppData)        = 0;
+    virtual Result                 map(Image* pImage, void** ppData)          = 0;
+    virtual void                   unMap(Buffer* pBuffer)                     = 0;
+    virtual void                   unMap(Image* pImage)                       = 0;
+    virtual DeviceAllocationHandle allocate(Buffer* pBuffer)                  = 0;
+    virtual DeviceAllocationHandle allocate(Image* pImage)                    = 0;
+    virtual void                   free(Image* pImage)                        = 0;
+    virtual void                   free(Buffer* pBuffer)                      = 0;
+    virtual DeviceAllocationInfo   getInfo(DeviceAllocationHandle allocation) = 0;
+    virtual void                   clear()                                    = 0;
 };
 
 class VMADeviceAllocator final : public DeviceAllocator
@@ -67,8 +48,8 @@ public:
     VMADeviceAllocator(Instance* pInstance, Device* pDevice);
     ~VMADeviceAllocator() override;
 
-    DeviceAllocation* allocate(Buffer* pBuffer) override;
-    DeviceAllocation* allocate(Image* pImage) override;
+    DeviceAllocationHandle allocate(Buffer* pBuffer) override;
+    DeviceAllocationHandle allocate(Image* pImage) override;
 
     void free(Image* pImage) override;
     void free(Buffer* pBuffer) override;
@@ -79,13 +60,19 @@ public:
     void unMap(Buffer* pBuffer) override;
     void unMap(Image* pImage) override;
 
+    DeviceAllocationInfo getInfo(DeviceAllocationHandle allocation) override;
+
     void clear() override;
 
 private:
+    // asserts on a stale handle, e.g. a resource freed twice
+    VmaAllocation getAllocation(DeviceAllocationHandle allocation);
+    void          free(DeviceAllocationHandle allocation);
+
     VmaAllocator m_allocator;
 
-    HashMap<Buffer*, std::unique_ptr<VMADeviceAllocation>> m_bufferMemoryMap;
-    HashMap<Image*, std::unique_ptr<VMADeviceAllocation>>  m_imageMemoryMap;
+    // the VmaAllocation is all map/unmap/free need, the info is only read on request
+    SlotMap<DeviceAllocation, VmaAllocation, VmaAllocationInfo> m_allocations;
 
     std::mutex m_allocationLock;
 };
@@ -13,10 +13,7 @@ Image::Image(Device* pDevice, const CreateInfoType& createInfo, HandleType handl
 
 Image::~Image()
 {
-    for(auto& [_, imageView] : m_imageViewFormatMap)
-    {
-        m_pDevice->destroy(imageView);
-    }
+    m_imageViewFormatMap.forEach([this](Format, ImageView* pImageView) { m_pDevice->destroy(pImageView); });
 }
 
 ImageView* Image::getView(Format imageFormat)
@@ -26,9 +23,7 @@ ImageView* Image::getView(Format imageFormat)
         imageFormat = m_createInfo.format;
     }
 
-    std::lock_guard<std::mutex> holder{m_acquireViewLock};
-    if(!m_imageViewFormatMap.contains(imageFormat))
-    {
+    return m_imageViewFormatMap.getOrCreate(imageFormat, [&]() {
         static const HashMap<VkImageType, VkImageViewType> imageTypeMap{
             {VK_IMAGE_TYPE_1D, VK_IMAGE_VIEW_TYPE_1D},
             {VK_IMAGE_TYPE_2D, VK_IMAGE_VIEW_TYPE_2D},
@@ -49,10 +44,10 @@ ImageView* Image::getView(Format imageFormat)
         {
             createInfo.viewType = VK_IMAGE_VIEW_TYPE_CUBE;
         }
-        APH_VR(m_pDevice->create(createInfo, &m_imageViewFormatMap[imageFormat]));
-    }
-
-    return m_imageViewFormatMap[imageFormat];
+        ImageView* pImageView = {};
+        APH_VR(m_pDevice->create(createInfo, &pImageView));
+        return pImageView;
+    });
 }
 
 ImageView::ImageView(const CreateInfoType& createInfo, HandleType handle) :
@@ -3,12 +3,15 @@
 
 #include <volk.h>
 #include "api/gpuResource.h"
+#include "common/concurrentHashMap.h"
 #include "common/hash.h"
 #include "allocator/objectPool.h"
+#include "allocator/slotMap.h"
 namespace aph::vk
 {
 class Device;
 class ImageView;
+class DeviceAllocation;
 
 struct ImageCreateInfo
 {
@@ -31,27 +34,33 @@ class Image : public ResourceHandle<VkImage, ImageCreateInfo>
 {
     friend class CommandBuffer;
     friend class ObjectPool<Image>;
+    friend class Device;
 
 public:
     ImageView* getView(Format imageFormat = Format::Undefined);
 
-    uint32_t      getWidth() const { return m_createInfo.extent.width; }
-    uint32_t      getHeight() const { return m_createInfo.extent.height; }
-    uint32_t      getDepth() const { return m_createInfo.extent.depth; }
-    uint32_t      getMipLevels() const { return m_createInfo.mipLevels; }
-    uint32_t      getLayerCount() const { return m_createInfo.arraySize; }
-    Format        getFormat() const { return m_createInfo.format; }
-    ResourceState getResourceState() const { return m_resourceState; }
+    uint32_t                 getWidth() const { return m_createInfo.extent.width; }
+    uint32_t                 getHeight() const { return m_createInfo.extent.height; }
+    uint32_t                 getDepth() const { return m_createInfo.extent.depth; }
+    uint32_t                 getMipLevels() const { return m_createInfo.mipLevels; }
+    uint32_t                 getLayerCount() const { return m_createInfo.arraySize; }
+    Format                   getFormat() const { return m_createInfo.format; }
+    ResourceState            getResourceState() const { return m_resourceState; }
+    Handle<DeviceAllocation> getAllocation() const { return m_allocation; }
 
 private:
     Image(Device* pDevice, const CreateInfoType& createInfo, HandleType handle);
     ~Image();
 
-    Device*                     m_pDevice            = {};
-    HashMap<Format, ImageView*> m_imageViewFormatMap = {};
-    VkImageLayout               m_layout             = {VK_IMAGE_LAYOUT_UNDEFINED};
-    ResourceState               m_resourceState      = {};
-    std::mutex                  m_acquireViewLock;
+    // a handful of views per image, one shard is enough, lookups from several threads only share the read lock
+    using ImageViewMap = ConcurrentHashMap<Format, ImageView*, ::ankerl::unordered_dense::hash<Format>,
+                                           std::equal_to<Format>, 1>;
+
+    Device*                  m_pDevice       = {};
+    ImageViewMap             m_imageViewFormatMap;
+    VkImageLayout            m_layout        = {VK_IMAGE_LAYOUT_UNDEFINED};
+    ResourceState            m_resourceState = {};
+    Handle<DeviceAllocation> m_allocation    = {};
 };
 
 struct ImageViewCreateInfo
@@ -30,7 +30,6 @@ void PipelineAllocator::setupPipelineKey(const VkPipelineBinaryKeyKHR& pipelineK
     VkDevice    device     = m_pDevice->getHandle();
     auto        vkPipeline = pPipeline->getHandle();
 
-    m_pipelineMap[pipelineKey] = pPipeline;
     VkPipelineBinaryCreateInfoKHR pipelineBinaryCreateInfo{
         .sType               = VK_STRUCTURE_TYPE_PIPELINE_BINARY_CREATE_INFO_KHR,
         .pNext               = NULL,
@@ -77,11 +76,11 @@ void PipelineAllocator::setupPipelineKey(const VkPipelineBinaryKeyKHR& pipelineK
         binaryData.resize(binaryDataSize);
 
         _VR(table->vkGetPipelineBinaryDataKHR(device, &binaryInfo, &binaryKeys[i], &binaryDataSize, binaryData.data()));
-        m_binaryKeyDataMap[binaryKeys[i]].rawData = std::move(binaryData);
-        m_binaryKeyDataMap[binaryKeys[i]].binary  = pipelineBinaries[i];
+        m_binaryKeyDataMap.insertOrAssign(binaryKeys[i],
+                                          {.rawData = std::move(binaryData), .binary = pipelineBinaries[i]});
     }
 
-    m_pipelineKeyBinaryKeysMap[pipelineKey] = binaryKeys;
+    m_pipelineKeyBinaryKeysMap.insertOrAssign(pipelineKey, std::move(binaryKeys));
     VkReleaseCapturedPipelineDataInfoKHR releaseInfo{
         .sType    = VK_STRUCTURE_TYPE_RELEASE_CAPTURED_PIPELINE_DATA_INFO_KHR,
         .pNext    = nullptr,
@@ -111,17 +110,14 @@ Pipeline* PipelineAllocator::getPipeline(const ComputePipelineCreateInfo& create
     VkPipelineBinaryKeyKHR pipelineKey{.sType = VK_STRUCTURE_TYPE_PIPELINE_BINARY_KEY_KHR};
     table->vkGetPipelineKeyKHR(device, &pipelineCreateInfo, &pipelineKey);
 
-    std::lock_guard<std::mutex> holder{m_computeAcquireLock};
-    if(!m_pipelineKeyBinaryKeysMap.contains(pipelineKey))
-    {
+    return m_pipelineMap.getOrCreate(pipelineKey, [&]() {
         VkPipeline computePipeline = VK_NULL_HANDLE;
         _VR(m_pDevice->getDeviceTable()->vkCreateComputePipelines(m_pDevice->getHandle(), VK_NULL_HANDLE, 1,
                                                                   &vkCreateInfo, vkAllocator(), &computePipeline));
         Pipeline* pPipeline = m_pool.allocate(m_pDevice, createInfo, computePipeline);
         setupPipelineKey(pipelineKey, pPipeline);
-    }
-
-    return m_pipelineMap.at(pipelineKey);
+        return pPipeline;
+    });
 }
 
 Pipeline* PipelineAllocator::getPipeline(const GraphicsPipelineCreateInfo& createInfo)
@@ -141,31 +137,29 @@ Pipeline* PipelineAllocator::getPipeline(const GraphicsPipelineCreateInfo& creat
     VkPipelineBinaryKeyKHR pipelineKey{.sType = VK_STRUCTURE_TYPE_PIPELINE_BINARY_KEY_KHR};
     table->vkGetPipelineKeyKHR(device, &pipelineCreateInfo, &pipelineKey);
 
-    std::lock_guard<std::mutex> holder{m_graphicsAcquireLock};
-    if(!m_pipelineKeyBinaryKeysMap.contains(pipelineKey))
-    {
+    return m_pipelineMap.getOrCreate(pipelineKey, [&]() {
         // Create the pipeline
         VkPipeline graphicsPipeline;
         table->vkCreateGraphicsPipelines(device, NULL, 1, &graphicsCreateInfo, vkAllocator(), &graphicsPipeline);
         Pipeline* pipeline = m_pool.allocate(m_pDevice, createInfo, graphicsPipeline);
         setupPipelineKey(pipelineKey, pipeline);
-    }
-
-    return m_pipelineMap.at(pipelineKey);
+        return pipeline;
+    });
 }
 
 void PipelineAllocator::clear()
 {
     auto& table  = *m_pDevice->getDeviceTable();
     auto  device = m_pDevice->getHandle();
-    for(auto& [_, pPipeline] : m_pipelineMap)
-    {
+    m_pipelineMap.forEach([&](const auto&, Pipeline* pPipeline) {
         table.vkDestroyPipeline(device, pPipeline->getHandle(), vkAllocator());
-    }
+    });
+    m_pipelineMap.clear();
     m_pool.clear();
-    for(auto& [key, binaryData] : m_binaryKeyDataMap)
-    {
+    m_binaryKeyDataMap.forEach([&](const auto&, const PipelineBinaryData& binaryData) {
         table.vkDestroyPipelineBinaryKHR(device, binaryData.binary, vkAllocator());
-    }
+    });
+    m_binaryKeyDataMap.clear();
+    m_pipelineKeyBinaryKeysMap.clear();
 }
 }  // namespace aph::vk
@@ -3,6 +3,7 @@
 
 #include "api/gpuResource.h"
 #include "allocator/objectPool.h"
+#include "common/concurrentHashMap.h"
 #include "common/hash.h"
 #include "volk.h"
 
@@ -78,8 +79,6 @@ public:
 private:
     Device*                        m_pDevice = {};
     ThreadSafeObjectPool<Pipeline> m_pool;
-    std::mutex                     m_graphicsAcquireLock;
-    std::mutex                     m_computeAcquireLock;
 
 private:
     struct PipelineBinaryKeyHash
@@ -114,8 +113,9 @@ private:
         VkPipelineBinaryKHR binary;
     };
 
+    // pipelines are requested from recording threads, the maps are sharded instead of behind one lock
     template<typename Key, typename Val>
-    using PipelineKeyMap = HashMap<Key, Val, PipelineBinaryKeyHash, PipelineBinaryKeyEqual>;
+    using PipelineKeyMap = ConcurrentHashMap<Key, Val, PipelineBinaryKeyHash, PipelineBinaryKeyEqual>;
 
     PipelineKeyMap<VkPipelineBinaryKeyKHR, PipelineBinaryData> m_binaryKeyDataMap;
     PipelineKeyMap<VkPipelineBinaryKeyKHR, std::vector<VkPipelineBinaryKeyKHR>> m_pipelineKeyBinaryKeysMap;
@@ -31,18 +31,40 @@ Queue::Queue(Device* pDevice, HandleType handle, uint32_t queueFamilyIndex, uint
     }
 }
 
-Result Queue::submit(const std::vector<QueueSubmitInfo>& submitInfos, Fence* pFence)
+Result Queue::submit(std::span<const QueueSubmitInfo> submitInfos, Fence* pFence, std::pmr::memory_resource* pScratch)
 {
-    std::vector<VkSubmitInfo>         vkSubmits;
-    std::vector<VkCommandBuffer>      vkCmds;
-    std::vector<VkPipelineStageFlags> vkWaitStages;
-    std::vector<VkSemaphore>          vkWaitSemaphores;
-    std::vector<VkSemaphore>          vkSignalSemaphores;
+    std::pmr::vector<VkSubmitInfo>         vkSubmits{pScratch};
+    std::pmr::vector<VkCommandBuffer>      vkCmds{pScratch};
+    std::pmr::vector<VkPipelineStageFlags> vkWaitStages{pScratch};
+    std::pmr::vector<VkSemaphore>          vkWaitSemaphores{pScratch};
+    std::pmr::vector<VkSemaphore>          vkSignalSemaphores{pScratch};
 
+    // size everything up front, the submit infos point into these arrays and a scratch arena cannot reuse grown-out
+    // storage anyway
+    std::size_t cmdCount = 0, waitCount = 0, signalCount = 0, defaultStageCount = 0;
     for(const auto& submitInfo : submitInfos)
     {
-        uint32_t cmdOffset = {static_cast<uint32_t>(vkCmds.size())};
-        uint32_t cmdSize   = {static_cast<uint32_t>(submitInfo.commandBuffers.size())};
+        cmdCount += submitInfo.commandBuffers.size();
+        waitCount += submitInfo.waitSemaphores.size();
+        signalCount += submitInfo.signalSemaphores.size();
+        if(submitInfo.waitStages.empty())
+        {
+            defaultStageCount = std::max(defaultStageCount, submitInfo.waitSemaphores.size());
+        }
+    }
+    vkSubmits.reserve(submitInfos.size());
+    vkCmds.reserve(cmdCount);
+    vkWaitSemaphores.reserve(waitCount);
+    vkSignalSemaphores.reserve(signalCount);
+    // shared by every submit that does not name its wait stages
+    vkWaitStages.resize(defaultStageCount, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+
+    for(const auto& submitInfo : submitInfos)
+    {
+        uint32_t cmdOffset    = {static_cast<uint32_t>(vkCmds.size())};
+        uint32_t cmdSize      = {static_cast<uint32_t>(submitInfo.commandBuffers.size())};
+        uint32_t waitOffset   = {static_cast<uint32_t>(vkWaitSemaphores.size())};
+        uint32_t signalOffset = {static_cast<uint32_t>(vkSignalSemaphores.size())};
 
         for(auto* cmd : submitInfo.commandBuffers)
         {
@@ -62,20 +84,16 @@ Result Queue::submit(const std::vector<QueueSubmitInfo>& submitInfos, Fence* pFe
         VkSubmitInfo info{
             .sType                = VK_STRUCTURE_TYPE_SUBMIT_INFO,
             .waitSemaphoreCount   = static_cast<uint32_t>(submitInfo.waitSemaphores.size()),
-            .pWaitSemaphores      = vkWaitSemaphores.data(),
+            .pWaitSemaphores      = vkWaitSemaphores.data() + waitOffset,
             .pWaitDstStageMask    = submitInfo.waitStages.data(),
             .commandBufferCount   = cmdSize,
             .pCommandBuffers      = &vkCmds[cmdOffset],
             .signalSemaphoreCount = static_cast<uint32_t>(submitInfo.signalSemaphores.size()),
-            .pSignalSemaphores    = vkSignalSemaphores.data(),
+            .pSignalSemaphores    = vkSignalSemaphores.data() + signalOffset,
         };
 
         if(submitInfo.waitStages.empty())
         {
-            if(vkWaitStages.empty())
-            {
-                vkWaitStages.resize(submitInfo.waitSemaphores.size(), VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
-            }
             info.pWaitDstStageMask = vkWaitStages.data();
         }
         vkSubmits.push_back(info);
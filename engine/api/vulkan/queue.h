@@ -1,6 +1,8 @@
 #ifndef QUEUE_H_
 #define QUEUE_H_
 
+#include <memory_resource>
+#include <span>
 #include "vkUtils.h"
 
 namespace aph::vk
@@ -10,12 +12,13 @@ class CommandBuffer;
 class Semaphore;
 class Fence;
 
+// the arrays take a memory resource, a per-frame submit can build them in the frame arena
 struct QueueSubmitInfo
 {
-    std::vector<CommandBuffer*>       commandBuffers;
-    std::vector<VkPipelineStageFlags> waitStages;
-    std::vector<Semaphore*>           waitSemaphores;
-    std::vector<Semaphore*>           signalSemaphores;
+    std::pmr::vector<CommandBuffer*>       commandBuffers;
+    std::pmr::vector<VkPipelineStageFlags> waitStages;
+    std::pmr::vector<Semaphore*>           waitSemaphores;
+    std::pmr::vector<Semaphore*>           signalSemaphores;
 };
 
 class Queue : public ResourceHandle<VkQueue>
@@ -29,7 +32,9 @@ public:
     VkQueueFlags getFlags() const { return m_properties.queueFlags; }
     QueueType    getType() const { return m_type; }
     Result       waitIdle();
-    Result       submit(const std::vector<QueueSubmitInfo>& submitInfos, Fence* pFence = nullptr);
+    // pScratch backs the temporary Vk structures, e.g. the frame arena's resource on the per-frame path
+    Result       submit(std::span<const QueueSubmitInfo> submitInfos, Fence* pFence = nullptr,
+                        std::pmr::memory_resource* pScratch = std::pmr::get_default_resource());
     Result       present(const VkPresentInfoKHR& presentInfo);
 
 private:
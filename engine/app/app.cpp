@@ -2,6 +2,7 @@
 #include "common/logger.h"
 #include "cli/cli.h"
 #include "filesystem/filesystem.h"
+#include "threads/taskManager.h"
 
 #define TOML_EXCEPTIONS 0
 #include "toml++/toml.hpp"
@@ -36,7 +37,10 @@ void BaseApp::loadConfig(int argc, char** argv, std::string configPath)
             opt.protocols[std::string{k.data()}] = v.value_or("");
         }
 
-        opt.numThreads = table.at_path("thread.num_override").value_or(0U);
+        opt.numThreads     = table.at_path("thread.num_override").value_or(0U);
+        opt.pinWorkers     = table.at_path("thread.pin_workers").value_or(false);
+        opt.idleSpinCount  = table.at_path("thread.idle_spin_count").value_or(-1);
+        opt.idleYieldCount = table.at_path("thread.idle_yield_count").value_or(8U);
         opt.logLevel = table.at_path("log.level").value_or(1U);
     }
 
@@ -63,5 +67,22 @@ void BaseApp::loadConfig(int argc, char** argv, std::string configPath)
     {
         aph::Logger::GetInstance().setLogLevel(m_options.logLevel);
     }
+
+    // setup the engine-wide task manager before any subsystem uses it
+    {
+        auto& taskManager = aph::TaskManager::GetInstance(m_options.numThreads, m_options.pinWorkers);
+
+        aph::thread::IdlePolicy idlePolicy;
+        if(m_options.idleSpinCount < 0)
+        {
+            idlePolicy = aph::thread::calibrateIdlePolicy();
+        }
+        else
+        {
+            idlePolicy.spinCount = m_options.idleSpinCount;
+        }
+        idlePolicy.yieldCount = m_options.idleYieldCount;
+        taskManager.setIdlePolicy(idlePolicy);
+    }
 };
 }  // namespace aph
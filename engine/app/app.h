@@ -30,7 +30,10 @@ public:
         aph::HashMap<std::string, std::string> protocols;
 
         // thread
-        uint32_t numThreads = 0;
+        uint32_t numThreads     = 0;
+        bool     pinWorkers     = false;
+        int32_t  idleSpinCount  = -1;
+        uint32_t idleYieldCount = 8;
 
         // log
         uint32_t logLevel = 0;
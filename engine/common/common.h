@@ -20,6 +20,9 @@ namespace aph
     #define APH_ALWAYS_INLINE inline
 #endif
 
+// Assumed size of a cache line, used to keep data written by different threads apart.
+constexpr std::size_t CACHE_LINE_SIZE = 64;
+
 APH_ALWAYS_INLINE bool Assert(bool cond, const char* file, int line, const char* format, ...)
 {
     if(!cond)
@@ -0,0 +1,202 @@
+#ifndef APH_CONCURRENT_HASH_MAP_H_
+#define APH_CONCURRENT_HASH_MAP_H_
+
+#include <array>
+#include <bit>
+#include <future>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include "common/common.h"
+#include "common/hash.h"
+
+namespace aph
+{
+/*
+ * Hash map for caches that are read and filled from several threads, e.g. shaders compiled by loader workers.
+ *
+ * Keys are spread over ShardCount independent HashMaps, each behind its own reader/writer lock, so lookups only
+ * contend with writers of the same shard. Values are handed out as copies, the map is meant for pointers and small
+ * handles, not for objects that are modified in place.
+ *
+ * getOrCreate() runs the factory once per key: the first caller creates the value outside of any lock, callers that
+ * ask for the same key meanwhile wait for that result instead of creating their own, other keys of the shard are not
+ * blocked by the factory.
+ */
+template <class Key, class T, class Hash = ::ankerl::unordered_dense::hash<Key>, class KeyEqual = std::equal_to<Key>,
+          std::size_t ShardCount = 16>
+class ConcurrentHashMap
+{
+    static_assert(std::has_single_bit(ShardCount), "shard count must be a power of two");
+
+public:
+    using key_type    = Key;
+    using mapped_type = T;
+
+    ConcurrentHashMap() = default;
+
+    ConcurrentHashMap(const ConcurrentHashMap&)            = delete;
+    ConcurrentHashMap& operator=(const ConcurrentHashMap&) = delete;
+
+    std::optional<T> find(const Key& key) const
+    {
+        const Shard&     shard = getShard(key);
+        std::shared_lock holder{shard.lock};
+        auto             it = shard.map.find(key);
+        if(it == shard.map.end())
+        {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
+    bool contains(const Key& key) const
+    {
+        const Shard&     shard = getShard(key);
+        std::shared_lock holder{shard.lock};
+        return shard.map.contains(key);
+    }
+
+    // false if the key is already present, the stored value is kept
+    bool insert(const Key& key, T value)
+    {
+        Shard&           shard = getShard(key);
+        std::unique_lock holder{shard.lock};
+        return shard.map.try_emplace(key, std::move(value)).second;
+    }
+
+    void insertOrAssign(const Key& key, T value)
+    {
+        Shard&           shard = getShard(key);
+        std::unique_lock holder{shard.lock};
+        shard.map.insert_or_assign(key, std::move(value));
+    }
+
+    bool erase(const Key& key)
+    {
+        Shard&           shard = getShard(key);
+        std::unique_lock holder{shard.lock};
+        return shard.map.erase(key) > 0;
+    }
+
+    template <typename Factory>
+        requires std::is_invocable_r_v<T, Factory>
+    T getOrCreate(const Key& key, Factory&& factory)
+    {
+        Shard& shard = getShard(key);
+        {
+            std::shared_lock holder{shard.lock};
+            if(auto it = shard.map.find(key); it != shard.map.end())
+            {
+                return it->second;
+            }
+        }
+
+        std::promise<T> promise;
+        {
+            std::unique_lock holder{shard.lock};
+            if(auto it = shard.map.find(key); it != shard.map.end())
+            {
+                return it->second;
+            }
+            if(auto it = shard.pending.find(key); it != shard.pending.end())
+            {
+                auto future = it->second;
+                holder.unlock();
+                return future.get();
+            }
+            shard.pending.emplace(key, promise.get_future().share());
+        }
+
+        try
+        {
+            T value = std::forward<Factory>(factory)();
+            {
+                std::unique_lock holder{shard.lock};
+                shard.map.try_emplace(key, value);
+                shard.pending.erase(key);
+            }
+            promise.set_value(value);
+            return value;
+        }
+        catch(...)
+        {
+            // nothing is cached, the next caller tries again
+            {
+                std::unique_lock holder{shard.lock};
+                shard.pending.erase(key);
+            }
+            promise.set_exception(std::current_exception());
+            throw;
+        }
+    }
+
+    // visits every entry with the shard read-locked, func must not call back into the map
+    template <typename Func>
+    void forEach(Func&& func) const
+    {
+        for(const Shard& shard : m_shards)
+        {
+            std::shared_lock holder{shard.lock};
+            for(const auto& [key, value] : shard.map)
+            {
+                func(key, value);
+            }
+        }
+    }
+
+    void clear()
+    {
+        for(Shard& shard : m_shards)
+        {
+            std::unique_lock holder{shard.lock};
+            shard.map.clear();
+        }
+    }
+
+    std::size_t size() const
+    {
+        std::size_t count = 0;
+        for(const Shard& shard : m_shards)
+        {
+            std::shared_lock holder{shard.lock};
+            count += shard.map.size();
+        }
+        return count;
+    }
+
+    bool empty() const { return size() == 0; }
+
+private:
+    struct alignas(CACHE_LINE_SIZE) Shard
+    {
+        mutable std::shared_mutex                           lock;
+        HashMap<Key, T, Hash, KeyEqual>                     map;
+        HashMap<Key, std::shared_future<T>, Hash, KeyEqual> pending;
+    };
+
+    // the shard maps use the high bits of the hash for their buckets, pick the shard from a remixed hash so keys of
+    // one shard still spread over all of its buckets
+    std::size_t getShardIndex(const Key& key) const
+    {
+        constexpr uint32_t SHARD_BITS = std::countr_zero(ShardCount);
+        if constexpr(SHARD_BITS == 0)
+        {
+            return 0;
+        }
+        else
+        {
+            uint64_t hash = static_cast<uint64_t>(m_hash(key));
+            return static_cast<std::size_t>((hash * 0x9e3779b97f4a7c15ull) >> (64 - SHARD_BITS));
+        }
+    }
+
+    Shard&       getShard(const Key& key) { return m_shards[getShardIndex(key)]; }
+    const Shard& getShard(const Key& key) const { return m_shards[getShardIndex(key)]; }
+
+    [[no_unique_address]] Hash    m_hash;
+    std::array<Shard, ShardCount> m_shards;
+};
+}  // namespace aph
+
+#endif  // APH_CONCURRENT_HASH_MAP_H_
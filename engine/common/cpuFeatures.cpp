@@ -0,0 +1,93 @@
+#include "cpuFeatures.h"
+#include <algorithm>
+#include <cstdlib>
+#include <string_view>
+#include "common/logger.h"
+
+namespace
+{
+constexpr aph::simd::Level LEVELS[] = {aph::simd::Level::Scalar, aph::simd::Level::SSE42, aph::simd::Level::AVX2,
+                                       aph::simd::Level::AVX512};
+
+aph::simd::Level detectLevel()
+{
+    using aph::simd::Level;
+#if defined(APH_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+    // libgcc checks the XCR0 bits as well, AVX state the OS does not save is reported as unsupported
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+       __builtin_cpu_supports("avx512vl") && __builtin_cpu_supports("avx512vbmi"))
+    {
+        return Level::AVX512;
+    }
+    if(__builtin_cpu_supports("avx2"))
+    {
+        return Level::AVX2;
+    }
+    if(__builtin_cpu_supports("sse4.2"))
+    {
+        return Level::SSE42;
+    }
+#endif
+    return Level::Scalar;
+}
+
+aph::simd::Level parseLevel(std::string_view name, aph::simd::Level fallback)
+{
+    using aph::simd::Level;
+    for(Level level : LEVELS)
+    {
+        if(name == aph::simd::toString(level))
+        {
+            return level;
+        }
+    }
+    CM_LOG_WARN("unknown APH_SIMD_LEVEL \"%s\", expected scalar, sse4.2, avx2 or avx512.", std::string{name});
+    return fallback;
+}
+}  // namespace
+
+namespace aph::simd
+{
+Level getSupportedLevel()
+{
+    static const Level level = detectLevel();
+    return level;
+}
+
+std::span<const Level> getSupportedLevels()
+{
+    return std::span{LEVELS}.first(static_cast<std::size_t>(getSupportedLevel()) + 1);
+}
+
+Level getLevel()
+{
+    static const Level level = []() {
+        Level supported = getSupportedLevel();
+        Level capped    = supported;
+        if(const char* env = std::getenv("APH_SIMD_LEVEL"))
+        {
+            capped = std::min(parseLevel(env, supported), supported);
+        }
+        CM_LOG_DEBUG("simd level: %s, supported: %s", toString(capped), toString(supported));
+        return capped;
+    }();
+    return level;
+}
+
+const char* toString(Level level)
+{
+    switch(level)
+    {
+    case Level::Scalar:
+        return "scalar";
+    case Level::SSE42:
+        return "sse4.2";
+    case Level::AVX2:
+        return "avx2";
+    case Level::AVX512:
+        return "avx512";
+    }
+    return "unknown";
+}
+}  // namespace aph::simd
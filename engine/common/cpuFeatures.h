@@ -0,0 +1,49 @@
+#ifndef APH_CPU_FEATURES_H_
+#define APH_CPU_FEATURES_H_
+
+#include <cstdint>
+#include <span>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+    #define APH_SIMD_X86
+#endif
+
+// compiles one function for an instruction set the rest of the target is not built for, only call it after checking
+// simd::getLevel()
+#if defined(APH_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+    #define APH_TARGET(isa) __attribute__((target(isa)))
+#else
+    #define APH_TARGET(isa)
+#endif
+
+namespace aph::simd
+{
+/*
+ * Instruction set levels that SIMD kernels provide variants for, a level includes everything below it.
+ *
+ * The engine is built for the baseline of the architecture, kernels compile their wider variants with APH_TARGET and
+ * pick one at runtime, usually once into a function table. Binaries run on any x86-64 machine and still use AVX-512
+ * where it exists.
+ */
+enum class Level : uint8_t
+{
+    Scalar,
+    SSE42,   // SSE4.2, includes SSSE3 and SSE4.1
+    AVX2,    // AVX2
+    AVX512,  // AVX-512 F, BW, VL and VBMI, Ice Lake and Zen 4 onwards
+};
+
+// highest level the cpu and the operating system support, detected once
+Level getSupportedLevel();
+
+// every level up to and including the supported one, lowest first, for tests and benchmarks that cover each variant
+std::span<const Level> getSupportedLevels();
+
+// level kernels should dispatch to: the supported level, capped by the APH_SIMD_LEVEL environment variable
+// (scalar, sse4.2, avx2 or avx512) so the narrower variants can be exercised on newer machines
+Level getLevel();
+
+const char* toString(Level level);
+}  // namespace aph::simd
+
+#endif  // APH_CPU_FEATURES_H_
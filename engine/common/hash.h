@@ -1,6 +1,8 @@
 #ifndef APH_HASH_H_
 #define APH_HASH_H_
 
+#include <memory_resource>
+#include <string_view>
 #include "ankerl/unordered_dense.h"
 
 namespace aph
@@ -15,6 +17,32 @@ template <class Key, class Hash = ::ankerl::unordered_dense::hash<Key>, class Ke
           class AllocatorOrContainer = std::allocator<Key>,
           class Bucket               = ::ankerl::unordered_dense::bucket_type::standard>
 using HashSet = ::ankerl::unordered_dense::set<Key, Hash, KeyEqual, AllocatorOrContainer, Bucket>;
+
+// transparent hash for std::string keys, find() and contains() also take a std::string_view or a literal without
+// building a temporary std::string
+struct StringHash
+{
+    using is_transparent = void;
+    using is_avalanching = void;
+
+    uint64_t operator()(std::string_view str) const noexcept
+    {
+        return ::ankerl::unordered_dense::hash<std::string_view>{}(str);
+    }
+};
+
+template <class T>
+using StringMap = HashMap<std::string, T, StringHash, std::equal_to<>>;
+
+// containers backed by a std::pmr::memory_resource, e.g. a FrameArena for per-frame temporaries
+namespace pmr
+{
+template <class Key, class T, class Hash = ::ankerl::unordered_dense::hash<Key>, class KeyEqual = std::equal_to<Key>>
+using HashMap = ::aph::HashMap<Key, T, Hash, KeyEqual, std::pmr::polymorphic_allocator<std::pair<Key, T>>>;
+
+template <class Key, class Hash = ::ankerl::unordered_dense::hash<Key>, class KeyEqual = std::equal_to<Key>>
+using HashSet = ::aph::HashSet<Key, Hash, KeyEqual, std::pmr::polymorphic_allocator<Key>>;
+}  // namespace pmr
 #else
 template <class Key, class Hash>
 using HashMap = std::unordered_map<Key, Hash>;
@@ -0,0 +1,142 @@
+#ifndef APH_INPLACE_FUNCTION_H_
+#define APH_INPLACE_FUNCTION_H_
+
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace aph
+{
+template <typename Signature, std::size_t Capacity = 64>
+class InplaceFunction;
+
+/*
+ * Move-only std::function replacement which stores the callable in a fixed-size inline buffer and never allocates.
+ * Callables larger than the buffer are rejected at compile time.
+ */
+template <typename R, typename... Args, std::size_t Capacity>
+class InplaceFunction<R(Args...), Capacity>
+{
+    template <typename F>
+    static constexpr bool isCompatible = !std::is_same_v<std::remove_cvref_t<F>, InplaceFunction> &&
+                                         std::is_invocable_r_v<R, std::decay_t<F>&, Args...>;
+
+public:
+    InplaceFunction() noexcept = default;
+    InplaceFunction(std::nullptr_t) noexcept {}
+
+    template <typename F>
+        requires isCompatible<F>
+    InplaceFunction(F&& func)
+    {
+        emplace(std::forward<F>(func));
+    }
+
+    InplaceFunction(InplaceFunction&& other) noexcept { moveFrom(other); }
+
+    InplaceFunction& operator=(InplaceFunction&& other) noexcept
+    {
+        if(this != &other)
+        {
+            reset();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    InplaceFunction& operator=(std::nullptr_t) noexcept
+    {
+        reset();
+        return *this;
+    }
+
+    template <typename F>
+        requires isCompatible<F>
+    InplaceFunction& operator=(F&& func)
+    {
+        reset();
+        emplace(std::forward<F>(func));
+        return *this;
+    }
+
+    InplaceFunction(const InplaceFunction&)            = delete;
+    InplaceFunction& operator=(const InplaceFunction&) = delete;
+
+    ~InplaceFunction() { reset(); }
+
+    R operator()(Args... args) const
+    {
+        assert(m_pVTable && "Calling an empty InplaceFunction.");
+        return m_pVTable->invoke(const_cast<std::byte*>(m_storage), std::forward<Args>(args)...);
+    }
+
+    explicit operator bool() const noexcept { return m_pVTable != nullptr; }
+
+    void reset() noexcept
+    {
+        if(m_pVTable)
+        {
+            m_pVTable->destroy(m_storage);
+            m_pVTable = nullptr;
+        }
+    }
+
+private:
+    struct VTable
+    {
+        R (*invoke)(void* storage, Args&&... args);
+        void (*move)(void* dst, void* src) noexcept;
+        void (*destroy)(void* storage) noexcept;
+    };
+
+    template <typename Fn>
+    static constexpr VTable s_vtable = {
+        [](void* storage, Args&&... args) -> R {
+            // like std::function, a void signature discards whatever the callable returns
+            if constexpr(std::is_void_v<R>)
+            {
+                std::invoke(*static_cast<Fn*>(storage), std::forward<Args>(args)...);
+            }
+            else
+            {
+                return std::invoke(*static_cast<Fn*>(storage), std::forward<Args>(args)...);
+            }
+        },
+        [](void* dst, void* src) noexcept {
+            new(dst) Fn(std::move(*static_cast<Fn*>(src)));
+            static_cast<Fn*>(src)->~Fn();
+        },
+        [](void* storage) noexcept { static_cast<Fn*>(storage)->~Fn(); },
+    };
+
+    template <typename F>
+    void emplace(F&& func)
+    {
+        using Fn = std::decay_t<F>;
+        static_assert(sizeof(Fn) <= Capacity, "The callable does not fit into the InplaceFunction storage.");
+        static_assert(alignof(Fn) <= alignof(std::max_align_t), "The callable is over-aligned.");
+        static_assert(std::is_nothrow_move_constructible_v<Fn>, "The callable must be nothrow move constructible.");
+
+        new(m_storage) Fn(std::forward<F>(func));
+        m_pVTable = &s_vtable<Fn>;
+    }
+
+    void moveFrom(InplaceFunction& other) noexcept
+    {
+        if(other.m_pVTable)
+        {
+            other.m_pVTable->move(m_storage, other.m_storage);
+            m_pVTable       = other.m_pVTable;
+            other.m_pVTable = nullptr;
+        }
+    }
+
+    alignas(std::max_align_t) std::byte m_storage[Capacity];
+    const VTable* m_pVTable = nullptr;
+};
+}  // namespace aph
+
+#endif  // APH_INPLACE_FUNCTION_H_
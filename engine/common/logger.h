@@ -27,6 +27,8 @@ public:
 
     void setLogLevel(uint32_t level);
     void setLogLevel(Level level) { m_logLevel = level; }
+    Level getLogLevel() const { return m_logLevel; }
+    bool isEnabled(Level level) const { return m_logLevel <= level; }
     void setEnableTime(bool value) { m_enableTime = value; }
 
     template <LogSinkConcept Sink>
@@ -122,6 +124,24 @@ private:
     std::vector<SinkEntry> m_sinks;
 };
 
+// sets the log level until the end of the scope, the previous level is restored even if the scope is left by an
+// exception
+class ScopedLogLevel
+{
+public:
+    explicit ScopedLogLevel(Logger::Level level) : m_previous(Logger::GetInstance().getLogLevel())
+    {
+        Logger::GetInstance().setLogLevel(level);
+    }
+    ~ScopedLogLevel() { Logger::GetInstance().setLogLevel(m_previous); }
+
+    ScopedLogLevel(const ScopedLogLevel&)            = delete;
+    ScopedLogLevel& operator=(const ScopedLogLevel&) = delete;
+
+private:
+    Logger::Level m_previous;
+};
+
 }  // namespace aph
 
     inline void LOG_FLUSH()
@@ -133,24 +153,32 @@ private:
     template <typename... Args>                                                          \
     void TAG##_LOG_DEBUG(std::string_view fmt, Args&&... args)                           \
     {                                                                                    \
+        if(!::aph::Logger::GetInstance().isEnabled(::aph::Logger::Level::Debug))         \
+            return;                                                                      \
         std::string combined = std::string("[") + #TAG + "] " + std::string(fmt);        \
         ::aph::Logger::GetInstance().debug(combined, std::forward<Args>(args)...);       \
     }                                                                                    \
     template <typename... Args>                                                          \
     void TAG##_LOG_WARN(std::string_view fmt, Args&&... args)                            \
     {                                                                                    \
+        if(!::aph::Logger::GetInstance().isEnabled(::aph::Logger::Level::Warn))          \
+            return;                                                                      \
         std::string combined = std::string("[") + #TAG + "] " + std::string(fmt);        \
         ::aph::Logger::GetInstance().warn(combined, std::forward<Args>(args)...);        \
     }                                                                                    \
     template <typename... Args>                                                          \
     void TAG##_LOG_INFO(std::string_view fmt, Args&&... args)                            \
     {                                                                                    \
+        if(!::aph::Logger::GetInstance().isEnabled(::aph::Logger::Level::Info))          \
+            return;                                                                      \
         std::string combined = std::string("[") + #TAG + "] " + std::string(fmt);        \
         ::aph::Logger::GetInstance().info(combined, std::forward<Args>(args)...);        \
     }                                                                                    \
     template <typename... Args>                                                          \
     void TAG##_LOG_ERR(std::string_view fmt, Args&&... args)                             \
     {                                                                                    \
+        if(!::aph::Logger::GetInstance().isEnabled(::aph::Logger::Level::Error))         \
+            return;                                                                      \
         std::string combined = std::string("[") + #TAG + "] " + std::string(fmt);        \
         ::aph::Logger::GetInstance().error(combined, std::forward<Args>(args)...);       \
         ::aph::Logger::GetInstance().flush();                                            \
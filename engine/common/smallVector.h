@@ -1,126 +1,401 @@
 #ifndef APH_SMALL_VEC_H_
 #define APH_SMALL_VEC_H_
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
 #include <memory>
+#include <stdexcept>
 #include <type_traits>
-#include <vector>
 
 namespace aph
 {
+// types whose objects can be moved to another address with a plain memcpy, the source is not destroyed afterwards.
+// specialize for types that hold no pointers into themselves but are not trivially copyable
+template <typename T>
+struct IsTriviallyRelocatable : std::bool_constant<std::is_trivially_copyable_v<T>>
+{
+};
 
-template <typename T, size_t MaxSize = 8, typename NonReboundT = T>
-struct SmallBufferVectorAllocator
+/*
+ * Vector with storage for N elements inline.
+ *
+ * The header is a data pointer and 32 bit size/capacity, the first N elements live in the object itself and only
+ * growing past N touches the heap. Growth of trivially relocatable types is a memcpy, moving a vector that is on the
+ * heap steals the buffer, moving an inline one relocates at most N elements.
+ *
+ * Iterators are plain pointers and are invalidated by anything that may reallocate, as with std::vector.
+ */
+template <typename T, std::size_t N = 8>
+class SmallVector
 {
-    alignas(alignof(T)) std::byte m_smallBuffer[MaxSize * sizeof(T)];
-    std::allocator<T> m_alloc{};
-    bool              m_smallBufferUsed = false;
+    static_assert(N > 0, "use std::vector for vectors without inline storage");
 
-    using value_type = T;
-    // we have to set this three values, as they are responsible for the correct handling of the move assignment
-    // operator
-    using propagate_on_container_move_assignment = std::false_type;
-    using propagate_on_container_swap            = std::false_type;
-    using is_always_equal                        = std::false_type;
+public:
+    using value_type             = T;
+    using size_type              = std::size_t;
+    using difference_type        = std::ptrdiff_t;
+    using reference              = T&;
+    using const_reference        = const T&;
+    using pointer                = T*;
+    using const_pointer          = const T*;
+    using iterator               = T*;
+    using const_iterator         = const T*;
+    using reverse_iterator       = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
-    constexpr SmallBufferVectorAllocator() noexcept = default;
-    template <class U>
-    constexpr SmallBufferVectorAllocator(const SmallBufferVectorAllocator<U, MaxSize, NonReboundT>&) noexcept
+    SmallVector() noexcept = default;
+    explicit SmallVector(size_type count) { resize(count); }
+    SmallVector(size_type count, const T& value) { resize(count, value); }
+    template <std::input_iterator InputIt>
+    SmallVector(InputIt first, InputIt last)
+    {
+        append(first, last);
+    }
+    SmallVector(std::initializer_list<T> init) { append(init.begin(), init.end()); }
+    SmallVector(const SmallVector& other) { append(other.begin(), other.end()); }
+    SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) { takeFrom(other); }
+    ~SmallVector()
     {
+        std::destroy_n(m_pData, m_size);
+        releaseHeap();
     }
 
-    template <class U>
-    struct rebind
+    SmallVector& operator=(const SmallVector& other)
     {
-        typedef SmallBufferVectorAllocator<U, MaxSize, NonReboundT> other;
-    };
-    // don't copy the small buffer for the copy/move constructors, as the copying is done through the vector
-    constexpr SmallBufferVectorAllocator(const SmallBufferVectorAllocator& other) noexcept :
-        m_smallBufferUsed(other.m_smallBufferUsed)
+        if(this != &other)
+        {
+            assign(other.begin(), other.end());
+        }
+        return *this;
+    }
+    SmallVector& operator=(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
     {
+        if(this != &other)
+        {
+            clear();
+            releaseHeap();
+            takeFrom(other);
+        }
+        return *this;
     }
-    constexpr SmallBufferVectorAllocator& operator=(const SmallBufferVectorAllocator& other) noexcept
+    SmallVector& operator=(std::initializer_list<T> init)
     {
-        m_smallBufferUsed = other.m_smallBufferUsed;
+        assign(init.begin(), init.end());
         return *this;
     }
-    constexpr SmallBufferVectorAllocator(SmallBufferVectorAllocator&&) noexcept {}
-    constexpr SmallBufferVectorAllocator& operator=(const SmallBufferVectorAllocator&&) noexcept { return *this; }
 
-    [[nodiscard]] constexpr T* allocate(const size_t n)
+    void assign(size_type count, const T& value)
+    {
+        T copy(value);
+        clear();
+        resize(count, copy);
+    }
+    template <std::input_iterator InputIt>
+    void assign(InputIt first, InputIt last)
+    {
+        clear();
+        append(first, last);
+    }
+    void assign(std::initializer_list<T> init) { assign(init.begin(), init.end()); }
+
+    reference at(size_type pos)
     {
-        // when the allocator was rebound we don't want to use the small buffer
-        if constexpr(std::is_same_v<T, NonReboundT>)
+        if(pos >= m_size)
         {
-            if(n <= MaxSize)
-            {
-                m_smallBufferUsed = true;
-                // as long as we use less memory than the small buffer, we return a pointer to it
-                return reinterpret_cast<T*>(&m_smallBuffer);
-            }
+            throw std::out_of_range("SmallVector::at");
         }
-        m_smallBufferUsed = false;
-        // otherwise use the default allocator
-        return m_alloc.allocate(n);
+        return m_pData[pos];
     }
-    constexpr void deallocate(void* p, const size_t n)
+    const_reference at(size_type pos) const
     {
-        // we don't deallocate anything if the memory was allocated in small buffer
-        if(&m_smallBuffer != p)
-            m_alloc.deallocate(static_cast<T*>(p), n);
-        m_smallBufferUsed = false;
+        if(pos >= m_size)
+        {
+            throw std::out_of_range("SmallVector::at");
+        }
+        return m_pData[pos];
     }
 
-    // according to the C++ standard when propagate_on_container_move_assignment is set to false, the comparision
-    // operators are used to check if two allocators are equal. When they are not, an element wise move is done instead
-    // of just taking over the memory. For our implementation this means the comparision has to return false, when the
-    // small buffer is active
-    friend constexpr bool operator==(const SmallBufferVectorAllocator& lhs, const SmallBufferVectorAllocator& rhs)
+    reference       operator[](size_type pos) { return m_pData[pos]; }
+    const_reference operator[](size_type pos) const { return m_pData[pos]; }
+    reference       front() { return m_pData[0]; }
+    const_reference front() const { return m_pData[0]; }
+    reference       back() { return m_pData[m_size - 1]; }
+    const_reference back() const { return m_pData[m_size - 1]; }
+    T*              data() noexcept { return m_pData; }
+    const T*        data() const noexcept { return m_pData; }
+
+    iterator               begin() noexcept { return m_pData; }
+    const_iterator         begin() const noexcept { return m_pData; }
+    const_iterator         cbegin() const noexcept { return m_pData; }
+    iterator               end() noexcept { return m_pData + m_size; }
+    const_iterator         end() const noexcept { return m_pData + m_size; }
+    const_iterator         cend() const noexcept { return m_pData + m_size; }
+    reverse_iterator       rbegin() noexcept { return reverse_iterator{end()}; }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator{end()}; }
+    reverse_iterator       rend() noexcept { return reverse_iterator{begin()}; }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator{begin()}; }
+
+    bool      empty() const noexcept { return m_size == 0; }
+    size_type size() const noexcept { return m_size; }
+    size_type capacity() const noexcept { return m_capacity; }
+    size_type max_size() const noexcept { return UINT32_MAX; }
+    // whether the elements are in the inline storage
+    bool isInline() const noexcept { return m_pData == inlineData(); }
+
+    void reserve(size_type capacity)
     {
-        return !lhs.m_smallBufferUsed && !rhs.m_smallBufferUsed;
+        if(capacity > m_capacity)
+        {
+            reallocate(capacity);
+        }
     }
-    friend constexpr bool operator!=(const SmallBufferVectorAllocator& lhs, const SmallBufferVectorAllocator& rhs)
+    void shrink_to_fit()
     {
-        return !(lhs == rhs);
+        if(!isInline() && m_size < m_capacity)
+        {
+            reallocate(m_size);
+        }
     }
-};
 
-template <typename T, size_t N = 8>
-class SmallVector : public std::vector<T, SmallBufferVectorAllocator<T, N>>
-{
-public:
-    using vec = std::vector<T, SmallBufferVectorAllocator<T, N>>;
-    // default initialize with the small buffer size
-    constexpr SmallVector() noexcept { vec::reserve(N); }
-    SmallVector(const SmallVector&)            = default;
-    SmallVector& operator=(const SmallVector&) = default;
-    SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+    void clear() noexcept
     {
-        if(other.size() <= N)
-            vec::reserve(N);
-        vec::operator=(std::move(other));
+        std::destroy_n(m_pData, m_size);
+        m_size = 0;
     }
-    SmallVector& operator=(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+
+    template <typename... Args>
+    reference emplace_back(Args&&... args)
     {
-        if(other.size() <= N)
-            vec::reserve(N);
-        vec::operator=(std::move(other));
-        return *this;
+        if(m_size == m_capacity)
+        {
+            return growAndEmplaceBack(std::forward<Args>(args)...);
+        }
+        T* ptr = std::construct_at(m_pData + m_size, std::forward<Args>(args)...);
+        m_size++;
+        return *ptr;
+    }
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+    void pop_back()
+    {
+        m_size--;
+        std::destroy_at(m_pData + m_size);
+    }
+
+    // new elements are appended and rotated into place
+    template <typename... Args>
+    iterator emplace(const_iterator pos, Args&&... args)
+    {
+        size_type index = pos - begin();
+        emplace_back(std::forward<Args>(args)...);
+        std::rotate(begin() + index, end() - 1, end());
+        return begin() + index;
+    }
+    iterator insert(const_iterator pos, const T& value) { return emplace(pos, value); }
+    iterator insert(const_iterator pos, T&& value) { return emplace(pos, std::move(value)); }
+    iterator insert(const_iterator pos, size_type count, const T& value)
+    {
+        size_type index = pos - begin();
+        size_type last  = m_size;
+        resize(m_size + count, value);
+        std::rotate(begin() + index, begin() + last, end());
+        return begin() + index;
+    }
+    template <std::input_iterator InputIt>
+    iterator insert(const_iterator pos, InputIt first, InputIt last)
+    {
+        size_type index = pos - begin();
+        size_type tail  = m_size;
+        append(first, last);
+        std::rotate(begin() + index, begin() + tail, end());
+        return begin() + index;
+    }
+    iterator insert(const_iterator pos, std::initializer_list<T> init) { return insert(pos, init.begin(), init.end()); }
+
+    iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        iterator dst = begin() + (first - begin());
+        if(first != last)
+        {
+            iterator newEnd = std::move(dst + (last - first), end(), dst);
+            std::destroy(newEnd, end());
+            m_size = static_cast<uint32_t>(newEnd - begin());
+        }
+        return dst;
+    }
+
+    void resize(size_type count)
+    {
+        if(count < m_size)
+        {
+            std::destroy(begin() + count, end());
+        }
+        else
+        {
+            grow(count);
+            std::uninitialized_value_construct(end(), begin() + count);
+        }
+        m_size = static_cast<uint32_t>(count);
+    }
+    void resize(size_type count, const T& value)
+    {
+        if(count < m_size)
+        {
+            std::destroy(begin() + count, end());
+        }
+        else if(count > m_capacity)
+        {
+            // the value may be one of our elements
+            T copy(value);
+            grow(count);
+            std::uninitialized_fill(end(), begin() + count, copy);
+        }
+        else
+        {
+            std::uninitialized_fill(end(), begin() + count, value);
+        }
+        m_size = static_cast<uint32_t>(count);
     }
-    // use the default constructor first to reserve then construct the values
-    explicit SmallVector(size_t count) : SmallVector() { vec::resize(count); }
-    SmallVector(size_t count, const T& value) : SmallVector() { vec::assign(count, value); }
-    template <class InputIt>
-    SmallVector(InputIt first, InputIt last) : SmallVector()
+
+    void swap(SmallVector& other) noexcept(std::is_nothrow_move_constructible_v<T>)
     {
-        vec::insert(vec::begin(), first, last);
+        SmallVector tmp{std::move(other)};
+        other = std::move(*this);
+        *this = std::move(tmp);
     }
-    SmallVector(std::initializer_list<T> init) : SmallVector() { vec::insert(vec::begin(), init); }
-    friend void swap(SmallVector& a, SmallVector& b) noexcept
+    friend void swap(SmallVector& a, SmallVector& b) noexcept(std::is_nothrow_move_constructible_v<T>) { a.swap(b); }
+
+    friend bool operator==(const SmallVector& lhs, const SmallVector& rhs)
+    {
+        return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+    template <typename Pred>
+    friend size_type erase_if(SmallVector& vec, Pred pred)
+    {
+        auto it      = std::remove_if(vec.begin(), vec.end(), pred);
+        auto removed = static_cast<size_type>(vec.end() - it);
+        vec.erase(it, vec.end());
+        return removed;
+    }
+
+private:
+    T*       inlineData() noexcept { return reinterpret_cast<T*>(m_storage); }
+    const T* inlineData() const noexcept { return reinterpret_cast<const T*>(m_storage); }
+
+    template <typename InputIt>
+    void append(InputIt first, InputIt last)
     {
-        using std::swap;
-        swap(static_cast<vec&>(a), static_cast<vec&>(b));
+        if constexpr(std::forward_iterator<InputIt>)
+        {
+            auto count = static_cast<size_type>(std::distance(first, last));
+            grow(m_size + count);
+            std::uninitialized_copy(first, last, end());
+            m_size += static_cast<uint32_t>(count);
+        }
+        else
+        {
+            for(; first != last; ++first)
+            {
+                emplace_back(*first);
+            }
+        }
     }
+
+    // moves count elements to uninitialized memory and ends the lifetime of the sources
+    static void relocate(T* pSrc, size_type count, T* pDst) noexcept(std::is_nothrow_move_constructible_v<T>)
+    {
+        if constexpr(IsTriviallyRelocatable<T>::value)
+        {
+            if(count)
+            {
+                std::memcpy(static_cast<void*>(pDst), static_cast<const void*>(pSrc), count * sizeof(T));
+            }
+        }
+        else
+        {
+            for(size_type i = 0; i < count; ++i)
+            {
+                std::construct_at(pDst + i, std::move(pSrc[i]));
+                std::destroy_at(pSrc + i);
+            }
+        }
+    }
+
+    void reallocate(size_type capacity)
+    {
+        T* pData = capacity <= N ? inlineData() : std::allocator<T>{}.allocate(capacity);
+        if(pData == m_pData)
+        {
+            return;
+        }
+        relocate(m_pData, m_size, pData);
+        releaseHeap();
+        m_pData    = pData;
+        m_capacity = static_cast<uint32_t>(std::max(capacity, N));
+    }
+
+    // geometric growth for anything that adds elements
+    void grow(size_type capacity)
+    {
+        if(capacity > m_capacity)
+        {
+            reallocate(std::max<size_type>(capacity, m_capacity * 2));
+        }
+    }
+
+    template <typename... Args>
+    reference growAndEmplaceBack(Args&&... args)
+    {
+        size_type capacity = m_capacity * 2;
+        T*        pData    = std::allocator<T>{}.allocate(capacity);
+        // construct first, the arguments may refer to our elements
+        T* ptr = std::construct_at(pData + m_size, std::forward<Args>(args)...);
+        relocate(m_pData, m_size, pData);
+        releaseHeap();
+        m_pData    = pData;
+        m_capacity = static_cast<uint32_t>(capacity);
+        m_size++;
+        return *ptr;
+    }
+
+    void releaseHeap() noexcept
+    {
+        if(!isInline())
+        {
+            std::allocator<T>{}.deallocate(m_pData, m_capacity);
+            m_pData    = inlineData();
+            m_capacity = N;
+        }
+    }
+
+    // expects this to be empty and inline
+    void takeFrom(SmallVector& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+    {
+        if(other.isInline())
+        {
+            relocate(other.m_pData, other.m_size, m_pData);
+        }
+        else
+        {
+            m_pData          = other.m_pData;
+            m_capacity       = other.m_capacity;
+            other.m_pData    = other.inlineData();
+            other.m_capacity = N;
+        }
+        m_size       = other.m_size;
+        other.m_size = 0;
+    }
+
+    T*       m_pData    = inlineData();
+    uint32_t m_size     = 0;
+    uint32_t m_capacity = N;
+    alignas(T) std::byte m_storage[N * sizeof(T)];
 };
 }  // namespace aph
 
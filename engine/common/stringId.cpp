@@ -0,0 +1,39 @@
+#include "stringId.h"
+#include "common/common.h"
+
+namespace aph
+{
+std::string_view StringId::getDebugName() const
+{
+    return StringTable::GetInstance().getName(*this);
+}
+
+void StringId::Register(StringId id, std::string_view str)
+{
+    StringTable::GetInstance().intern(str);
+}
+
+StringId StringTable::intern(std::string_view str)
+{
+    StringId         id   = StringId::FromHash(StringId::Hash(str));
+    std::string_view name = m_names.getOrCreate(id, [&]() {
+        std::lock_guard<std::mutex> holder{m_arenaLock};
+        auto*                       pData = static_cast<char*>(m_arena.allocate(str.size() + 1, alignof(char)));
+        std::memcpy(pData, str.data(), str.size());
+        pData[str.size()] = '\0';
+        return std::string_view{pData, str.size()};
+    });
+
+    if(name != str)
+    {
+        CM_LOG_ERR("string id collision between \"%s\" and \"%s\", rename one of them.", name, std::string{str});
+        APH_ASSERT(false);
+    }
+    return id;
+}
+
+std::string_view StringTable::getName(StringId id) const
+{
+    return m_names.find(id).value_or("");
+}
+}  // namespace aph
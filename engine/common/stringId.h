@@ -0,0 +1,116 @@
+#ifndef APH_STRING_ID_H_
+#define APH_STRING_ID_H_
+
+#include <memory_resource>
+#include <string_view>
+#include <type_traits>
+#include "common/concurrentHashMap.h"
+#include "common/singleton.h"
+
+namespace aph
+{
+/*
+ * 64 bit FNV-1a hash of a name, for maps keyed by resource, pass or tag names.
+ *
+ * Comparing and hashing an id is an integer operation, building one from a string hashes it once and never allocates.
+ * Literals can be hashed at compile time with "name"_sid. In debug builds ids built from runtime strings also record
+ * the string in the StringTable so getDebugName() can show it, release builds only record what is interned explicitly.
+ */
+class StringId
+{
+public:
+    static constexpr uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325ull;
+    static constexpr uint64_t FNV_PRIME        = 0x100000001b3ull;
+
+    constexpr StringId() = default;
+
+    template <typename T>
+        requires std::is_convertible_v<const T&, std::string_view>
+    constexpr StringId(const T& str) : StringId(std::string_view{str})
+    {
+    }
+
+    constexpr StringId(std::string_view str) : m_hash(Hash(str))
+    {
+#ifdef APH_DEBUG
+        if(!std::is_constant_evaluated())
+        {
+            Register(*this, str);
+        }
+#endif
+    }
+
+    static constexpr uint64_t Hash(std::string_view str)
+    {
+        uint64_t hash = FNV_OFFSET_BASIS;
+        for(char c : str)
+        {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= FNV_PRIME;
+        }
+        return hash;
+    }
+
+    static constexpr StringId FromHash(uint64_t hash)
+    {
+        StringId id;
+        id.m_hash = hash;
+        return id;
+    }
+
+    constexpr uint64_t getHash() const { return m_hash; }
+    constexpr bool     isNull() const { return m_hash == 0; }
+    constexpr explicit operator bool() const { return m_hash != 0; }
+
+    // the interned string, null-terminated, or "" for ids whose string was never recorded
+    std::string_view getDebugName() const;
+
+    constexpr auto operator<=>(const StringId&) const = default;
+
+private:
+    static void Register(StringId id, std::string_view str);
+
+    uint64_t m_hash = 0;
+};
+}  // namespace aph
+
+// HashMap falls back to std::hash and mixes the bits itself
+template <>
+struct std::hash<aph::StringId>
+{
+    std::size_t operator()(const aph::StringId& id) const noexcept { return static_cast<std::size_t>(id.getHash()); }
+};
+
+namespace aph
+{
+/*
+ * Global table from ids back to their strings.
+ *
+ * Strings are copied once into an arena that lives as long as the process, the returned views stay valid. Interning a
+ * second string with the same hash is reported as an error, such a pair has to be renamed.
+ */
+class StringTable : public Singleton<StringTable>
+{
+public:
+    StringTable() = default;
+
+    StringId         intern(std::string_view str);
+    std::string_view getName(StringId id) const;
+    std::size_t      size() const { return m_names.size(); }
+
+private:
+    ConcurrentHashMap<StringId, std::string_view> m_names;
+    std::mutex                                    m_arenaLock;
+    std::pmr::monotonic_buffer_resource           m_arena;
+};
+
+namespace literals
+{
+consteval StringId operator""_sid(const char* str, std::size_t length)
+{
+    return StringId::FromHash(StringId::Hash({str, length}));
+}
+}  // namespace literals
+}  // namespace aph
+
+#endif  // APH_STRING_ID_H_
@@ -5,6 +5,7 @@
 #include "common/hash.h"
 #include "common/logger.h"
 #include "common/singleton.h"
+#include "common/stringId.h"
 
 namespace aph
 {
@@ -20,8 +21,8 @@ enum class TimeUnit
 class Timer
 {
 public:
-    // Set a timestamp with a specific tag
-    APH_ALWAYS_INLINE void set(const std::string& tag)
+    // Set a timestamp with a specific tag, the tag is hashed by the caller and the lock only guards an integer lookup
+    APH_ALWAYS_INLINE void set(StringId tag)
     {
         std::lock_guard<std::mutex> m_holder{m_lock};
         m_strMap[tag] = Clock::now();
@@ -33,10 +34,10 @@ public:
     }
 
     // Calculate the interval between two timestamps using their tags
-    APH_ALWAYS_INLINE double interval(std::string_view start, std::string_view end) const
+    APH_ALWAYS_INLINE double interval(StringId start, StringId end) const
     {
-        auto it1 = m_strMap.find(start.data());
-        auto it2 = m_strMap.find(end.data());
+        auto it1 = m_strMap.find(start);
+        auto it2 = m_strMap.find(end);
 
         if(it1 == m_strMap.end() || it2 == m_strMap.end())
         {
@@ -70,9 +71,9 @@ private:
     using TimePoint = std::chrono::time_point<Clock>;
     using Duration  = std::chrono::duration<double>;
 
-    HashMap<std::string, TimePoint> m_strMap;
-    HashMap<uint32_t, TimePoint>    m_numMap;
-    std::mutex                      m_lock;
+    HashMap<StringId, TimePoint> m_strMap;
+    HashMap<uint32_t, TimePoint> m_numMap;
+    std::mutex                   m_lock;
 };
 
 }  // namespace aph
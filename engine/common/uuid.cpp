@@ -0,0 +1,377 @@
+#include "uuid.h"
+#include <algorithm>
+#include <array>
+#include "common/common.h"
+#include "endianness.h"
+
+#if defined(APH_SIMD_X86)
+    #include <immintrin.h>
+#endif
+
+namespace
+{
+using aph::simd::Level;
+using aph::uuid::STRING_LENGTH;
+
+constexpr std::size_t UUID_SIZE = 16;
+
+// kernels work on packed 16 byte values and packed STRING_LENGTH char strings
+using FormatFunc = void (*)(const uint8_t* pBytes, std::size_t count, char* pOut);
+using ParseFunc  = void (*)(const char* pIn, std::size_t count, uint8_t* pBytes);
+
+struct Codec
+{
+    FormatFunc format = {};
+    ParseFunc  parse  = {};
+};
+
+constexpr char HEX_DIGITS[] = "0123456789abcdef";
+
+// position of the high digit of every byte in the string, the groups are 8-4-4-4-12 digits
+constexpr uint8_t DIGIT_POSITIONS[UUID_SIZE] = {0, 2, 4, 6, 9, 11, 14, 16, 19, 21, 24, 26, 28, 30, 32, 34};
+
+// '0'-'9', 'a'-'f' and 'A'-'F' to their value, other characters are not checked
+uint8_t hexValue(char c)
+{
+    return (c & 0x0F) + ((c >> 6) & 1) * 9;
+}
+
+void formatScalar(const uint8_t* pBytes, std::size_t count, char* pOut)
+{
+    for(std::size_t i = 0; i < count; ++i, pBytes += UUID_SIZE, pOut += STRING_LENGTH)
+    {
+        pOut[8] = pOut[13] = pOut[18] = pOut[23] = '-';
+        for(std::size_t b = 0; b < UUID_SIZE; ++b)
+        {
+            pOut[DIGIT_POSITIONS[b]]     = HEX_DIGITS[pBytes[b] >> 4];
+            pOut[DIGIT_POSITIONS[b] + 1] = HEX_DIGITS[pBytes[b] & 0x0F];
+        }
+    }
+}
+
+void parseScalar(const char* pIn, std::size_t count, uint8_t* pBytes)
+{
+    for(std::size_t i = 0; i < count; ++i, pIn += STRING_LENGTH, pBytes += UUID_SIZE)
+    {
+        for(std::size_t b = 0; b < UUID_SIZE; ++b)
+        {
+            pBytes[b] = (hexValue(pIn[DIGIT_POSITIONS[b]]) << 4) | hexValue(pIn[DIGIT_POSITIONS[b] + 1]);
+        }
+    }
+}
+
+#if defined(APH_SIMD_X86)
+/*
+  SSE4.2: nibbles are translated with a pshufb table lookup, the dashes are inserted by shuffling the two halves of
+  the hex digits into place.
+ */
+APH_TARGET("sse4.2") void formatSSE42(const uint8_t* pBytes, std::size_t count, char* pOut)
+{
+    const __m128i table  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(HEX_DIGITS));
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+    // out[0..15]: digits 0-7, '-', 8-11, '-', 12-13
+    const __m128i shuffle0 = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, -1, 8, 9, 10, 11, -1, 12, 13);
+    const __m128i dash0    = _mm_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, '-', 0, 0, 0, 0, '-', 0, 0);
+    // out[16..31]: digits 14-15, '-', 16-19, '-', 20-27
+    const __m128i shuffle1lo = _mm_setr_epi8(14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i shuffle1hi = _mm_setr_epi8(-1, -1, -1, 0, 1, 2, 3, -1, 4, 5, 6, 7, 8, 9, 10, 11);
+    const __m128i dash1      = _mm_setr_epi8(0, 0, '-', 0, 0, 0, 0, '-', 0, 0, 0, 0, 0, 0, 0, 0);
+
+    for(std::size_t i = 0; i < count; ++i, pBytes += UUID_SIZE, pOut += STRING_LENGTH)
+    {
+        __m128i x  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pBytes));
+        __m128i hi = _mm_and_si128(_mm_srli_epi16(x, 4), nibble);
+        __m128i lo = _mm_and_si128(x, nibble);
+        // digits 0-15 and 16-31
+        __m128i a = _mm_shuffle_epi8(table, _mm_unpacklo_epi8(hi, lo));
+        __m128i b = _mm_shuffle_epi8(table, _mm_unpackhi_epi8(hi, lo));
+
+        __m128i out0 = _mm_or_si128(_mm_shuffle_epi8(a, shuffle0), dash0);
+        __m128i out1 = _mm_or_si128(_mm_shuffle_epi8(a, shuffle1lo), _mm_shuffle_epi8(b, shuffle1hi));
+        out1         = _mm_or_si128(out1, dash1);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pOut), out0);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pOut + 16), out1);
+        // digits 28-31
+        uint32_t tail = _mm_extract_epi32(b, 3);
+        std::memcpy(pOut + 32, &tail, sizeof(tail));
+    }
+}
+
+/*
+  SSE4.2: the dashes are shuffled out, digits become values with a compare and add, and maddubs joins digit pairs.
+ */
+APH_TARGET("sse4.2") void parseSSE42(const char* pIn, std::size_t count, uint8_t* pBytes)
+{
+    // digits 0-13 from in[0..15], 14-15 from in[16..17]
+    const __m128i gather0lo = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 9, 10, 11, 12, 14, 15, -1, -1);
+    const __m128i gather0hi = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, 1);
+    // digits 16-27 from in[16..31], 28-31 are inserted from in[32..35]
+    const __m128i gather1 = _mm_setr_epi8(3, 4, 5, 6, 8, 9, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1);
+    const __m128i nibble  = _mm_set1_epi8(0x0F);
+    const __m128i nine    = _mm_set1_epi8(9);
+    const __m128i digit9  = _mm_set1_epi8('9');
+    // high digit * 16 + low digit
+    const __m128i weights = _mm_set1_epi16(0x0110);
+
+    for(std::size_t i = 0; i < count; ++i, pIn += STRING_LENGTH, pBytes += UUID_SIZE)
+    {
+        __m128i in0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pIn));
+        __m128i in1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pIn + 16));
+        int32_t tail;
+        std::memcpy(&tail, pIn + 32, sizeof(tail));
+
+        __m128i a = _mm_or_si128(_mm_shuffle_epi8(in0, gather0lo), _mm_shuffle_epi8(in1, gather0hi));
+        __m128i b = _mm_insert_epi32(_mm_shuffle_epi8(in1, gather1), tail, 3);
+
+        a = _mm_add_epi8(_mm_and_si128(a, nibble), _mm_and_si128(_mm_cmpgt_epi8(a, digit9), nine));
+        b = _mm_add_epi8(_mm_and_si128(b, nibble), _mm_and_si128(_mm_cmpgt_epi8(b, digit9), nine));
+
+        __m128i x = _mm_packus_epi16(_mm_maddubs_epi16(a, weights), _mm_maddubs_epi16(b, weights));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pBytes), x);
+    }
+}
+
+/*
+  AVX2: converts a 128-bits unsigned int to an UUIDv4 string representation.
+ */
+APH_TARGET("avx2") void formatOneAVX2(const uint8_t* pBytes, char* mem)
+{
+    // Expand each byte in x to two bytes in res
+    // i.e. 0x12345678 -> 0x0102030405060708
+    // Then translate each byte to its hex ascii representation
+    // i.e. 0x0102030405060708 -> 0x3132333435363738
+    const __m256i mask         = _mm256_set1_epi8(0x0F);
+    const __m256i add          = _mm256_set1_epi8(0x06);
+    const __m256i alpha_mask   = _mm256_set1_epi8(0x10);
+    const __m256i alpha_offset = _mm256_set1_epi8(0x57);
+
+    __m128i x      = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pBytes));
+    __m256i a      = _mm256_castsi128_si256(x);
+    __m256i as     = _mm256_srli_epi64(a, 4);
+    __m256i lo     = _mm256_unpacklo_epi8(as, a);
+    __m128i hi     = _mm256_castsi256_si128(_mm256_unpackhi_epi8(as, a));
+    __m256i c      = _mm256_inserti128_si256(lo, hi, 1);
+    __m256i d      = _mm256_and_si256(c, mask);
+    __m256i alpha  = _mm256_slli_epi64(_mm256_and_si256(_mm256_add_epi8(d, add), alpha_mask), 3);
+    __m256i offset = _mm256_blendv_epi8(_mm256_slli_epi64(add, 3), alpha_offset, alpha);
+    __m256i res    = _mm256_add_epi8(d, offset);
+
+    // Add dashes between blocks as specified in RFC-4122
+    // 8-4-4-4-12
+    const __m256i dash_shuffle = _mm256_set_epi32(0x0b0a0908, 0x07060504, 0x80030201, 0x00808080, 0x0d0c800b,
+                                                  0x0a090880, 0x07060504, 0x03020100);
+    const __m256i dash =
+        _mm256_set_epi64x(0x0000000000000000ull, 0x2d000000002d0000ull, 0x00002d000000002d, 0x0000000000000000ull);
+
+    __m256i resd = _mm256_shuffle_epi8(res, dash_shuffle);
+    resd         = _mm256_or_si256(resd, dash);
+
+    _mm256_storeu_si256((__m256i*)mem, betole256(resd));
+    uint16_t mid  = betole16(_mm256_extract_epi16(res, 7));
+    uint32_t tail = betole32(_mm256_extract_epi32(res, 7));
+    std::memcpy(mem + 16, &mid, sizeof(mid));
+    std::memcpy(mem + 32, &tail, sizeof(tail));
+}
+
+/*
+  AVX2: converts an UUIDv4 string representation to a 128-bits unsigned int.
+ */
+APH_TARGET("avx2") void parseOneAVX2(const char* mem, uint8_t* pBytes)
+{
+    // Remove dashes and pack hex ascii bytes in a 256-bits int
+    const __m256i dash_shuffle = _mm256_set_epi32(0x80808080, 0x0f0e0d0c, 0x0b0a0908, 0x06050403, 0x80800f0e,
+                                                  0x0c0b0a09, 0x07060504, 0x03020100);
+
+    uint16_t mid;
+    uint32_t tail;
+    std::memcpy(&mid, mem + 16, sizeof(mid));
+    std::memcpy(&tail, mem + 32, sizeof(tail));
+
+    __m256i x = betole256(_mm256_loadu_si256((__m256i*)mem));
+    x         = _mm256_shuffle_epi8(x, dash_shuffle);
+    x         = _mm256_insert_epi16(x, betole16(mid), 7);
+    x         = _mm256_insert_epi32(x, betole32(tail), 7);
+
+    // Build a mask to add 9 to the low nibble of alphas, either case
+    const __m256i nibble  = _mm256_set1_epi8(0x0F);
+    const __m256i nine    = _mm256_set1_epi8(9);
+    const __m256i digit9  = _mm256_set1_epi8('9');
+    const __m256i unweave = _mm256_set_epi32(0x0f0d0b09, 0x0e0c0a08, 0x07050301, 0x06040200, 0x0f0d0b09, 0x0e0c0a08,
+                                             0x07050301, 0x06040200);
+    const __m256i shift   = _mm256_set_epi32(0x00000000, 0x00000004, 0x00000000, 0x00000004, 0x00000000, 0x00000004,
+                                             0x00000000, 0x00000004);
+
+    // Translate ascii bytes to their value
+    // i.e. 0x3132333435363738 -> 0x0102030405060708
+    // Shift hi-digits
+    // i.e. 0x0102030405060708 -> 0x1002300450067008
+    // Horizontal add
+    // i.e. 0x1002300450067008 -> 0x12345678
+    __m256i alpha = _mm256_and_si256(_mm256_cmpgt_epi8(x, digit9), nine);
+    __m256i a     = _mm256_add_epi8(_mm256_and_si256(x, nibble), alpha);
+    a             = _mm256_shuffle_epi8(a, unweave);
+    a             = _mm256_sllv_epi32(a, shift);
+    a             = _mm256_hadd_epi32(a, _mm256_setzero_si256());
+    a             = _mm256_permute4x64_epi64(a, 0b00001000);
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(pBytes), _mm256_castsi256_si128(a));
+}
+
+APH_TARGET("avx2") void formatAVX2(const uint8_t* pBytes, std::size_t count, char* pOut)
+{
+    for(std::size_t i = 0; i < count; ++i, pBytes += UUID_SIZE, pOut += STRING_LENGTH)
+    {
+        formatOneAVX2(pBytes, pOut);
+    }
+}
+
+APH_TARGET("avx2") void parseAVX2(const char* pIn, std::size_t count, uint8_t* pBytes)
+{
+    for(std::size_t i = 0; i < count; ++i, pIn += STRING_LENGTH, pBytes += UUID_SIZE)
+    {
+        parseOneAVX2(pIn, pBytes);
+    }
+}
+
+    #define APH_TARGET_AVX512 APH_TARGET("avx512f,avx512bw,avx512vl,avx512vbmi")
+
+// string position of every digit, for vpermb
+constexpr std::array<uint8_t, 64> makeDigitPositions()
+{
+    std::array<uint8_t, 64> positions{};
+    for(uint8_t digit = 0; digit < 32; ++digit)
+    {
+        positions[digit] = digit + (digit >= 8) + (digit >= 12) + (digit >= 16) + (digit >= 20);
+        // the second string of a pair comes from the second source of vpermt2b
+        positions[digit + 32] = positions[digit] + 64;
+    }
+    return positions;
+}
+
+// digit of every string position, dashes are blended in afterwards
+constexpr std::array<uint8_t, 64> makeStringDigits(uint8_t first)
+{
+    std::array<uint8_t, 64> digits{};
+    for(uint8_t pos = 0; pos < STRING_LENGTH; ++pos)
+    {
+        digits[pos] = first + pos - (pos > 8) - (pos > 13) - (pos > 18) - (pos > 23);
+    }
+    return digits;
+}
+
+// HEX_DIGITS in every 128 bit lane, vpshufb looks up within lanes
+constexpr std::array<char, 64> makeHexTable()
+{
+    std::array<char, 64> table{};
+    for(std::size_t i = 0; i < table.size(); ++i)
+    {
+        table[i] = HEX_DIGITS[i % 16];
+    }
+    return table;
+}
+
+constexpr auto      DIGIT_POSITIONS_512 = makeDigitPositions();
+constexpr auto      STRING_DIGITS_LO    = makeStringDigits(0);
+constexpr auto      STRING_DIGITS_HI    = makeStringDigits(32);
+constexpr auto      HEX_TABLE_512       = makeHexTable();
+constexpr __mmask64 DASH_MASK           = (1ull << 8) | (1ull << 13) | (1ull << 18) | (1ull << 23);
+constexpr __mmask64 STRING_MASK         = (1ull << STRING_LENGTH) - 1;
+
+/*
+  AVX-512: two UUIDs per iteration, the 64 digits are built in one register and a merge masked vpermb moves each
+  string into place over a register of dashes, masked stores write exactly STRING_LENGTH chars.
+ */
+APH_TARGET_AVX512 void formatAVX512(const uint8_t* pBytes, std::size_t count, char* pOut)
+{
+    const __m512i table  = _mm512_loadu_si512(HEX_TABLE_512.data());
+    const __m512i nibble = _mm512_set1_epi16(0x0F);
+    const __m512i dashes = _mm512_set1_epi8('-');
+    const __m512i lo     = _mm512_loadu_si512(STRING_DIGITS_LO.data());
+    const __m512i hi     = _mm512_loadu_si512(STRING_DIGITS_HI.data());
+
+    std::size_t i = 0;
+    for(; i + 2 <= count; i += 2, pBytes += 2 * UUID_SIZE, pOut += 2 * STRING_LENGTH)
+    {
+        // every byte in a word, high nibble in the low half so it comes first in memory
+        __m512i words  = _mm512_cvtepu8_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pBytes)));
+        __m512i high   = _mm512_srli_epi16(words, 4);
+        __m512i low    = _mm512_slli_epi16(_mm512_and_si512(words, nibble), 8);
+        __m512i digits = _mm512_shuffle_epi8(table, _mm512_or_si512(high, low));
+
+        __m512i out0 = _mm512_mask_permutexvar_epi8(dashes, ~DASH_MASK, lo, digits);
+        __m512i out1 = _mm512_mask_permutexvar_epi8(dashes, ~DASH_MASK, hi, digits);
+        _mm512_mask_storeu_epi8(pOut, STRING_MASK, out0);
+        _mm512_mask_storeu_epi8(pOut + STRING_LENGTH, STRING_MASK, out1);
+    }
+    formatAVX2(pBytes, count - i, pOut);
+}
+
+APH_TARGET_AVX512 void parseAVX512(const char* pIn, std::size_t count, uint8_t* pBytes)
+{
+    const __m512i gather  = _mm512_loadu_si512(DIGIT_POSITIONS_512.data());
+    const __m512i nibble  = _mm512_set1_epi8(0x0F);
+    const __m512i nine    = _mm512_set1_epi8(9);
+    const __m512i digit9  = _mm512_set1_epi8('9');
+    const __m512i weights = _mm512_set1_epi16(0x0110);
+
+    std::size_t i = 0;
+    for(; i + 2 <= count; i += 2, pIn += 2 * STRING_LENGTH, pBytes += 2 * UUID_SIZE)
+    {
+        __m512i in0 = _mm512_maskz_loadu_epi8(STRING_MASK, pIn);
+        __m512i in1 = _mm512_maskz_loadu_epi8(STRING_MASK, pIn + STRING_LENGTH);
+
+        __m512i   digits = _mm512_permutex2var_epi8(in0, gather, in1);
+        __mmask64 alpha  = _mm512_cmpgt_epi8_mask(digits, digit9);
+        digits           = _mm512_and_si512(digits, nibble);
+        digits           = _mm512_mask_add_epi8(digits, alpha, digits, nine);
+
+        // vpmovwb narrows the 32 words straight to memory
+        _mm512_mask_cvtepi16_storeu_epi8(pBytes, ~__mmask32{}, _mm512_maddubs_epi16(digits, weights));
+    }
+    parseAVX2(pIn, count - i, pBytes);
+}
+#endif
+
+const Codec& getCodec(Level level)
+{
+    static const Codec codecs[] = {
+        {formatScalar, parseScalar},
+#if defined(APH_SIMD_X86)
+        {formatSSE42, parseSSE42},
+        {formatAVX2, parseAVX2},
+        {formatAVX512, parseAVX512},
+#endif
+    };
+    APH_ASSERT(level <= aph::simd::getSupportedLevel());
+    return codecs[std::min<std::size_t>(static_cast<std::size_t>(level), std::size(codecs) - 1)];
+}
+
+const Codec& getCodec()
+{
+    static const Codec& codec = getCodec(aph::simd::getLevel());
+    return codec;
+}
+}  // namespace
+
+namespace aph::uuid
+{
+void format(std::span<const UUID> uuids, char* pOut)
+{
+    getCodec().format(reinterpret_cast<const uint8_t*>(uuids.data()), uuids.size(), pOut);
+}
+
+void format(std::span<const UUID> uuids, char* pOut, simd::Level level)
+{
+    getCodec(level).format(reinterpret_cast<const uint8_t*>(uuids.data()), uuids.size(), pOut);
+}
+
+void parse(const char* pIn, std::span<UUID> uuids)
+{
+    getCodec().parse(pIn, uuids.size(), reinterpret_cast<uint8_t*>(uuids.data()));
+}
+
+void parse(const char* pIn, std::span<UUID> uuids, simd::Level level)
+{
+    getCodec(level).parse(pIn, uuids.size(), reinterpret_cast<uint8_t*>(uuids.data()));
+}
+}  // namespace aph::uuid
@@ -5,6 +5,7 @@
 #include <any>
 #include <mutex>
 #include "common/hash.h"
+#include "common/inplaceFunction.h"
 #include "threads/taskManager.h"
 
 namespace aph
@@ -12,11 +13,14 @@ namespace aph
 
 class EventManager : public Singleton<EventManager>
 {
+    template <typename TEvent>
+    using EventHandler = InplaceFunction<bool(const TEvent&)>;
+
     template <typename TEvent>
     struct EventData
     {
-        std::queue<TEvent>                              m_events;
-        SmallVector<std::function<bool(const TEvent&)>> m_handlers;
+        std::queue<TEvent>                m_events;
+        SmallVector<EventHandler<TEvent>> m_handlers;
 
         void process()
         {
@@ -44,7 +48,7 @@ public:
     }
 
     template <typename TEvent>
-    void registerEventHandler(std::function<bool(const TEvent&)>&& func)
+    void registerEventHandler(EventHandler<TEvent>&& func)
     {
         getEventData<TEvent>().m_handlers.push_back(std::move(func));
     }
@@ -57,33 +61,35 @@ public:
 
     void processAllAsync()
     {
-        auto group = m_taskManager.createTaskGroup("event processing");
+        auto group = m_taskContext.createTaskGroup("event processing");
         // TODO check that different event type don't cause data race
         for(auto& [_, value] : m_eventDataMap)
         {
             group->addTask([&value]() { value.second(value.first); });
         }
-        m_taskManager.submit(group);
+        m_taskContext.submit(group);
     }
 
-    void flush() { m_taskManager.wait(); }
+    void flush() { m_taskContext.wait(); }
 
 private:
-    TaskManager m_taskManager = {5, "Event Manager"};
+    TaskContext m_taskContext = {"Event Manager"};
     std::mutex  m_dataMapMutex;
 
+    // handlers are move-only, so the type-erased event data is kept behind a shared_ptr to satisfy std::any
     HashMap<std::type_index, std::pair<std::any, std::function<void(std::any&)>>> m_eventDataMap;
 
     template <typename TEvent>
     EventData<TEvent>& getEventData()
     {
-        auto ti = std::type_index(typeid(TEvent));
+        using DataPtr = std::shared_ptr<EventData<TEvent>>;
+        auto ti       = std::type_index(typeid(TEvent));
         if(!m_eventDataMap.contains(ti))
         {
-            m_eventDataMap[ti] = {EventData<TEvent>{},
-                                  [](std::any& eventData) { std::any_cast<EventData<TEvent>&>(eventData).process(); }};
+            m_eventDataMap[ti] = {std::make_shared<EventData<TEvent>>(),
+                                  [](std::any& eventData) { std::any_cast<DataPtr&>(eventData)->process(); }};
         }
-        return std::any_cast<EventData<TEvent>&>(m_eventDataMap[ti].first);
+        return *std::any_cast<DataPtr&>(m_eventDataMap[ti].first);
     }
 };
 
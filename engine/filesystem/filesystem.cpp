@@ -38,27 +38,28 @@ void Filesystem::clearMappedFiles()
 
 std::filesystem::path Filesystem::resolvePath(std::string_view inputPath)
 {
-    auto        protocolEnd = inputPath.find("://");
-    std::string protocol;
-    std::string relativePath;
-
-    if(protocolEnd != std::string::npos)
+    // the protocol is looked up as a view into the input, no temporary strings
+    auto protocolEnd = inputPath.find("://");
+    if(protocolEnd == std::string_view::npos)
     {
-        protocol     = inputPath.substr(0, protocolEnd);
-        relativePath = inputPath.substr(protocolEnd + 3);
-        if(!m_protocols.contains(protocol))
+        // plain paths are relative to the working directory unless a "file" protocol is registered
+        auto it = m_protocols.find("file");
+        if(it == m_protocols.end())
         {
-            CM_LOG_ERR("Unknown protocol: %s", protocol);
-            return {};
+            return getCurrentWorkingDirectory() / inputPath;
         }
+        return getCurrentWorkingDirectory() / std::filesystem::path(it->second) / inputPath;
     }
-    else
+
+    std::string_view protocol = inputPath.substr(0, protocolEnd);
+    auto             it       = m_protocols.find(protocol);
+    if(it == m_protocols.end())
     {
-        protocol     = "file";
-        relativePath = inputPath;
+        CM_LOG_ERR("Unknown protocol: %s", std::string{protocol});
+        return {};
     }
 
-    return getCurrentWorkingDirectory() / std::filesystem::path(m_protocols[protocol]) / relativePath;
+    return getCurrentWorkingDirectory() / std::filesystem::path(it->second) / inputPath.substr(protocolEnd + 3);
 }
 
 void* Filesystem::map(std::string_view path)
@@ -38,7 +38,7 @@ public:
     requires std::is_same_v<std::remove_cvref_t<T>, HashMap<std::string, std::string>>
     void registerProtocol(T&& protocols)
     {
-        m_protocols = std::forward<T>(protocols);
+        m_protocols = StringMap<std::string>(protocols.begin(), protocols.end());
     }
     void registerProtocol(const std::string& protocol, const std::string& path);
     bool protocolExists(const std::string& protocol);
@@ -49,7 +49,7 @@ public:
 
 private:
     HashMap<int, std::function<void()>> m_callbacks;
-    HashMap<std::string, std::string>   m_protocols;
+    StringMap<std::string>              m_protocols;
     HashMap<void*, std::size_t>         m_mappedFiles;
     std::mutex                          m_mapLock;
 };
@@ -1,6 +1,7 @@
+#include <array>
 #include "renderGraph.h"
 #include "common/profiler.h"
-#include "threads/taskManager.h"
+#include "threads/taskGraph.h"
 
 namespace aph
 {
@@ -14,7 +15,7 @@ RenderPass::RenderPass(RenderGraph* pRDG, uint32_t index, QueueType queueType, s
     APH_ASSERT(pRDG);
 }
 
-PassBufferResource* RenderPass::addStorageBufferInput(const std::string& name, vk::Buffer* pBuffer)
+PassBufferResource* RenderPass::addStorageBufferInput(StringId name, vk::Buffer* pBuffer)
 {
     APH_PROFILER_SCOPE();
     auto* res = static_cast<PassBufferResource*>(m_pRenderGraph->getResource(name, PassResource::Type::Buffer));
@@ -33,7 +34,7 @@ PassBufferResource* RenderPass::addStorageBufferInput(const std::string& name, v
     return res;
 }
 
-PassBufferResource* RenderPass::addUniformBufferInput(const std::string& name, vk::Buffer* pBuffer)
+PassBufferResource* RenderPass::addUniformBufferInput(StringId name, vk::Buffer* pBuffer)
 {
     APH_PROFILER_SCOPE();
     auto* res = static_cast<PassBufferResource*>(m_pRenderGraph->getResource(name, PassResource::Type::Buffer));
@@ -52,7 +53,7 @@ PassBufferResource* RenderPass::addUniformBufferInput(const std::string& name, v
     return res;
 }
 
-PassBufferResource* RenderPass::addBufferOutput(const std::string& name)
+PassBufferResource* RenderPass::addBufferOutput(StringId name)
 {
     APH_PROFILER_SCOPE();
     auto* res = static_cast<PassBufferResource*>(m_pRenderGraph->getResource(name, PassResource::Type::Buffer));
@@ -65,7 +66,7 @@ PassBufferResource* RenderPass::addBufferOutput(const std::string& name)
 
     return res;
 }
-PassImageResource* RenderPass::addTextureOutput(const std::string& name)
+PassImageResource* RenderPass::addTextureOutput(StringId name)
 {
     APH_PROFILER_SCOPE();
     auto* res = static_cast<PassImageResource*>(m_pRenderGraph->getResource(name, PassResource::Type::Image));
@@ -79,7 +80,7 @@ PassImageResource* RenderPass::addTextureOutput(const std::string& name)
     return res;
 }
 
-PassImageResource* RenderPass::addTextureInput(const std::string& name, vk::Image* pImage)
+PassImageResource* RenderPass::addTextureInput(StringId name, vk::Image* pImage)
 {
     APH_PROFILER_SCOPE();
     auto* res = static_cast<PassImageResource*>(m_pRenderGraph->getResource(name, PassResource::Type::Image));
@@ -98,7 +99,7 @@ PassImageResource* RenderPass::addTextureInput(const std::string& name, vk::Imag
     return res;
 }
 
-PassImageResource* RenderPass::setColorOutput(const std::string& name, const PassImageInfo& info)
+PassImageResource* RenderPass::setColorOutput(StringId name, const PassImageInfo& info)
 {
     APH_PROFILER_SCOPE();
     auto* res = static_cast<PassImageResource*>(m_pRenderGraph->getResource(name, PassResource::Type::Image));
@@ -110,7 +111,7 @@ PassImageResource* RenderPass::setColorOutput(const std::string& name, const Pas
     return res;
 }
 
-PassImageResource* RenderPass::setDepthStencilOutput(const std::string& name, const PassImageInfo& info)
+PassImageResource* RenderPass::setDepthStencilOutput(StringId name, const PassImageInfo& info)
 {
     APH_PROFILER_SCOPE();
     auto* res = static_cast<PassImageResource*>(m_pRenderGraph->getResource(name, PassResource::Type::Image));
@@ -122,27 +123,29 @@ PassImageResource* RenderPass::setDepthStencilOutput(const std::string& name, co
     return res;
 }
 
-RenderPass* RenderGraph::getPass(const std::string& name)
+RenderPass* RenderGraph::getPass(StringId name)
 {
     APH_PROFILER_SCOPE();
-    if(m_declareData.passMap.contains(name))
+    if(auto it = m_declareData.passMap.find(name); it != m_declareData.passMap.end())
     {
-        return m_declareData.passes[m_declareData.passMap[name]];
+        return m_declareData.passes[it->second];
     }
     return nullptr;
 }
-RenderPass* RenderGraph::createPass(const std::string& name, QueueType queueType)
+RenderPass* RenderGraph::createPass(std::string_view name, QueueType queueType)
 {
     APH_PROFILER_SCOPE();
-    if(m_declareData.passMap.contains(name))
+    // interned so the pass can be found by name in logs and captures
+    StringId id = StringTable::GetInstance().intern(name);
+    if(auto it = m_declareData.passMap.find(id); it != m_declareData.passMap.end())
     {
-        return m_declareData.passes[m_declareData.passMap[name]];
+        return m_declareData.passes[it->second];
     }
 
     auto  index = m_declareData.passes.size();
     auto* pass  = m_resourcePool.renderPass.allocate(this, index, queueType, name);
     m_declareData.passes.emplace_back(pass);
-    m_declareData.passMap[name] = index;
+    m_declareData.passMap[id] = index;
     return pass;
 }
 
@@ -150,14 +153,14 @@ RenderGraph::RenderGraph(vk::Device* pDevice) : m_pDevice(pDevice)
 {
 }
 
-void RenderGraph::build(vk::SwapChain* pSwapChain)
+bool RenderGraph::build(vk::SwapChain* pSwapChain)
 {
     APH_PROFILER_SCOPE();
     // TODO clear on demand
     {
         m_buildData.bufferBarriers.clear();
         m_buildData.imageBarriers.clear();
-        m_buildData.frameSubmitInfos.clear();
+        m_buildData.sortedPasses.clear();
         for(auto* pass : m_declareData.passes)
         {
             m_buildData.passDependencyGraph[pass].clear();
@@ -245,8 +248,29 @@ void RenderGraph::build(vk::SwapChain* pSwapChain)
             }
         }
 
-        // Check if there was a cycle in the graph
-        APH_ASSERT(result.size() == graph.size());
+        // a pass on a cycle never reaches zero in-degree, it would get no submit slot of its own
+        if(result.size() != graph.size())
+        {
+            VK_LOG_ERR("render graph has a cycle, %zu of %zu passes can never run.", graph.size() - result.size(),
+                       graph.size());
+            result.clear();
+            m_buildData.submitSlots.clear();
+            m_buildData.frameSubmitInfos.clear();
+            m_buildData.pSwapchain = nullptr;
+            return false;
+        }
+    }
+
+    // the sort puts the readers first, submit the writers first
+    {
+        auto& sortedPasses = m_buildData.sortedPasses;
+        m_buildData.submitSlots.resize(m_declareData.passes.size());
+        for(uint32_t slot = 0; slot < sortedPasses.size(); ++slot)
+        {
+            m_buildData.submitSlots[sortedPasses[sortedPasses.size() - 1 - slot]->getIndex()] = slot;
+        }
+        // slots keep their vectors across frames, recording into them does not allocate
+        m_buildData.frameSubmitInfos.resize(sortedPasses.size());
     }
 
     // per pass resource build
@@ -272,7 +296,7 @@ void RenderGraph::build(vk::SwapChain* pSwapChain)
                     .imageType = VK_IMAGE_TYPE_2D,
                     .format    = colorAttachment->getInfo().format,
                 };
-                if(!m_declareData.backBuffer.empty() && m_declareData.resourceMap.contains(m_declareData.backBuffer))
+                if(m_declareData.backBuffer && m_declareData.resourceMap.contains(m_declareData.backBuffer))
                 {
                     createInfo.usage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
                 }
@@ -307,8 +331,12 @@ void RenderGraph::build(vk::SwapChain* pSwapChain)
 
     // record commands
     {
-        auto& taskMgr = m_taskManager;
-        auto  taskgrp = taskMgr.createTaskGroup();
+        // passes are only added between builds, cleanup() clears the graph along with them
+        const bool addNodes = m_recordGraph.getNodeCount() != m_declareData.passes.size();
+        if(addNodes)
+        {
+            m_recordGraph.clear();
+        }
 
         for(auto* pass : m_declareData.passes)
         {
@@ -384,7 +412,13 @@ void RenderGraph::build(vk::SwapChain* pSwapChain)
 
             APH_ASSERT(!colorImages.empty());
 
-            taskgrp->addTask(
+            if(!addNodes)
+            {
+                continue;
+            }
+
+            // barriers and submit slots are looked up on every run, the attachments only change with the passes
+            m_recordGraph.addNode(
                 [this, pass, colorImages, pDepthImage]() {
                     auto* pCmd = m_buildData.cmds[pass];
                     pCmd->begin();
@@ -398,22 +432,18 @@ void RenderGraph::build(vk::SwapChain* pSwapChain)
                     pCmd->endRendering();
                     pCmd->end();
 
-                    // lock
-                    vk::QueueSubmitInfo submitInfo{
-                        .commandBuffers   = {pCmd},
-                        .waitSemaphores   = {},
-                        .signalSemaphores = {},
-                    };
-
-                    std::lock_guard<std::mutex> holder{m_buildData.submitLock};
-                    m_buildData.frameSubmitInfos.push_back(std::move(submitInfo));
+                    // every pass owns its slot, no lock
+                    auto& submitInfo = m_buildData.frameSubmitInfos[m_buildData.submitSlots[pass->getIndex()]];
+                    submitInfo.commandBuffers.assign(1, pCmd);
                 },
-                pass->m_name);
+                pass->m_name.c_str());
         }
-        taskMgr.submit(taskgrp);
+
+        m_recordGraph.run();
     }
 
-    m_taskManager.wait();
+    m_recordGraph.wait();
+    return true;
 }
 
 RenderGraph::~RenderGraph()
@@ -422,7 +452,7 @@ RenderGraph::~RenderGraph()
     cleanup();
 }
 
-PassResource* RenderGraph::importResource(const std::string& name, vk::Buffer* pBuffer)
+PassResource* RenderGraph::importResource(StringId name, vk::Buffer* pBuffer)
 {
     APH_PROFILER_SCOPE();
     auto res = getResource(name, PassResource::Type::Buffer);
@@ -432,7 +462,7 @@ PassResource* RenderGraph::importResource(const std::string& name, vk::Buffer* p
     return res;
 }
 
-PassResource* RenderGraph::importResource(const std::string& name, vk::Image* pImage)
+PassResource* RenderGraph::importResource(StringId name, vk::Image* pImage)
 {
     APH_PROFILER_SCOPE();
     auto res = getResource(name, PassResource::Type::Image);
@@ -442,13 +472,17 @@ PassResource* RenderGraph::importResource(const std::string& name, vk::Image* pI
     return res;
 }
 
-PassResource* RenderGraph::getResource(const std::string& name, PassResource::Type type)
+PassResource* RenderGraph::getResource(StringId name, PassResource::Type type)
 {
     APH_PROFILER_SCOPE();
-    if(m_declareData.resourceMap.contains(name))
+    if(auto it = m_declareData.resourceMap.find(name); it != m_declareData.resourceMap.end())
     {
-        auto res = m_declareData.resources.at(m_declareData.resourceMap[name]);
-        APH_ASSERT(res->getType() == type);
+        auto res = m_declareData.resources[it->second];
+        if(res->getType() != type)
+        {
+            CM_LOG_ERR("render graph resource \"%s\" is used as both an image and a buffer.", name.getDebugName());
+            APH_ASSERT(false);
+        }
         return res;
     }
 
@@ -473,7 +507,7 @@ PassResource* RenderGraph::getResource(const std::string& name, PassResource::Ty
     return res;
 }
 
-void RenderGraph::execute(vk::Fence* pFence)
+void RenderGraph::execute(vk::Fence* pFence, FrameArena* pFrameArena)
 {
     APH_PROFILER_SCOPE();
     auto* queue = m_pDevice->getQueue(aph::QueueType::Graphics);
@@ -483,7 +517,9 @@ void RenderGraph::execute(vk::Fence* pFence)
         vk::Fence* frameFence = pFence ? pFence : m_buildData.frameFence;
         frameFence->reset();
 
-        APH_VR(queue->submit(m_buildData.frameSubmitInfos, frameFence));
+        std::pmr::memory_resource* pScratch =
+            pFrameArena ? pFrameArena->getResource() : std::pmr::get_default_resource();
+        APH_VR(queue->submit(m_buildData.frameSubmitInfos, frameFence, pScratch));
 
         if(m_buildData.pSwapchain)
         {
@@ -496,7 +532,7 @@ void RenderGraph::execute(vk::Fence* pFence)
                     auto pOutImage =
                         m_buildData.image[m_declareData.resources[m_declareData.resourceMap[m_declareData.backBuffer]]];
 
-                    pCopyCmd->insertBarrier({
+                    const std::array<vk::ImageBarrier, 2> copyBarriers{{
                         {
                             .pImage       = pOutImage,
                             .currentState = ResourceState::RenderTarget,
@@ -507,7 +543,8 @@ void RenderGraph::execute(vk::Fence* pFence)
                             .currentState = ResourceState::Undefined,
                             .newState     = ResourceState::CopyDest,
                         },
-                    });
+                    }};
+                    pCopyCmd->insertBarrier(copyBarriers);
 
                     if(pOutImage->getWidth() == pSwapchainImage->getWidth() &&
                        pOutImage->getHeight() == pSwapchainImage->getHeight() &&
@@ -522,7 +559,7 @@ void RenderGraph::execute(vk::Fence* pFence)
                         pCopyCmd->blitImage(pOutImage, pSwapchainImage);
                     }
 
-                    pCopyCmd->insertBarrier({
+                    const std::array<vk::ImageBarrier, 2> presentBarriers{{
                         {
                             .pImage       = pOutImage,
                             .currentState = ResourceState::Undefined,
@@ -533,12 +570,13 @@ void RenderGraph::execute(vk::Fence* pFence)
                             .currentState = ResourceState::CopyDest,
                             .newState     = ResourceState::Present,
                         },
-                    });
+                    }};
+                    pCopyCmd->insertBarrier(presentBarriers);
                 },
-                {m_buildData.renderSem}, {m_buildData.presentSem});
-        }
+                {&m_buildData.renderSem, 1}, {&m_buildData.presentSem, 1}, nullptr, pScratch);
 
-        APH_VR(m_buildData.pSwapchain->presentImage(queue, {m_buildData.presentSem}));
+            APH_VR(m_buildData.pSwapchain->presentImage(queue, {m_buildData.presentSem}));
+        }
 
         if(!pFence)
         {
@@ -560,7 +598,7 @@ vk::Buffer* RenderGraph::getBuildResource(PassBufferResource* pResource) const
     APH_ASSERT(m_buildData.buffer.contains(pResource));
     return m_buildData.buffer.at(pResource);
 }
-void RenderGraph::setBackBuffer(const std::string& backBuffer)
+void RenderGraph::setBackBuffer(StringId backBuffer)
 {
     APH_PROFILER_SCOPE();
     m_declareData.backBuffer = backBuffer;
@@ -568,10 +606,15 @@ void RenderGraph::setBackBuffer(const std::string& backBuffer)
 
 void RenderGraph::cleanup()
 {
+    // the recorded nodes point at the passes freed below
+    m_recordGraph.clear();
+
     {
         m_buildData.bufferBarriers.clear();
         m_buildData.imageBarriers.clear();
         m_buildData.frameSubmitInfos.clear();
+        m_buildData.submitSlots.clear();
+        m_buildData.sortedPasses.clear();
         for(auto* pass : m_declareData.passes)
         {
             m_buildData.passDependencyGraph[pass].clear();
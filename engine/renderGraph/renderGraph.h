@@ -1,8 +1,11 @@
 #ifndef APH_RDG_H_
 #define APH_RDG_H_
 
+#include "allocator/frameArena.h"
 #include "api/vulkan/device.h"
-#include "threads/taskManager.h"
+#include "common/inplaceFunction.h"
+#include "common/stringId.h"
+#include "threads/taskGraph.h"
 
 namespace aph
 {
@@ -103,20 +106,20 @@ class RenderPass
 public:
     RenderPass(RenderGraph* pRDG, uint32_t index, QueueType queueType, std::string_view name);
 
-    PassBufferResource* addUniformBufferInput(const std::string& name, vk::Buffer* pBuffer = nullptr);
-    PassBufferResource* addStorageBufferInput(const std::string& name, vk::Buffer* pBuffer = nullptr);
-    PassBufferResource* addBufferOutput(const std::string& name);
+    PassBufferResource* addUniformBufferInput(StringId name, vk::Buffer* pBuffer = nullptr);
+    PassBufferResource* addStorageBufferInput(StringId name, vk::Buffer* pBuffer = nullptr);
+    PassBufferResource* addBufferOutput(StringId name);
 
-    PassImageResource* addTextureInput(const std::string& name, vk::Image* pImage = nullptr);
-    PassImageResource* addTextureOutput(const std::string& name);
-    PassImageResource* setColorOutput(const std::string& name, const PassImageInfo& info);
-    PassImageResource* setDepthStencilOutput(const std::string& name, const PassImageInfo& info);
+    PassImageResource* addTextureInput(StringId name, vk::Image* pImage = nullptr);
+    PassImageResource* addTextureOutput(StringId name);
+    PassImageResource* setColorOutput(StringId name, const PassImageInfo& info);
+    PassImageResource* setDepthStencilOutput(StringId name, const PassImageInfo& info);
 
-    using ExecuteCallBack           = std::function<void(vk::CommandBuffer*)>;
+    using ExecuteCallBack           = InplaceFunction<void(vk::CommandBuffer*)>;
     using ClearDepthStencilCallBack = std::function<bool(VkClearDepthStencilValue*)>;
     using ClearColorCallBack        = std::function<bool(uint32_t, VkClearColorValue*)>;
 
-    void recordExecute(ExecuteCallBack&& cb) { m_executeCB = cb; }
+    void recordExecute(ExecuteCallBack&& cb) { m_executeCB = std::move(cb); }
     void recordClear(ClearColorCallBack&& cb) { m_clearColorCB = cb; }
     void recordDepthStencil(ClearDepthStencilCallBack&& cb) { m_clearDepthStencilCB = cb; }
 
@@ -154,37 +157,41 @@ public:
     RenderGraph(vk::Device* pDevice);
     ~RenderGraph();
 
-    RenderPass* createPass(const std::string& name, QueueType queueType);
-    RenderPass* getPass(const std::string& name);
+    // names are compared as StringIds, literals and strings convert implicitly, "name"_sid hashes at compile time
+    RenderPass* createPass(std::string_view name, QueueType queueType);
+    RenderPass* getPass(StringId name);
 
-    PassResource* importResource(const std::string& name, vk::Image* pImage);
-    PassResource* importResource(const std::string& name, vk::Buffer* pBuffer);
-    PassResource* getResource(const std::string& name, PassResource::Type type);
-    bool          hasResource(const std::string& name) const { return m_declareData.resourceMap.contains(name); }
+    PassResource* importResource(StringId name, vk::Image* pImage);
+    PassResource* importResource(StringId name, vk::Buffer* pBuffer);
+    PassResource* getResource(StringId name, PassResource::Type type);
+    bool          hasResource(StringId name) const { return m_declareData.resourceMap.contains(name); }
     vk::Image*    getBuildResource(PassImageResource* pResource) const;
     vk::Buffer*   getBuildResource(PassBufferResource* pResource) const;
 
-    void setBackBuffer(const std::string& backBuffer);
+    void setBackBuffer(StringId backBuffer);
 
-    void build(vk::SwapChain* pSwapChain = nullptr);
-    void execute(vk::Fence* pFence = nullptr);
+    // false if the passes depend on each other in a cycle, execute() then only signals the fence
+    bool build(vk::SwapChain* pSwapChain = nullptr);
+    void execute(vk::Fence* pFence = nullptr, FrameArena* pFrameArena = nullptr);
     void cleanup();
 
 private:
     vk::Device* m_pDevice     = {};
-    TaskManager m_taskManager = {5, "Render Graph"};
+    // one node per pass and no edges, every pass records its own command buffer in parallel and the pass order is
+    // applied at submit. Kept across builds and only recorded again when passes were added
+    TaskGraph   m_recordGraph = {"record passes", TaskPriority::Critical};
 
     struct
     {
-        std::string backBuffer = {};
+        StringId backBuffer = {};
 
-        SmallVector<RenderPass*>          passes;
-        HashMap<std::string, std::size_t> passMap;
+        SmallVector<RenderPass*>       passes;
+        HashMap<StringId, std::size_t> passMap;
 
-        SmallVector<PassBufferResource*>  bufferResources;
-        SmallVector<PassImageResource*>   imageResources;
-        SmallVector<PassResource*>        resources;
-        HashMap<std::string, std::size_t> resourceMap;
+        SmallVector<PassBufferResource*> bufferResources;
+        SmallVector<PassImageResource*>  imageResources;
+        SmallVector<PassResource*>       resources;
+        HashMap<StringId, std::size_t>   resourceMap;
     } m_declareData;
 
     struct
@@ -205,8 +212,9 @@ private:
         vk::Semaphore* presentSem = {};
         vk::Semaphore* renderSem  = {};
 
+        // submit slot of every pass indexed by RenderPass::getIndex(), a pass comes after the passes it reads from
+        std::vector<uint32_t>            submitSlots;
         std::vector<vk::QueueSubmitInfo> frameSubmitInfos{};
-        std::mutex                       submitLock;
 
     } m_buildData;
 
@@ -155,6 +155,7 @@ Renderer::Renderer(const RenderConfig& config) : m_config(config)
         {
             fence = m_pDevice->acquireFence(true);
         }
+        m_pFrameArena = std::make_unique<FrameArena>(m_config.maxFrames);
     }
 
     // init resource loader
@@ -217,20 +218,22 @@ void Renderer::recordGraph(std::function<void(RenderGraph*)>&& func)
     APH_PROFILER_SCOPE();
     for(auto& pGraph : m_frameGraph)
     {
-        auto taskGroup = m_taskManager.createTaskGroup("frame graph recording");
+        auto taskGroup = m_taskContext.createTaskGroup("frame graph recording");
         taskGroup->addTask([this, &pGraph, func]() {
             func(pGraph.get());
             pGraph->build(m_pSwapChain);
         });
-        m_taskManager.submit(taskGroup);
+        m_taskContext.submit(taskGroup);
     }
-    m_taskManager.wait();
+    m_taskContext.wait();
 }
 void Renderer::render()
 {
     APH_PROFILER_SCOPE();
     m_frameIdx = (m_frameIdx + 1) % m_config.maxFrames;
     m_frameFence[m_frameIdx]->wait();
-    m_frameGraph[m_frameIdx]->execute(m_frameFence[m_frameIdx]);
+    // the fence covers everything the frame allocated last time around
+    m_pFrameArena->beginFrame(m_frameIdx);
+    m_frameGraph[m_frameIdx]->execute(m_frameFence[m_frameIdx], m_pFrameArena.get());
 }
 }  // namespace aph::vk
@@ -1,6 +1,7 @@
 #ifndef VULKAN_RENDERER_H_
 #define VULKAN_RENDERER_H_
 
+#include "allocator/frameArena.h"
 #include "api/vulkan/device.h"
 #include "renderGraph/renderGraph.h"
 #include "resource/resourceLoader.h"
@@ -57,6 +58,7 @@ public:
     Device*         getDevice() const { return m_pDevice.get(); }
     UI*             getUI() const { return m_pUI.get(); }
     WSI*            getWSI() const { return m_wsi.get(); }
+    FrameArena*     getFrameArena() const { return m_pFrameArena.get(); }
 
     void recordGraph(std::function<void(RenderGraph*)>&& func);
     void render();
@@ -70,12 +72,13 @@ protected:
 protected:
     std::vector<std::unique_ptr<RenderGraph>> m_frameGraph;
     std::vector<Fence*>                       m_frameFence;
+    std::unique_ptr<FrameArena>               m_pFrameArena;
     uint32_t                                  m_frameIdx = {};
 
 protected:
     Instance*                       m_pInstance   = {};
     SwapChain*                      m_pSwapChain  = {};
-    TaskManager                     m_taskManager = {5, "renderer"};
+    TaskContext                     m_taskContext = {"renderer", TaskPriority::Critical};
     std::unique_ptr<ResourceLoader> m_pResourceLoader;
     std::unique_ptr<Device>         m_pDevice = {};
     std::unique_ptr<UI>             m_pUI     = {};
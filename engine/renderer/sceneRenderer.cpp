@@ -606,7 +606,7 @@ void SceneRenderer::_initGpuResources()
 
     // create index buffer
     {
-        auto                indicesList = m_scene->getIndices();
+        const auto&         indicesList = m_scene->getIndices();
         aph::BufferLoadInfo loadInfo{
             .data       = indicesList.data(),
             .createInfo = {.size  = static_cast<uint32_t>(indicesList.size() * sizeof(indicesList[0])),
@@ -616,7 +616,7 @@ void SceneRenderer::_initGpuResources()
 
     // create vertex buffer
     {
-        auto                verticesList = m_scene->getVertices();
+        const auto&         verticesList = m_scene->getVertices();
         aph::BufferLoadInfo loadInfo{
             .data       = verticesList.data(),
             .createInfo = {.size  = static_cast<uint32_t>(verticesList.size() * sizeof(verticesList[0])),
@@ -13,16 +13,20 @@
 #include "stb/stb_image.h"
 #include "tiny_gltf.h"
 
+#include "allocator/hugePageArena.h"
 #include "filesystem/filesystem.h"
 
 #include "shaderReflector.h"
 
 namespace loader::image
 {
-inline std::shared_ptr<aph::ImageInfo> loadImageFromFile(std::string_view path, bool isFlipY = false)
+inline std::shared_ptr<aph::ImageInfo> loadImageFromFile(
+    std::string_view path, bool isFlipY = false,
+    std::pmr::memory_resource* pResource = std::pmr::get_default_resource())
 {
     APH_PROFILER_SCOPE();
-    auto image = std::make_shared<aph::ImageInfo>();
+    // the pixels have to be constructed with the resource, assigning would keep the default one
+    auto image = std::make_shared<aph::ImageInfo>(aph::ImageInfo{.data = std::pmr::vector<uint8_t>{pResource}});
     stbi_set_flip_vertically_on_load(isFlipY);
     int      width, height, channels;
     uint8_t* img = stbi_load(path.data(), &width, &height, &channels, 0);
@@ -38,12 +42,10 @@ inline std::shared_ptr<aph::ImageInfo> loadImageFromFile(std::string_view path,
     image->data.resize(width * height * 4);
     if(channels == 3)
     {
-        std::vector<uint8_t> rgba(image->data.size());
         for(std::size_t i = 0; i < width * height; ++i)
         {
-            memcpy(&rgba[4 * i], &img[3 * i], 3);
+            memcpy(&image->data[4 * i], &img[3 * i], 3);
         }
-        memcpy(image->data.data(), rgba.data(), image->data.size());
     }
     else
     {
@@ -65,17 +67,19 @@ inline std::array<std::shared_ptr<aph::ImageInfo>, 6> loadSkyboxFromFile(std::ar
     return skyboxImages;
 }
 
-inline bool loadKTX(const std::filesystem::path& path, aph::vk::ImageCreateInfo& outCI, std::vector<uint8_t>& data)
+inline bool loadKTX(const std::filesystem::path& path, aph::vk::ImageCreateInfo& outCI,
+                    std::pmr::vector<uint8_t>& data)
 {
     APH_PROFILER_SCOPE();
     APH_ASSERT(false);
     return false;
 }
 
-inline bool loadPNGJPG(const std::filesystem::path& path, aph::vk::ImageCreateInfo& outCI, std::vector<uint8_t>& data)
+inline bool loadPNGJPG(const std::filesystem::path& path, aph::vk::ImageCreateInfo& outCI,
+                       std::pmr::vector<uint8_t>& data)
 {
     APH_PROFILER_SCOPE();
-    auto img = loadImageFromFile(path.c_str());
+    auto img = loadImageFromFile(path.c_str(), false, data.get_allocator().resource());
 
     if(img == nullptr)
     {
@@ -92,7 +96,8 @@ inline bool loadPNGJPG(const std::filesystem::path& path, aph::vk::ImageCreateIn
 
     textureCI.format = aph::Format::RGBA8_UNORM;
 
-    data = img->data;
+    // same resource on both sides, this takes over the buffer
+    data = std::move(img->data);
 
     return true;
 }
@@ -372,31 +377,39 @@ ImageContainerType GetImageContainerType(const std::filesystem::path& path)
 
 ResourceLoader::ResourceLoader(const ResourceLoaderCreateInfo& createInfo) :
     m_createInfo(createInfo),
-    m_pDevice(createInfo.pDevice)
+    m_pDevice(createInfo.pDevice),
+    m_pBlobResource(createInfo.useHugePages ? memory::HugePageArena::GetInstance().getResource()
+                                            : std::pmr::get_default_resource())
 {
     m_pQueue = m_pDevice->getQueue(QueueType::Transfer);
 }
 
-ResourceLoader::~ResourceLoader() = default;
+ResourceLoader::~ResourceLoader()
+{
+    wait();
+}
 
 void ResourceLoader::cleanup()
 {
     APH_PROFILER_SCOPE();
-    for(const auto& [_, shaderCache] : m_shaderCaches)
-    {
+    // pending loads may still add shaders to the cache
+    wait();
+    m_shaderCaches.forEach([this](const auto&, const auto& shaderCache) {
         for(const auto& [_, shader] : shaderCache)
         {
             m_pDevice->destroy(shader);
         }
-    }
+    });
+    m_shaderCaches.clear();
 }
 
 Result ResourceLoader::load(const ImageLoadInfo& info, vk::Image** ppImage)
 {
     APH_PROFILER_SCOPE();
-    std::filesystem::path path;
-    std::vector<uint8_t>  data;
-    vk::ImageCreateInfo   ci;
+    std::filesystem::path     path;
+    std::pmr::vector<uint8_t> decoded{m_pBlobResource};
+    std::span<const uint8_t>  data;
+    vk::ImageCreateInfo       ci;
     ci = info.createInfo;
 
     if(std::holds_alternative<std::string>(info.data))
@@ -410,25 +423,27 @@ Result ResourceLoader::load(const ImageLoadInfo& info, vk::Image** ppImage)
         {
         case ImageContainerType::Ktx:
         {
-            loader::image::loadKTX(path, ci, data);
+            loader::image::loadKTX(path, ci, decoded);
         }
         break;
         case ImageContainerType::Png:
         case ImageContainerType::Jpg:
         {
-            loader::image::loadPNGJPG(path, ci, data);
+            loader::image::loadPNGJPG(path, ci, decoded);
         }
         break;
         case ImageContainerType::Default:
             APH_ASSERT(false);
             return {Result::RuntimeError, "Unsupported image type."};
         }
+        data = decoded;
     }
     else if(std::holds_alternative<ImageInfo>(info.data))
     {
-        auto img  = std::get<ImageInfo>(info.data);
-        data      = img.data;
-        ci.extent = {img.width, img.height, 1};
+        // upload straight from the caller's pixels instead of copying the blob
+        const auto& img = std::get<ImageInfo>(info.data);
+        data            = img.data;
+        ci.extent       = {img.width, img.height, 1};
     }
 
     // Load texture from image buffer
@@ -574,51 +589,56 @@ Result ResourceLoader::load(const ShaderLoadInfo& info, vk::ShaderProgram** ppPr
 
     for(const auto& [path, requiredStages] : requiredStageMaps)
     {
-        if(m_shaderCaches.contains(path.string()))
-        {
-            const auto& shaderCache = m_shaderCaches[path.string()];
-            for(const auto& [stage, entryPoint] : requiredStages)
-            {
-                APH_ASSERT(!shaderCache.contains(stage));
-                requiredShaderList[stage] = shaderCache.at(stage);
-            }
-            continue;
-        }
-
-        if(path.extension() == ".spv")
-        {
-            // TODO multi shader stage single spv binary support
-            ShaderStage stage                  = requiredStages.cbegin()->first;
-            vk::Shader* shader                 = loadShader(loader::shader::loadSpvFromFile(path.c_str()), stage);
-            requiredShaderList[stage]   = shader;
-            m_shaderCaches[path][stage] = shader;
-        }
-        else if(path.extension() == ".slang")
+        // loader workers may ask for the same file at once, only the first one compiles it. A failure is thrown so
+        // every caller waiting on that compile sees it and nothing is cached, the file may be fixed and loaded again
+        HashMap<ShaderStage, vk::Shader*> shaderCache;
+        try
         {
-            auto spvCodeMap = loader::shader::loadSlangFromFile(path.c_str());
-            if(spvCodeMap.empty())
-            {
-                return {Result::RuntimeError, "Failed to load slang shader from file."};
-            }
-            for(const auto& [stage, spvInfo] : spvCodeMap)
-            {
-                const auto& [entryPointName, spv] = spvInfo;
-                APH_ASSERT(!requiredShaderList.contains(stage));
-
-                vk::Shader* shader          = loadShader(spv, stage, entryPointName);
-                m_shaderCaches[path][stage] = shader;
+            shaderCache = m_shaderCaches.getOrCreate(path.string(), [&]() {
+                HashMap<ShaderStage, vk::Shader*> shaders;
+                if(path.extension() == ".spv")
+                {
+                    // TODO multi shader stage single spv binary support
+                    ShaderStage stage = requiredStages.cbegin()->first;
+                    shaders[stage]    = loadShader(loader::shader::loadSpvFromFile(path.c_str()), stage);
+                }
+                else if(path.extension() == ".slang")
+                {
+                    for(const auto& [stage, spvInfo] : loader::shader::loadSlangFromFile(path.c_str()))
+                    {
+                        const auto& [entryPointName, spv] = spvInfo;
+                        shaders[stage]                    = loadShader(spv, stage, entryPointName);
+                    }
+                }
+                else
+                {
+                    CM_LOG_ERR("Unsupported shader format: %s", path.extension().string());
+                }
 
-                if(requiredStages.contains(stage))
+                if(shaders.empty())
                 {
-                    requiredShaderList[stage] = shader;
+                    throw std::runtime_error("no shader stage compiled from " + path.string());
                 }
-            }
+                return shaders;
+            });
         }
-        else
+        catch(const std::runtime_error& e)
         {
-            CM_LOG_ERR("Unsupported shader format: %s", path.extension().string());
+            CM_LOG_ERR("%s", e.what());
             APH_ASSERT(false);
-            return {Result::RuntimeError, "Unsupported shader format."};
+            return {Result::RuntimeError, "Failed to load shader from file."};
+        }
+
+        for(const auto& [stage, entryPoint] : requiredStages)
+        {
+            // the file may have been compiled for a caller that asked for other stages
+            if(!shaderCache.contains(stage))
+            {
+                CM_LOG_ERR("Shader stage missing from %s", path.string());
+                APH_ASSERT(false);
+                return {Result::RuntimeError, "Failed to load shader from file."};
+            }
+            requiredShaderList[stage] = shaderCache.at(stage);
         }
     }
 
@@ -1,7 +1,9 @@
 #ifndef RES_LOADER_H_
 #define RES_LOADER_H_
 
+#include "allocator/objectPool.h"
 #include "api/vulkan/device.h"
+#include "common/concurrentHashMap.h"
 #include "common/hash.h"
 #include "geometry.h"
 #include "threads/taskManager.h"
@@ -14,6 +16,8 @@ struct ResourceLoaderCreateInfo
     // TODO for debugging
     bool        isMultiThreads = false;
     vk::Device* pDevice        = {};
+    // decode images into memory::HugePageArena instead of the default heap
+    bool        useHugePages   = false;
 };
 
 enum class ImageContainerType
@@ -26,9 +30,9 @@ enum class ImageContainerType
 
 struct ImageInfo
 {
-    uint32_t             width  = {};
-    uint32_t             height = {};
-    std::vector<uint8_t> data   = {};
+    uint32_t                  width  = {};
+    uint32_t                  height = {};
+    std::pmr::vector<uint8_t> data   = {};
 };
 
 struct ImageLoadInfo
@@ -102,17 +106,22 @@ public:
 
     ~ResourceLoader();
 
+    // the resource is ready after wait(), a failed load is fatal like APH_VR on load()
     template <typename T_CreateInfo, typename T_Resource>
-    Result loadAsync(const T_CreateInfo& info, T_Resource** ppResource)
+    void loadAsync(T_CreateInfo info, T_Resource** ppResource)
     {
-        Result result    = Result::Success;
-        auto   taskGroup = m_taskManager.createTaskGroup("resource loader.");
-        taskGroup->addTask([this, info, ppResource, &result]() { result = load(info, ppResource); });
+        // the info lives in a pool until the task ran, the task itself fits into the inline task storage
+        auto& infoPool  = std::get<ThreadSafeObjectPool<T_CreateInfo>>(m_loadInfoPools);
+        auto* pInfo     = infoPool.allocate(std::move(info));
+        auto  taskGroup = m_taskContext.createTaskGroup("resource loader.");
+        taskGroup->addTask([this, &infoPool, pInfo, ppResource]() {
+            APH_VR(load(*pInfo, ppResource));
+            infoPool.free(pInfo);
+        });
         taskGroup->submit();
-        return result;
     }
 
-    void wait() { m_taskManager.wait(); }
+    void wait() { m_taskContext.wait(); }
 
     Result load(const ImageLoadInfo& info, vk::Image** ppImage);
     Result load(const BufferLoadInfo& info, vk::Buffer** ppBuffer);
@@ -126,14 +135,20 @@ private:
     void        writeBuffer(vk::Buffer* pBuffer, const void* data, MemoryRange range = {});
 
 private:
-    ResourceLoaderCreateInfo m_createInfo;
-    TaskManager              m_taskManager = {5, "Resource Loader"};
-    vk::Device*              m_pDevice     = {};
-    vk::Queue*               m_pQueue      = {};
+    ResourceLoaderCreateInfo   m_createInfo;
+    vk::Device*                m_pDevice       = {};
+    vk::Queue*                 m_pQueue        = {};
+    std::pmr::memory_resource* m_pBlobResource = {};
 
 private:
-    HashMap<std::string, HashMap<ShaderStage, vk::Shader*>> m_shaderCaches = {};
-    std::mutex                                              m_updateLock;
+    std::tuple<ThreadSafeObjectPool<ImageLoadInfo>, ThreadSafeObjectPool<BufferLoadInfo>,
+               ThreadSafeObjectPool<ShaderLoadInfo>, ThreadSafeObjectPool<GeometryLoadInfo>>
+                                                                      m_loadInfoPools;
+    ConcurrentHashMap<std::string, HashMap<ShaderStage, vk::Shader*>> m_shaderCaches;
+    std::mutex                                                        m_updateLock;
+
+    // declared last, pending loads still use the pools and the shader cache until it has waited for them
+    TaskContext m_taskContext = {"Resource Loader", TaskPriority::Background};
 };
 }  // namespace aph
 
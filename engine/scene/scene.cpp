@@ -2,6 +2,7 @@
 #include "common/assetManager.h"
 #include "common/common.h"
 #include "common/logger.h"
+#include "allocator/hugePageArena.h"
 
 #define TINYGLTF_IMPLEMENTATION
 #define TINYGLTF_NO_INCLUDE_STB_IMAGE
@@ -11,13 +12,14 @@
 
 namespace aph::gltf
 {
-void loadImages(std::vector<std::shared_ptr<ImageInfo>>& images, tinygltf::Model& input)
+void loadImages(std::vector<std::shared_ptr<ImageInfo>>& images, tinygltf::Model& input,
+                std::pmr::memory_resource* pResource)
 {
     images.clear();
     for(auto& glTFImage : input.images)
     {
         // We convert RGB-only images to RGBA, as most devices don't support RGB-formats in Vulkan
-        auto newImage    = std::make_shared<ImageInfo>();
+        auto newImage    = std::make_shared<ImageInfo>(ImageInfo{.data = std::pmr::vector<uint8_t>{pResource}});
         newImage->width  = glTFImage.width;
         newImage->height = glTFImage.height;
         newImage->data.resize(glTFImage.width * glTFImage.height * 4);
@@ -94,7 +96,7 @@ void loadMaterials(std::vector<Material>& materials, tinygltf::Model& input, uin
     }
 }
 
-void loadNodes(Scene* scene, std::vector<uint8_t>& verticesList, std::vector<uint8_t>& indicesList,
+void loadNodes(Scene* scene, std::pmr::vector<uint8_t>& verticesList, std::pmr::vector<uint8_t>& indicesList,
                const tinygltf::Node& inputNode, const tinygltf::Model& input, SceneNode* parent,
                uint32_t materialOffset, bool unifiedIndexType = true)
 {
@@ -306,13 +308,22 @@ void loadNodes(Scene* scene, std::vector<uint8_t>& verticesList, std::vector<uin
 namespace aph
 {
 
-std::unique_ptr<Scene> Scene::Create(SceneType type)
+Scene::Scene(std::pmr::memory_resource* pBlobResource) :
+    m_pBlobResource(pBlobResource),
+    m_indices(pBlobResource),
+    m_vertices(pBlobResource)
+{
+}
+
+std::unique_ptr<Scene> Scene::Create(SceneType type, bool useHugePages)
 {
     switch(type)
     {
     case SceneType::DEFAULT:
     {
-        auto instance{std::unique_ptr<Scene>(new Scene())};
+        auto* pBlobResource = useHugePages ? memory::HugePageArena::GetInstance().getResource()
+                                           : std::pmr::get_default_resource();
+        auto  instance{std::unique_ptr<Scene>(new Scene(pBlobResource))};
         instance->m_rootNode = std::make_unique<SceneNode>(nullptr);
         return instance;
     }
@@ -382,7 +393,7 @@ SceneNode* Scene::createMeshesFromFile(const std::string& path, SceneNode* paren
         const uint32_t                          materialOffset = m_materials.size();
         std::vector<std::shared_ptr<ImageInfo>> images;
         std::vector<Material>                   materials;
-        gltf::loadImages(images, inputModel);
+        gltf::loadImages(images, inputModel, m_pBlobResource);
         gltf::loadMaterials(materials, inputModel, imageOffset);
         m_images.insert(m_images.cend(), std::make_move_iterator(images.cbegin()),
                         std::make_move_iterator(images.cend()));
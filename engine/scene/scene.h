@@ -24,10 +24,11 @@ enum class SceneType
 class Scene
 {
 private:
-    Scene() = default;
+    explicit Scene(std::pmr::memory_resource* pBlobResource);
 
 public:
-    static std::unique_ptr<Scene> Create(SceneType type);
+    // useHugePages: geometry and decoded images go to memory::HugePageArena
+    static std::unique_ptr<Scene> Create(SceneType type, bool useHugePages = false);
 
     Mesh*      createMesh();
     Light*     createDirLight(glm::vec3 dir, glm::vec3 color = glm::vec3(1.0f), float intensity = 1.0f);
@@ -43,8 +44,8 @@ public:
     Camera*    getCameraWithId(IdType id) { return m_cameras[id].get(); }
     Mesh*      getMeshWithId(IdType id) { return m_meshes[id].get(); }
 
-    std::vector<uint8_t>                    getIndices() const { return m_indices; }
-    std::vector<uint8_t>                    getVertices() const { return m_vertices; }
+    const std::pmr::vector<uint8_t>&        getIndices() const { return m_indices; }
+    const std::pmr::vector<uint8_t>&        getVertices() const { return m_vertices; }
     std::vector<Material>                   getMaterials() const { return m_materials; }
     std::vector<std::shared_ptr<ImageInfo>> getImages() const { return m_images; }
     glm::vec3                               getAmbient() { return m_ambient; }
@@ -61,8 +62,9 @@ private:
     std::unique_ptr<SceneNode> m_rootNode = {};
     Camera*                    m_camera   = {};
 
-    std::vector<uint8_t> m_indices  = {};
-    std::vector<uint8_t> m_vertices = {};
+    std::pmr::memory_resource* m_pBlobResource = {};
+    std::pmr::vector<uint8_t>  m_indices;
+    std::pmr::vector<uint8_t>  m_vertices;
 
     std::unordered_map<IdType, std::unique_ptr<Camera>> m_cameras = {};
     std::unordered_map<IdType, std::unique_ptr<Light>>  m_lights  = {};
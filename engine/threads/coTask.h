@@ -0,0 +1,188 @@
+#ifndef APH_CO_TASK_H_
+#define APH_CO_TASK_H_
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+#include "common/common.h"
+#include "common/inplaceFunction.h"
+
+namespace aph
+{
+template <typename T = void>
+class CoTask;
+
+namespace detail
+{
+struct CoPromiseBase
+{
+    struct FinalAwaiter
+    {
+        bool await_ready() const noexcept { return false; }
+
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+        {
+            CoPromiseBase& promise = handle.promise();
+            if(promise.m_continuation)
+            {
+                return promise.m_continuation;
+            }
+
+            // detached coroutine owned by a task group, nobody reads the result so release the frame here and
+            // hand a failure over to the group
+            auto onComplete = std::move(promise.m_onComplete);
+            auto exception  = std::move(promise.m_exception);
+            handle.destroy();
+            if(onComplete)
+            {
+                onComplete(std::move(exception));
+            }
+            else if(exception)
+            {
+                std::terminate();
+            }
+            return std::noop_coroutine();
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    FinalAwaiter        final_suspend() const noexcept { return {}; }
+    void                unhandled_exception() noexcept { m_exception = std::current_exception(); }
+
+    void rethrowIfFailed() const
+    {
+        if(m_exception)
+        {
+            std::rethrow_exception(m_exception);
+        }
+    }
+
+    std::coroutine_handle<>                   m_continuation = {};
+    std::exception_ptr                        m_exception    = {};
+    InplaceFunction<void(std::exception_ptr)> m_onComplete   = {};
+};
+
+template <typename T>
+struct CoPromise : CoPromiseBase
+{
+    CoTask<T> get_return_object() noexcept;
+
+    template <typename U>
+    void return_value(U&& value)
+    {
+        m_value.emplace(std::forward<U>(value));
+    }
+
+    T result()
+    {
+        rethrowIfFailed();
+        return std::move(*m_value);
+    }
+
+    std::optional<T> m_value;
+};
+
+template <>
+struct CoPromise<void> : CoPromiseBase
+{
+    CoTask<void> get_return_object() noexcept;
+
+    void return_void() const noexcept {}
+    void result() const { rethrowIfFailed(); }
+};
+}  // namespace detail
+
+/*
+ * Lazily started coroutine task.
+ *
+ * A CoTask starts running when it is awaited by another coroutine or when it is added to a TaskGroup. Inside the
+ * coroutine, co_await on a TaskGroup suspends until the group completes and resumes on one of the group's workers,
+ * so waiting never blocks a worker thread. An exception escaping a CoTask added to a group is rethrown by co_await
+ * and wait() on that group.
+ */
+template <typename T>
+class [[nodiscard]] CoTask
+{
+public:
+    using promise_type = detail::CoPromise<T>;
+    using handle_type  = std::coroutine_handle<promise_type>;
+
+    CoTask() = default;
+    explicit CoTask(handle_type handle) noexcept : m_handle(handle) {}
+
+    CoTask(CoTask&& other) noexcept : m_handle(std::exchange(other.m_handle, {})) {}
+    CoTask& operator=(CoTask&& other) noexcept
+    {
+        if(this != &other)
+        {
+            if(m_handle)
+            {
+                m_handle.destroy();
+            }
+            m_handle = std::exchange(other.m_handle, {});
+        }
+        return *this;
+    }
+
+    CoTask(const CoTask&)            = delete;
+    CoTask& operator=(const CoTask&) = delete;
+
+    ~CoTask()
+    {
+        if(m_handle)
+        {
+            m_handle.destroy();
+        }
+    }
+
+    bool done() const noexcept { return !m_handle || m_handle.done(); }
+
+    // gives up ownership of the coroutine frame, which then destroys itself when it finishes
+    handle_type release() noexcept { return std::exchange(m_handle, {}); }
+
+    // awaiting an empty (moved-from or released) task is an error
+    auto operator co_await() noexcept
+    {
+        APH_ASSERT(m_handle);
+        struct Awaiter
+        {
+            handle_type handle;
+
+            bool await_ready() const noexcept { return handle.done(); }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> continuation) noexcept
+            {
+                handle.promise().m_continuation = continuation;
+                return handle;
+            }
+
+            T await_resume() { return handle.promise().result(); }
+        };
+        return Awaiter{m_handle};
+    }
+
+private:
+    handle_type m_handle = {};
+};
+
+namespace detail
+{
+template <typename T>
+CoTask<T> CoPromise<T>::get_return_object() noexcept
+{
+    return CoTask<T>{std::coroutine_handle<CoPromise<T>>::from_promise(*this)};
+}
+
+inline CoTask<void> CoPromise<void>::get_return_object() noexcept
+{
+    return CoTask<void>{std::coroutine_handle<CoPromise<void>>::from_promise(*this)};
+}
+}  // namespace detail
+}  // namespace aph
+
+#endif  // APH_CO_TASK_H_
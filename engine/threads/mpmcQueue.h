@@ -0,0 +1,377 @@
+#ifndef APH_MPMC_QUEUE_H_
+#define APH_MPMC_QUEUE_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <optional>
+#include <span>
+#include <utility>
+
+#include "common/common.h"
+#include "threadUtils.h"
+
+namespace aph
+{
+/*
+ * Bounded lock-free multi-producer multi-consumer FIFO queue.
+ *
+ * Every cell carries a sequence counter that tells producers and consumers whether the cell is ready for them,
+ * so a push or pop costs one CAS on the shared cursor (Dmitry Vyukov's bounded MPMC queue). Batch operations
+ * claim a run of cells with a single CAS.
+ *
+ * push() and pop() block while the queue is full or empty: they spin briefly and then sleep with
+ * std::atomic::wait. The other side only pays for a notify when somebody is actually sleeping. close() ends a
+ * pipeline, blocked and later pushes fail, pops drain what is left and then return std::nullopt.
+ */
+template <typename T>
+class MPMCQueue
+{
+public:
+    explicit MPMCQueue(std::size_t capacity = 1024)
+    {
+        std::size_t cap = 2;
+        while(cap < capacity)
+        {
+            cap <<= 1;
+        }
+        m_mask  = cap - 1;
+        m_cells = std::make_unique<Cell[]>(cap);
+        for(std::size_t i = 0; i < cap; ++i)
+        {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~MPMCQueue()
+    {
+        while(popCell())
+        {
+        }
+    }
+
+    MPMCQueue(const MPMCQueue&)            = delete;
+    MPMCQueue& operator=(const MPMCQueue&) = delete;
+
+    // the value is only moved from when the push succeeds, pushes fail once the queue is closed
+    [[nodiscard]] bool tryPush(T&& value) { return emplace(std::move(value)); }
+    [[nodiscard]] bool tryPush(const T& value) { return emplace(value); }
+
+    [[nodiscard]] std::optional<T> tryPop()
+    {
+        std::optional<T> result = popCell();
+        if(result)
+        {
+            wakeWaiters(m_pushWaiters, m_popEpoch);
+        }
+        return result;
+    }
+
+    // moves the leading values into the queue as long as there is room, returns how many were pushed
+    [[nodiscard]] std::size_t tryPushBatch(std::span<T> values)
+    {
+        if(m_closed.load(std::memory_order_acquire))
+        {
+            return 0;
+        }
+
+        std::size_t pos;
+        std::size_t count = claimRun(m_enqueuePos, values.size(), 0, pos);
+        for(std::size_t i = 0; i < count; ++i)
+        {
+            Cell& cell = m_cells[(pos + i) & m_mask];
+            new(cell.storage) T(std::move(values[i]));
+            cell.sequence.store(pos + i + 1, std::memory_order_release);
+        }
+        if(count)
+        {
+            wakeWaiters(m_popWaiters, m_pushEpoch);
+        }
+        return count;
+    }
+
+    // moves up to out.size() values out of the queue, returns how many were popped
+    [[nodiscard]] std::size_t tryPopBatch(std::span<T> out)
+    {
+        std::size_t pos;
+        std::size_t count = claimRun(m_dequeuePos, out.size(), 1, pos);
+        for(std::size_t i = 0; i < count; ++i)
+        {
+            Cell& cell = m_cells[(pos + i) & m_mask];
+            T*    slot = cell.ptr();
+            out[i]     = std::move(*slot);
+            slot->~T();
+            cell.sequence.store(pos + i + m_mask + 1, std::memory_order_release);
+        }
+        if(count)
+        {
+            wakeWaiters(m_pushWaiters, m_popEpoch);
+        }
+        return count;
+    }
+
+    // blocks while the queue is full, returns false if the queue is closed
+    bool push(T&& value)
+    {
+        return blockUntil([&]() { return tryPush(std::move(value)); }, m_pushWaiters, m_popEpoch);
+    }
+    bool push(const T& value)
+    {
+        return blockUntil([&]() { return tryPush(value); }, m_pushWaiters, m_popEpoch);
+    }
+
+    // blocks while the queue is empty, std::nullopt once the queue is closed and drained
+    [[nodiscard]] std::optional<T> pop()
+    {
+        std::optional<T> value;
+        if(!blockUntil([&]() { return (value = tryPop()).has_value(); }, m_popWaiters, m_pushEpoch))
+        {
+            value = tryPop();
+        }
+        return value;
+    }
+
+    // pushes every value, blocking while the queue is full, returns how many were pushed before it was closed
+    std::size_t pushBatch(std::span<T> values)
+    {
+        std::size_t pushed = 0;
+        blockUntil(
+            [&]() {
+                pushed += tryPushBatch(values.subspan(pushed));
+                return pushed == values.size();
+            },
+            m_pushWaiters, m_popEpoch);
+        return pushed;
+    }
+
+    // blocks until at least one value is available, returns 0 once the queue is closed and drained
+    [[nodiscard]] std::size_t popBatch(std::span<T> out)
+    {
+        std::size_t count = 0;
+        if(!blockUntil([&]() { return (count = tryPopBatch(out)) != 0; }, m_popWaiters, m_pushEpoch))
+        {
+            count = tryPopBatch(out);
+        }
+        return count;
+    }
+
+    // wakes every blocked thread, pushes fail from now on
+    void close()
+    {
+        m_closed.store(true, std::memory_order_seq_cst);
+        for(auto* epoch : {&m_pushEpoch, &m_popEpoch})
+        {
+            epoch->fetch_add(1, std::memory_order_release);
+            epoch->notify_all();
+        }
+    }
+
+    [[nodiscard]] bool isClosed() const { return m_closed.load(std::memory_order_acquire); }
+
+    [[nodiscard]] bool empty() const
+    {
+        return m_enqueuePos.load(std::memory_order_acquire) == m_dequeuePos.load(std::memory_order_acquire);
+    }
+
+    // approximate while other threads push or pop
+    [[nodiscard]] std::size_t size() const
+    {
+        std::size_t dequeuePos = m_dequeuePos.load(std::memory_order_relaxed);
+        std::size_t enqueuePos = m_enqueuePos.load(std::memory_order_relaxed);
+        return enqueuePos > dequeuePos ? enqueuePos - dequeuePos : 0;
+    }
+
+    [[nodiscard]] std::size_t capacity() const { return m_mask + 1; }
+
+private:
+    static constexpr uint32_t BLOCKING_SPIN_COUNT = 64;
+
+    std::optional<T> popCell()
+    {
+        Cell*       cell;
+        std::size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+        for(;;)
+        {
+            cell             = &m_cells[pos & m_mask];
+            std::size_t seq  = cell->sequence.load(std::memory_order_acquire);
+            auto        diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+            if(diff == 0)
+            {
+                if(m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if(diff < 0)
+            {
+                // empty
+                return std::nullopt;
+            }
+            else
+            {
+                pos = m_dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        T*               slot = cell->ptr();
+        std::optional<T> result{std::move(*slot)};
+        slot->~T();
+        cell->sequence.store(pos + m_mask + 1, std::memory_order_release);
+        return result;
+    }
+
+    // claims up to maxCount consecutive cells that are ready at cursor, a cell at position p is ready when its
+    // sequence is p + offset (0 for producers, 1 for consumers), returns the count and the first position
+    std::size_t claimRun(std::atomic<std::size_t>& cursor, std::size_t maxCount, std::size_t offset, std::size_t& pos)
+    {
+        maxCount = std::min(maxCount, capacity());
+        pos      = cursor.load(std::memory_order_relaxed);
+        while(maxCount)
+        {
+            std::size_t count = 0;
+            for(; count < maxCount; ++count)
+            {
+                std::size_t seq = m_cells[(pos + count) & m_mask].sequence.load(std::memory_order_acquire);
+                if(seq != pos + count + offset)
+                {
+                    break;
+                }
+            }
+
+            if(count == 0)
+            {
+                std::size_t seq  = m_cells[pos & m_mask].sequence.load(std::memory_order_acquire);
+                auto        diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + offset);
+                if(diff < 0)
+                {
+                    // full for producers, empty for consumers
+                    return 0;
+                }
+                pos = cursor.load(std::memory_order_relaxed);
+                continue;
+            }
+
+            if(cursor.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed))
+            {
+                return count;
+            }
+        }
+        return 0;
+    }
+
+    // retries attempt until it succeeds, sleeping on epoch in between, returns false if the queue got closed
+    template <typename Attempt>
+    bool blockUntil(Attempt&& attempt, std::atomic_uint32_t& waiters, std::atomic_uint32_t& epoch)
+    {
+        for(uint32_t spin = 0; spin < BLOCKING_SPIN_COUNT; ++spin)
+        {
+            if(m_closed.load(std::memory_order_acquire))
+            {
+                return false;
+            }
+            if(attempt())
+            {
+                return true;
+            }
+            thread::cpuRelax();
+        }
+
+        for(;;)
+        {
+            uint32_t current = epoch.load(std::memory_order_acquire);
+            // announce the waiter before the last attempt, see wakeWaiters()
+            waiters.fetch_add(1, std::memory_order_seq_cst);
+            if(m_closed.load(std::memory_order_seq_cst))
+            {
+                waiters.fetch_sub(1, std::memory_order_relaxed);
+                return false;
+            }
+            bool done = attempt();
+            if(!done)
+            {
+                epoch.wait(current, std::memory_order_acquire);
+            }
+            waiters.fetch_sub(1, std::memory_order_relaxed);
+            if(done)
+            {
+                return true;
+            }
+        }
+    }
+
+    void wakeWaiters(std::atomic_uint32_t& waiters, std::atomic_uint32_t& epoch)
+    {
+        // either a waiter sees the cell we just published or we see the waiter
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if(waiters.load(std::memory_order_relaxed))
+        {
+            epoch.fetch_add(1, std::memory_order_release);
+            epoch.notify_all();
+        }
+    }
+
+    template <typename U>
+    bool emplace(U&& value)
+    {
+        if(m_closed.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        Cell*       cell;
+        std::size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+        for(;;)
+        {
+            cell             = &m_cells[pos & m_mask];
+            std::size_t seq  = cell->sequence.load(std::memory_order_acquire);
+            auto        diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+            if(diff == 0)
+            {
+                if(m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if(diff < 0)
+            {
+                // full
+                return false;
+            }
+            else
+            {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        new(cell->storage) T(std::forward<U>(value));
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        wakeWaiters(m_popWaiters, m_pushEpoch);
+        return true;
+    }
+
+    struct Cell
+    {
+        std::atomic<std::size_t> sequence;
+        alignas(T) std::byte     storage[sizeof(T)];
+
+        T* ptr() { return std::launder(reinterpret_cast<T*>(storage)); }
+    };
+
+    std::unique_ptr<Cell[]> m_cells;
+    std::size_t             m_mask = 0;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> m_enqueuePos{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> m_dequeuePos{0};
+
+    // blocked producers sleep on m_popEpoch, blocked consumers on m_pushEpoch
+    alignas(CACHE_LINE_SIZE) std::atomic_uint32_t m_pushWaiters{0};
+    std::atomic_uint32_t m_popWaiters{0};
+    std::atomic_uint32_t m_pushEpoch{0};
+    std::atomic_uint32_t m_popEpoch{0};
+    std::atomic_bool     m_closed{false};
+};
+}  // namespace aph
+
+#endif  // APH_MPMC_QUEUE_H_
@@ -0,0 +1,179 @@
+#include "taskGraph.h"
+#include "common/logger.h"
+
+namespace aph
+{
+TaskGraph::TaskGraph(const char* desc, TaskPriority priority, TaskManager* pManager) :
+    m_pManager(pManager),
+    m_desc(desc ? desc : "Untitled Graph"),
+    m_priority(priority)
+{
+}
+
+TaskGraph::~TaskGraph()
+{
+    clear();
+}
+
+TaskGraph::NodeId TaskGraph::addNode(TaskFunc&& func, const char* desc)
+{
+    APH_ASSERT(poll());
+
+    NodeId id   = m_nodes.size();
+    auto&  node = m_nodes.emplace_back(std::move(func));
+
+    node.pTask = m_pManager->m_taskPool.allocate(nullptr, [this, id]() { runNode(id); },
+                                                 desc ? desc : "Untitled Node", m_desc, m_priority);
+    node.pTask->m_persistent = true;
+
+    m_prepared = false;
+    return id;
+}
+
+void TaskGraph::addEdge(NodeId from, NodeId to)
+{
+    APH_ASSERT(poll());
+    APH_ASSERT(from < m_nodes.size() && to < m_nodes.size() && from != to);
+
+    m_nodes[from].successors.push_back(to);
+    m_nodes[to].predecessorCount++;
+    m_prepared = false;
+}
+
+void TaskGraph::clear()
+{
+    wait();
+
+    for(auto& node : m_nodes)
+    {
+        m_pManager->m_taskPool.free(node.pTask);
+    }
+    m_nodes.clear();
+    m_roots.clear();
+    m_prepared = false;
+}
+
+bool TaskGraph::prepare()
+{
+    APH_ASSERT(poll());
+
+    m_roots.clear();
+    for(auto& node : m_nodes)
+    {
+        if(node.predecessorCount == 0)
+        {
+            m_roots.push_back(node.pTask);
+        }
+    }
+
+    // every node has to be reachable from a root, otherwise the graph has a cycle and would never complete
+    std::vector<uint32_t> inDegree(m_nodes.size());
+    std::vector<NodeId>   stack;
+    for(NodeId id = 0; id < m_nodes.size(); ++id)
+    {
+        inDegree[id] = m_nodes[id].predecessorCount;
+        if(inDegree[id] == 0)
+        {
+            stack.push_back(id);
+        }
+    }
+
+    std::size_t visited = 0;
+    while(!stack.empty())
+    {
+        NodeId id = stack.back();
+        stack.pop_back();
+        visited++;
+        for(NodeId successor : m_nodes[id].successors)
+        {
+            if(--inDegree[successor] == 0)
+            {
+                stack.push_back(successor);
+            }
+        }
+    }
+
+    if(visited != m_nodes.size())
+    {
+        CM_LOG_ERR("task graph [%s] has a cycle, %zu of %zu nodes can never run.", m_desc, m_nodes.size() - visited,
+                   m_nodes.size());
+        return false;
+    }
+
+    m_prepared = true;
+    return true;
+}
+
+bool TaskGraph::run()
+{
+    APH_ASSERT(poll());
+
+    if(!m_prepared && !prepare())
+    {
+        return false;
+    }
+
+    if(m_nodes.empty())
+    {
+        return true;
+    }
+
+    for(auto& node : m_nodes)
+    {
+        node.pendingPredecessors.store(node.predecessorCount, std::memory_order_relaxed);
+    }
+    m_remainingCount.store(m_nodes.size(), std::memory_order_relaxed);
+    m_done.store(false, std::memory_order_relaxed);
+    m_idle.store(false, std::memory_order_relaxed);
+
+    // the queues publish the counters to the workers
+    m_pManager->scheduleTasks(m_roots);
+    return true;
+}
+
+void TaskGraph::wait()
+{
+    m_pManager->waitUntil(m_done, m_priority);
+
+    // the last node may still be notifying the waiters
+    while(!m_idle.load(std::memory_order_acquire))
+    {
+        std::this_thread::yield();
+    }
+}
+
+void TaskGraph::runNode(NodeId id)
+{
+    auto& node = m_nodes[id];
+    node.func();
+
+    // schedule the successors this node was the last predecessor of, in batches
+    std::array<Task*, 16> ready;
+    std::size_t           readyCount = 0;
+    for(NodeId successorId : node.successors)
+    {
+        auto& successor = m_nodes[successorId];
+        if(successor.pendingPredecessors.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            ready[readyCount++] = successor.pTask;
+            if(readyCount == ready.size())
+            {
+                m_pManager->scheduleTasks(ready);
+                readyCount = 0;
+            }
+        }
+    }
+    if(readyCount)
+    {
+        m_pManager->scheduleTasks({ready.data(), readyCount});
+    }
+
+    if(m_remainingCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        m_done.store(true, std::memory_order_release);
+        m_done.notify_all();
+        m_pManager->wakeWaiters();
+        m_idle.store(true, std::memory_order_release);
+    }
+}
+}  // namespace aph
@@ -0,0 +1,77 @@
+#ifndef APH_TASK_GRAPH_H_
+#define APH_TASK_GRAPH_H_
+
+#include "taskManager.h"
+
+namespace aph
+{
+/*
+ * Task graph recorded once and replayed with run().
+ *
+ * Nodes, edges and callables are set up while recording. A run only resets the per-node predecessor counters and
+ * schedules the root nodes, there are no allocations or dependency wiring per run. A node is scheduled by the
+ * predecessor that completes last.
+ */
+class TaskGraph
+{
+public:
+    using NodeId = uint32_t;
+
+    explicit TaskGraph(const char* desc = nullptr, TaskPriority priority = TaskPriority::Normal,
+                       TaskManager* pManager = &TaskManager::GetInstance());
+    ~TaskGraph();
+
+    TaskGraph(const TaskGraph&)            = delete;
+    TaskGraph& operator=(const TaskGraph&) = delete;
+
+    // recording, not allowed while the graph is running
+    // descriptions are not copied, they must outlive the graph (usually string literals)
+    NodeId addNode(TaskFunc&& func, const char* desc = nullptr);
+    // to starts only after from has completed
+    void   addEdge(NodeId from, NodeId to);
+    void   clear();
+
+    // checks the recorded graph and finds its root nodes, run() does this on its own after the graph changed.
+    // Returns false if the edges form a cycle, such a graph would never complete and is never run.
+    bool prepare();
+
+    // schedules the root nodes and returns immediately, returns false without running anything if the graph has a
+    // cycle
+    bool run();
+    // runs ready tasks of the graph's priority or higher on the calling thread until every node of the current run
+    // has completed
+    void wait();
+    bool poll() const { return m_idle.load(std::memory_order_acquire); }
+
+    std::size_t getNodeCount() const { return m_nodes.size(); }
+
+private:
+    struct Node
+    {
+        explicit Node(TaskFunc&& callable) : func(std::move(callable)) {}
+
+        TaskFunc            func;
+        Task*               pTask = {};
+        SmallVector<NodeId> successors;
+        uint32_t            predecessorCount = 0;
+        std::atomic_uint    pendingPredecessors{0};
+    };
+
+    void runNode(NodeId id);
+
+    TaskManager* m_pManager = {};
+    const char*  m_desc     = {};
+    TaskPriority m_priority = TaskPriority::Normal;
+
+    std::deque<Node>   m_nodes;
+    std::vector<Task*> m_roots;
+    bool               m_prepared = false;
+
+    alignas(CACHE_LINE_SIZE) std::atomic_uint m_remainingCount{0};
+    // m_done wakes the waiters, m_idle is set after that so the graph is not reused or destroyed under the last node
+    std::atomic_bool m_done{true};
+    std::atomic_bool m_idle{true};
+};
+}  // namespace aph
+
+#endif  // APH_TASK_GRAPH_H_
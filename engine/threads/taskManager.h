@@ -1,25 +1,53 @@
 #ifndef APH_JOBSYSTEM_H_
 #define APH_JOBSYSTEM_H_
 
+#include <array>
+#include <coroutine>
+#include <latch>
+#include <span>
 #include <utility>
 
 #include "common/singleton.h"
 #include "allocator/objectPool.h"
+#include "common/inplaceFunction.h"
 #include "common/smallVector.h"
+#include "coTask.h"
+#include "mpmcQueue.h"
+#include "taskProfiler.h"
 #include "threadPool.h"
+#include "workStealingQueue.h"
 
 namespace aph
 {
-using TaskFunc = std::function<void()>;
+using TaskFunc = InplaceFunction<void()>;
 
 struct Task;
 class TaskManager;
+class TaskContext;
+
+enum class TaskPriority : uint8_t
+{
+    Critical,    // Frame critical work (culling, command recording), always picked first.
+    Normal,      //
+    Background,  // Streaming and decoding, only runs when nothing else is ready.
+    BlockingIO,  // Runs on the dedicated I/O threads and never occupies a CPU worker.
+    Count,
+};
+
+struct IndexRange
+{
+    std::size_t begin = 0;
+    std::size_t end   = 0;
+
+    std::size_t size() const { return end > begin ? end - begin : 0; }
+};
 
 class TaskDeps
 {
     friend class ObjectPool<TaskDeps>;
     friend class TaskManager;
     friend class TaskGroup;
+    friend class TaskContext;
 
 public:
     void taskCompleted();
@@ -29,32 +57,66 @@ public:
 private:
     explicit TaskDeps(TaskManager* manager);
 
+    // A group's deps are referenced by the TaskGroup until removeTaskGroup() and by the group's own completion until
+    // notifyDependees() has finished, which covers its tasks, dependencies and continuations. Anything else keeping a
+    // pointer past removeTaskGroup() takes its own reference. The last release hands the deps back to the pool.
+    void acquire();
+    void release();
+
+    // returns false without suspending when the group is already done, the coroutine is later resumed with the
+    // priority of the task it suspended in
+    bool addWaiter(std::coroutine_handle<> handle);
+
+    // keeps the first exception thrown by a coroutine task of the group, rethrown once the group is done
+    void setException(std::exception_ptr exception);
+    void rethrowIfFailed() const;
+
     SmallVector<TaskDeps*> m_pendingDeps;
     std::atomic_uint       m_pendingTaskCount;
 
+    // continuations added with TaskGroup::then(), registered under m_waiterLock and cancelled along with this group
+    SmallVector<TaskDeps*> m_continuations;
+    // tasks that have not started yet are dropped, the group still completes
+    std::atomic_bool       m_cancelled = false;
+
     SmallVector<Task*> m_pendingTasks;
     std::atomic_uint   m_dependencyCount;
 
-    std::condition_variable m_cond;
-    std::mutex              m_condLock;
-    bool                    m_done = false;
+    // waited on with std::atomic::wait, set once every task and dependee has been notified
+    std::atomic_bool m_done = false;
 
-    TaskManager* m_pManager = {};
+    // coroutines suspended on this group and the priority to resume them with
+    std::mutex                                                    m_waiterLock;
+    SmallVector<std::pair<std::coroutine_handle<>, TaskPriority>> m_waiters;
+    // notified along with m_done for waits with a timeout
+    std::condition_variable                                       m_doneCondition;
+    // set under m_waiterLock before m_done, read once m_done has been seen
+    std::exception_ptr                                            m_exception;
+
+    TaskManager*     m_pManager = {};
+    TaskPriority     m_priority = TaskPriority::Normal;
+    const char*      m_desc     = {};
+    std::atomic_uint m_refCount = 2;
 };
 
 struct Task
 {
     friend class ObjectPool<Task>;
 
-    TaskFunc    m_callable = {};
-    TaskDeps*   m_pDeps    = {};
-    std::string m_desc     = {};
+    TaskFunc     m_callable   = {};
+    TaskDeps*    m_pDeps      = {};
+    const char*  m_desc       = {};
+    const char*  m_group      = {};
+    TaskPriority m_priority   = TaskPriority::Normal;
+    bool         m_persistent = false;  // owned by a TaskGraph and reused on every run, never freed after running
 
 private:
-    Task(TaskDeps* pDeps, TaskFunc&& func, std::string desc) :
-        m_callable(std::forward<TaskFunc>(func)),
+    Task(TaskDeps* pDeps, TaskFunc&& func, const char* desc, const char* group, TaskPriority priority) :
+        m_callable(std::move(func)),
         m_pDeps(pDeps),
-        m_desc(std::move(desc))
+        m_desc(desc),
+        m_group(group),
+        m_priority(priority)
     {
     }
 };
@@ -62,59 +124,220 @@ private:
 class TaskGroup
 {
     friend class TaskManager;
+    friend class TaskContext;
     friend class ObjectPool<TaskGroup>;
 
 public:
     ~TaskGroup();
     void submit();
     void flush();
+    // runs ready tasks of the group's priority or higher on the calling thread until the group completes, rethrows
+    // the first exception of its coroutine tasks
     void wait();
+    // like wait() but gives up after timeout, returns whether the group has completed
+    // the deadline can be overrun by the length of one task the calling thread helped with
+    bool waitFor(std::chrono::steady_clock::duration timeout);
+    // whether the group has completed, its tasks have run and its dependees and continuations have been notified
     bool poll();
-    void addTask(TaskFunc&& func, std::string desc = "");
+    void addTask(TaskFunc&& func, const char* desc = nullptr);
+    void addTask(CoTask<void>&& task, const char* desc = nullptr);
+
+    // drops every task of the group that has not started yet, running tasks finish normally and the group still
+    // completes and notifies its dependees. Continuations added with then() are cancelled too. Coroutine tasks
+    // always run, long running tasks and coroutines can check isCancelled() to stop early.
+    void cancel();
+    bool isCancelled() const;
+
+    // creates a group that runs func on the worker that completes this group, without a round trip through the
+    // submitting thread. Can be called before or after flush(), the returned group is flushed and has to be
+    // removed with removeTaskGroup() like any other.
+    TaskGroup* then(TaskFunc&& func, const char* desc = nullptr);
+
+    // co_await on a group flushes it and suspends the coroutine until the group has completed, the coroutine is
+    // then resumed on one of the workers and the first exception of the group's coroutine tasks is rethrown
+    auto operator co_await()
+    {
+        struct Awaiter
+        {
+            TaskGroup* pGroup;
+
+            bool await_ready() { return pGroup->poll(); }
+            bool await_suspend(std::coroutine_handle<> handle) { return pGroup->m_pDeps->addWaiter(handle); }
+            void await_resume() const { pGroup->m_pDeps->rethrowIfFailed(); }
+        };
+        return Awaiter{this};
+    }
 
 private:
-    explicit TaskGroup(TaskManager* manager, std::string desc);
+    explicit TaskGroup(TaskManager* manager, const char* desc);
     TaskManager* m_pManager = {};
     TaskDeps*    m_pDeps    = {};
-    std::string  m_desc     = {};
+    const char*  m_desc     = {};
     bool         m_flushed  = {false};
 };
 
 class TaskManager final
 {
+    friend class TaskDeps;
+    friend class TaskGroup;
+    friend class TaskContext;
+    friend class TaskGraph;
+
 public:
-    TaskManager(uint32_t threadCount = 0, std::string description = {});
+    // The engine-wide task manager shared by every subsystem, created on first use.
+    // The arguments only apply to the first call, BaseApp::loadConfig makes it from m_options.
+    static TaskManager& GetInstance(uint32_t threadCount = 0, bool pinWorkers = false);
+
+    // ioThreadCount threads are reserved for TaskPriority::BlockingIO tasks on top of the threadCount CPU workers.
+    // Without I/O threads, BlockingIO tasks run on the CPU workers in the Background lane.
+    // pinWorkers binds every CPU worker to its own physical core and makes workers steal from workers sharing
+    // their L3 cache or NUMA node first.
+    TaskManager(uint32_t threadCount = 0, std::string description = {}, uint32_t ioThreadCount = 1,
+                bool pinWorkers = false);
     ~TaskManager();
 
-    TaskGroup* createTaskGroup(std::string desc = "");
+    // descriptions are not copied, they must outlive the group or task (usually string literals)
+    // every task of the group, including tasks spawned by parallel ranges, runs in the group's priority lane
+    TaskGroup* createTaskGroup(const char* desc = nullptr, TaskPriority priority = TaskPriority::Normal);
     void       removeTaskGroup(TaskGroup* pGroup);
     void       setDependency(TaskGroup* pDependee, TaskGroup* pDependency);
 
-    void scheduleTasks(const SmallVector<Task*>& taskList);
+    void scheduleTasks(std::span<Task* const> taskList);
 
-    void addTask(TaskGroup* pGroup, TaskFunc&& func,  std::string desc = "");
+    void addTask(TaskGroup* pGroup, TaskFunc&& func, const char* desc = nullptr);
+
+    // the coroutine counts as a task of the group until it returns, including the time it spends suspended
+    void addTask(TaskGroup* pGroup, CoTask<void>&& task, const char* desc = nullptr);
 
     void submit(TaskGroup* pGroup);
 
+    // runs ready tasks on the calling thread until every scheduled task has completed, must not be called from a task,
+    // Background tasks are left to the workers
     void wait();
 
+    // Runs func over the range and returns once every index has been processed.
+    // func is either called per chunk as func(begin, end) or per index as func(i). The range is split lazily: a
+    // worker only hands out the upper half of its range when its own queue has run dry, so idle workers steal
+    // large chunks and busy ones keep working on grainSize pieces.
+    template <typename Func>
+    void parallelFor(IndexRange range, std::size_t grainSize, Func&& func);
+
+    // map(begin, end) produces a partial result per chunk, partial results are combined with reduce(a, b), which
+    // must be associative and commutative.
+    template <typename T, typename MapFunc, typename ReduceFunc>
+    T parallelReduce(IndexRange range, std::size_t grainSize, T identity, MapFunc&& map, ReduceFunc&& reduce);
+
+    uint32_t getWorkerCount() const { return m_threadData.workerQueues.size(); }
+
+    // priority of the task running on the calling thread, TaskPriority::Normal outside of the workers
+    TaskPriority getCurrentPriority() const;
+
+    // objects carved out by the task, group and dependency pools, stays flat across frames once the pools are warm
+    // and every group is removed
+    std::size_t getPoolCapacity() const;
+
+    // records task timing, steals and parking once enabled
+    TaskProfiler& getProfiler() { return *m_pProfiler; }
+
+    // how long idle CPU workers poll before parking, the I/O threads always park right away
+    void               setIdlePolicy(const thread::IdlePolicy& policy);
+    thread::IdlePolicy getIdlePolicy() const;
+
 private:
-    void processTask(uint32_t id);
+    using RangeFunc = InplaceFunction<void(std::size_t, std::size_t)>;
+
+    void runParallelRange(RangeFunc&& func, IndexRange range, std::size_t grainSize);
+    void splitRange(TaskDeps* pDeps, const RangeFunc* pFunc, IndexRange range, std::size_t grainSize);
+    void spawnTask(TaskDeps* pDeps, TaskFunc&& func, const char* desc);
+
+    void resumeCoroutine(std::coroutine_handle<> handle, TaskPriority priority, const char* group);
+
+    struct Parking;
+    void wakeUp(Parking& parking, unsigned taskCount);
+    // wakes the threads sleeping in waitUntil(), after new tasks were scheduled or a group or graph is done
+    void wakeWaiters();
+
+    // index of the calling CPU worker, or getWorkerCount() when called from any other thread
+    uint32_t getCurrentWorkerIndex() const;
+    bool     isLocalQueueEmpty(TaskPriority priority) const;
+
+    // ids below getWorkerCount() are CPU workers, the rest are I/O threads, started is counted down once the thread
+    // is ready to take tasks
+    void  processTask(uint32_t id, std::latch& started);
+    // queueDepth is set to the number of tasks left in the queue the task was taken from
+    Task* fetchTask(uint32_t id, uint32_t& queueDepth);
+    // one CPU lane of worker id, its own queues first and then the other workers
+    Task* fetchTask(uint32_t id, std::size_t lane, uint32_t& queueDepth);
+    Task* stealTask(std::size_t lane, std::span<const uint32_t> victims, uint32_t& queueDepth);
+    // a task taken from another worker's deque or inbox
+    void  recordSteal(const Task* task, uint32_t victimId);
+    void  setupWorkerPlacement(bool pinWorkers);
+    void  runTask(Task* task, uint32_t queueDepth);
+
+    // profiler ring of the calling thread
+    uint32_t getProfilerThread() const;
+
+    // runs one ready CPU task of the waited priority or higher on a waiting thread, returns false if there was
+    // nothing to help with. A wait never picks up lower priority work that could outlast what it waits for, and
+    // threads other than the CPU workers never run Background tasks.
+    bool helpWithTask(TaskPriority priority);
+    // sleeps until done is set or new tasks are scheduled, a waiting worker is the only one left to run work queued
+    // behind it
+    void waitUntil(const std::atomic_bool& done, TaskPriority priority);
+    bool waitUntil(TaskDeps& deps, std::chrono::steady_clock::time_point deadline);
+
+    std::atomic_bool m_dead = false;
 
-    bool m_dead = false;
+    std::atomic_uint32_t m_idleSpinCount{thread::IdlePolicy{}.spinCount};
+    std::atomic_uint32_t m_idleYieldCount{thread::IdlePolicy{}.yieldCount};
 
-    std::condition_variable m_waitCond;
-    std::mutex              m_waitCondLock;
-    std::atomic_uint        m_totalTaskCount;
-    std::atomic_uint        m_completedTaskCount;
+    // waited on with std::atomic::wait, notified when it catches up with m_totalTaskCount
+    alignas(CACHE_LINE_SIZE) std::atomic_uint m_totalTaskCount;
+    alignas(CACHE_LINE_SIZE) std::atomic_uint m_completedTaskCount;
+
+    static constexpr std::size_t CPU_LANE_COUNT = static_cast<std::size_t>(TaskPriority::BlockingIO);
+
+    // per-worker ready queues, the owner pushes and pops its local deque while other workers steal from it,
+    // tasks scheduled from outside the worker threads go through the inboxes
+    struct Lane
+    {
+        WorkStealingQueue<Task*> local{};
+        MPMCQueue<Task*>         inbox{4096};
+    };
+
+    struct WorkerQueue
+    {
+        // indexed by TaskPriority, workers drain every worker's higher lane before a lower one
+        std::array<Lane, CPU_LANE_COUNT> lanes;
+
+        // other workers in the order this one steals from them, closest first when pinned
+        std::vector<uint32_t> victims;
+        int32_t               cpu = -1;
+    };
+
+    struct Parking
+    {
+        std::counting_semaphore<> wakeup{0};
+        alignas(CACHE_LINE_SIZE) std::atomic_uint sleepingCount{0};
+    };
 
     struct
     {
         SmallVector<std::future<void>> threadResults;
         std::unique_ptr<ThreadPool<>>  threadPool;
-        std::queue<Task*>              readyTaskQueue;
-        std::mutex                     condLock;
-        std::condition_variable        cond;
+        std::deque<WorkerQueue>        workerQueues;
+        std::vector<uint32_t>          allWorkers;
+        Parking                        workerParking;
+        alignas(CACHE_LINE_SIZE) std::atomic_uint nextWorker{0};
+
+        // threads sleeping in waitUntil() wait on the epoch, it is only bumped while there are waiters
+        alignas(CACHE_LINE_SIZE) std::atomic_uint32_t waitEpoch{0};
+        alignas(CACHE_LINE_SIZE) std::atomic_uint waiterCount{0};
+
+        // blocking I/O lane, served by its own threads so CPU workers are never stuck in a read
+        uint32_t         ioThreadCount = 0;
+        MPMCQueue<Task*> ioQueue{4096};
+        Parking          ioParking;
     } m_threadData;
 
 private:
@@ -123,8 +346,106 @@ private:
     ThreadSafeObjectPool<TaskDeps>  m_taskDepsPool;
 
 private:
-    std::string m_description;
+    std::string                   m_description;
+    std::unique_ptr<TaskProfiler> m_pProfiler;
 };
 
+/*
+ * Named view of a TaskManager for one subsystem.
+ *
+ * Groups created through a context default to the context's priority, and wait() only waits for the groups of this
+ * context instead of every task in the shared manager.
+ */
+class TaskContext
+{
+public:
+    TaskContext(std::string name, TaskPriority priority = TaskPriority::Normal,
+                TaskManager* pManager = &TaskManager::GetInstance());
+    ~TaskContext();
+
+    TaskContext(const TaskContext&)            = delete;
+    TaskContext& operator=(const TaskContext&) = delete;
+
+    TaskGroup* createTaskGroup(const char* desc = nullptr);
+    TaskGroup* createTaskGroup(const char* desc, TaskPriority priority);
+    void       removeTaskGroup(TaskGroup* pGroup) { m_pManager->removeTaskGroup(pGroup); }
+    void       submit(TaskGroup* pGroup) { m_pManager->submit(pGroup); }
+
+    // waits for every group created through this context before the call, helping with ready tasks meanwhile,
+    // the groups have to be flushed or submitted
+    void wait();
+
+    TaskManager*       getManager() const { return m_pManager; }
+    const std::string& getName() const { return m_name; }
+
+private:
+    TaskManager* m_pManager = {};
+    std::string  m_name;
+    TaskPriority m_priority = TaskPriority::Normal;
+
+    // each holds a reference on its TaskDeps, so they can be waited on after their group was removed. Released
+    // once waited on, or by the next createTaskGroup() after the group completed
+    std::mutex             m_groupLock;
+    SmallVector<TaskDeps*> m_groups;
+};
+
+template <typename Func>
+void TaskManager::parallelFor(IndexRange range, std::size_t grainSize, Func&& func)
+{
+    if constexpr(std::is_invocable_v<Func&, std::size_t, std::size_t>)
+    {
+        runParallelRange([&func](std::size_t begin, std::size_t end) { func(begin, end); }, range, grainSize);
+    }
+    else
+    {
+        runParallelRange(
+            [&func](std::size_t begin, std::size_t end) {
+                for(std::size_t i = begin; i < end; ++i)
+                {
+                    func(i);
+                }
+            },
+            range, grainSize);
+    }
+}
+
+template <typename T, typename MapFunc, typename ReduceFunc>
+T TaskManager::parallelReduce(IndexRange range, std::size_t grainSize, T identity, MapFunc&& map,
+                              ReduceFunc&& reduce)
+{
+    struct alignas(CACHE_LINE_SIZE) Partial
+    {
+        T value;
+    };
+
+    // one partial result per worker, plus one shared by every other thread helping while it waits
+    std::vector<Partial> partials(getWorkerCount() + 1, Partial{identity});
+    std::mutex           externalLock;
+
+    runParallelRange(
+        [this, &partials, &externalLock, &map, &reduce](std::size_t begin, std::size_t end) {
+            uint32_t index   = getCurrentWorkerIndex();
+            T        mapped  = map(begin, end);
+            T&       partial = partials[index].value;
+            if(index == getWorkerCount())
+            {
+                std::lock_guard<std::mutex> holder{externalLock};
+                partial = reduce(std::move(partial), std::move(mapped));
+            }
+            else
+            {
+                partial = reduce(std::move(partial), std::move(mapped));
+            }
+        },
+        range, grainSize);
+
+    T result = std::move(identity);
+    for(auto& partial : partials)
+    {
+        result = reduce(std::move(result), std::move(partial.value));
+    }
+    return result;
+}
+
 }  // namespace aph
 #endif
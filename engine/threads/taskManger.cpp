@@ -1,3 +1,4 @@
+#include <numeric>
 #include <utility>
 
 #include "taskManager.h"
@@ -11,6 +12,10 @@ namespace
 template <typename... Args>
 void logThreadDebug(std::string_view fmt, Args&&... args)
 {
+    if(!::aph::Logger::GetInstance().isEnabled(::aph::Logger::Level::Debug))
+    {
+        return;
+    }
     std::ostringstream ss;
     ss << "[THREAD: " << aph::thread::getName().c_str() << "] ";
     ss << fmt;
@@ -27,10 +32,31 @@ void logThreadDebug(std::string_view fmt, Args&&... args)
     #define THREAD_LOG_DEBUG(...) (void(0));
 #endif
 
+namespace
+{
+// the task manager and worker index of the current thread, if it is one of the task manager's workers
+thread_local const aph::TaskManager* tl_manager  = nullptr;
+thread_local uint32_t                tl_workerId = 0;
+// priority of the task the current worker is running
+thread_local aph::TaskPriority tl_priority = aph::TaskPriority::Normal;
+
+std::size_t laneIndex(aph::TaskPriority priority)
+{
+    return static_cast<std::size_t>(priority);
+}
+}  // namespace
+
 namespace aph
 {
 
-TaskManager::TaskManager(uint32_t threadCount, std::string description) : m_description(std::move(description))
+TaskManager& TaskManager::GetInstance(uint32_t threadCount, bool pinWorkers)
+{
+    static TaskManager instance{threadCount, "Engine", 1, pinWorkers};
+    return instance;
+}
+
+TaskManager::TaskManager(uint32_t threadCount, std::string description, uint32_t ioThreadCount, bool pinWorkers) :
+    m_description(std::move(description))
 {
     m_totalTaskCount.store(0);
     m_completedTaskCount.store(0);
@@ -40,26 +66,40 @@ TaskManager::TaskManager(uint32_t threadCount, std::string description) : m_desc
         threadCount = std::thread::hardware_concurrency();
     }
 
-    CM_LOG_INFO("Task Manager [%s] init, thread count: %u.", m_description, threadCount);
+    CM_LOG_INFO("Task Manager [%s] init, thread count: %u, io thread count: %u.", m_description, threadCount,
+                ioThreadCount);
+
+    m_threadData.workerQueues.resize(threadCount);
+    m_threadData.ioThreadCount = ioThreadCount;
+    setupWorkerPlacement(pinWorkers);
 
-    m_threadData.threadPool = std::make_unique<ThreadPool<>>(threadCount);
+    m_threadData.threadPool    = std::make_unique<ThreadPool<>>(threadCount + ioThreadCount);
+    m_pProfiler                = std::make_unique<TaskProfiler>(threadCount + ioThreadCount);
 
-    for(auto idx = 0; idx < threadCount; idx++)
+    // a full magazine on every thread and on one submitting thread, past that the pools only grow with the number
+    // of tasks and groups alive at once
+    const std::size_t reserveCount = (threadCount + ioThreadCount + 1) * 2 * detail::POOL_MAGAZINE_SIZE;
+    m_taskPool.reserve(reserveCount);
+    m_taskGroupPool.reserve(reserveCount);
+    m_taskDepsPool.reserve(reserveCount);
+
+    // every thread has set itself up once the constructor returns, so none of that lands in the first frames
+    std::latch started{threadCount + ioThreadCount};
+    for(uint32_t idx = 0; idx < threadCount + ioThreadCount; idx++)
     {
-        auto&& res = m_threadData.threadPool->enqueue([this, idx]() { this->processTask(idx); });
+        auto&& res = m_threadData.threadPool->enqueue([this, idx, &started]() { this->processTask(idx, started); });
         m_threadData.threadResults.push_back(std::move(res));
     }
+    started.wait();
 }
 
 TaskManager::~TaskManager()
 {
     wait();
 
-    {
-        std::lock_guard<std::mutex> holder{m_threadData.condLock};
-        m_dead = true;
-        m_threadData.cond.notify_all();
-    }
+    m_dead.store(true, std::memory_order_seq_cst);
+    m_threadData.workerParking.wakeup.release(m_threadData.workerQueues.size());
+    m_threadData.ioParking.wakeup.release(m_threadData.ioThreadCount);
 
     for(auto& result : m_threadData.threadResults)
     {
@@ -71,37 +111,119 @@ TaskManager::~TaskManager()
     m_taskPool.clear();
 }
 
-TaskGroup* TaskManager::createTaskGroup(std::string desc)
+void TaskManager::setupWorkerPlacement(bool pinWorkers)
+{
+    auto&          queues      = m_threadData.workerQueues;
+    const uint32_t workerCount = queues.size();
+
+    std::vector<aph::thread::CpuCore> cores;
+    if(pinWorkers)
+    {
+        cores = aph::thread::getPhysicalCores();
+        std::erase_if(cores, [](const auto& core) { return !aph::thread::isCpuAllowed(core.cpu); });
+        if(cores.empty())
+        {
+            CM_LOG_WARN("[%s] cpu topology is not available, workers are not pinned.", m_description);
+        }
+        else
+        {
+            CM_LOG_INFO("[%s] pinning %u workers to %zu physical cores.", m_description, workerCount, cores.size());
+        }
+    }
+
+    // with more workers than cores, cores are shared round-robin
+    auto coreOf = [&cores](uint32_t worker) -> const aph::thread::CpuCore& { return cores[worker % cores.size()]; };
+
+    m_threadData.allWorkers.resize(workerCount);
+    std::iota(m_threadData.allWorkers.begin(), m_threadData.allWorkers.end(), 0);
+
+    for(uint32_t id = 0; id < workerCount; ++id)
+    {
+        auto& victims = queues[id].victims;
+        for(uint32_t i = 1; i < workerCount; ++i)
+        {
+            victims.push_back((id + i) % workerCount);
+        }
+
+        if(cores.empty())
+        {
+            continue;
+        }
+
+        // steal from the same L3 first, then the same NUMA node, then across sockets
+        const auto& own = coreOf(id);
+        queues[id].cpu  = static_cast<int32_t>(own.cpu);
+        auto distance   = [&](uint32_t worker) {
+            const auto& other = coreOf(worker);
+            return other.l3 == own.l3 ? 0 : other.numaNode == own.numaNode && other.package == own.package ? 1 : 2;
+        };
+        std::stable_sort(victims.begin(), victims.end(),
+                         [&](uint32_t a, uint32_t b) { return distance(a) < distance(b); });
+    }
+}
+
+TaskGroup* TaskManager::createTaskGroup(const char* desc, TaskPriority priority)
 {
-    if (desc.empty())
+    if(!desc)
     {
-        desc = m_description + ": Untitled Group";
+        desc = "Untitled Group";
     }
 
-    CM_LOG_DEBUG("create task group [%s]", desc);
-    auto group     = m_taskGroupPool.allocate(this, std::move(desc));
+    CM_LOG_DEBUG("[%s] create task group [%s]", m_description, desc);
+    auto group     = m_taskGroupPool.allocate(this, desc);
     group->m_pDeps = m_taskDepsPool.allocate(this);
     group->m_pDeps->m_pendingTaskCount.store(0, std::memory_order_relaxed);
+    group->m_pDeps->m_priority = priority;
+    group->m_pDeps->m_desc     = desc;
     return group;
 }
 
-void TaskManager::addTask(TaskGroup* pGroup, TaskFunc&& func, std::string desc)
+void TaskManager::addTask(TaskGroup* pGroup, TaskFunc&& func, const char* desc)
 {
-    if (desc.empty())
+    if(!desc)
     {
-        desc = m_description + ": Untitled Task";
+        desc = "Untitled Task";
     }
 
-    CM_LOG_DEBUG("add task [%s]", desc);
-    Task* task = m_taskPool.allocate(pGroup->m_pDeps, std::move(func), std::move(desc));
+    CM_LOG_DEBUG("[%s] add task [%s]", m_description, desc);
+    Task* task =
+        m_taskPool.allocate(pGroup->m_pDeps, std::move(func), desc, pGroup->m_desc, pGroup->m_pDeps->m_priority);
     pGroup->m_pDeps->m_pendingTasks.push_back(task);
     pGroup->m_pDeps->m_pendingTaskCount.fetch_add(1, std::memory_order_relaxed);
 }
 
+void TaskManager::addTask(TaskGroup* pGroup, CoTask<void>&& task, const char* desc)
+{
+    if(!desc)
+    {
+        desc = "Untitled Coroutine";
+    }
+
+    CM_LOG_DEBUG("[%s] add coroutine task [%s]", m_description, desc);
+
+    // the first run is a plain task without deps, the group task completes when the coroutine returns
+    auto handle                   = task.release();
+    handle.promise().m_onComplete = [pDeps = pGroup->m_pDeps](std::exception_ptr exception) {
+        if(exception)
+        {
+            pDeps->setException(std::move(exception));
+        }
+        pDeps->taskCompleted();
+    };
+
+    Task* pTask = m_taskPool.allocate(nullptr, [handle]() { handle.resume(); }, desc, pGroup->m_desc,
+                                      pGroup->m_pDeps->m_priority);
+    pGroup->m_pDeps->m_pendingTasks.push_back(pTask);
+    pGroup->m_pDeps->m_pendingTaskCount.fetch_add(1, std::memory_order_relaxed);
+}
+
 void TaskManager::removeTaskGroup(TaskGroup* pGroup)
 {
     CM_LOG_DEBUG("free task group [%s]", pGroup->m_desc);
+    // the group flushes itself when destroyed before being flushed, release the deps afterwards
+    TaskDeps* pDeps = pGroup->m_pDeps;
     m_taskGroupPool.free(pGroup);
+    pDeps->release();
 }
 
 void TaskManager::setDependency(TaskGroup* pDependee, TaskGroup* pDependency)
@@ -118,7 +240,7 @@ void TaskManager::submit(TaskGroup* pGroup)
     removeTaskGroup(pGroup);
 }
 
-TaskGroup::TaskGroup(TaskManager* manager, std::string desc) : m_pManager(manager), m_desc(std::move(desc))
+TaskGroup::TaskGroup(TaskManager* manager, const char* desc) : m_pManager(manager), m_desc(desc)
 {
 }
 
@@ -156,8 +278,58 @@ void TaskGroup::wait()
         flush();
     }
 
-    std::unique_lock<std::mutex> holder{m_pDeps->m_condLock};
-    m_pDeps->m_cond.wait(holder, [this]() { return m_pDeps->m_done; });
+    m_pManager->waitUntil(m_pDeps->m_done, m_pDeps->m_priority);
+    m_pDeps->rethrowIfFailed();
+}
+
+bool TaskGroup::waitFor(std::chrono::steady_clock::duration timeout)
+{
+    CM_LOG_DEBUG("task group wait for [%s]", m_desc);
+    if(!m_flushed)
+    {
+        flush();
+    }
+
+    if(!m_pManager->waitUntil(*m_pDeps, std::chrono::steady_clock::now() + timeout))
+    {
+        return false;
+    }
+    m_pDeps->rethrowIfFailed();
+    return true;
+}
+
+void TaskGroup::cancel()
+{
+    CM_LOG_DEBUG("task group cancel [%s]", m_desc);
+    m_pDeps->m_cancelled.store(true, std::memory_order_release);
+}
+
+bool TaskGroup::isCancelled() const
+{
+    return m_pDeps->m_cancelled.load(std::memory_order_acquire);
+}
+
+TaskGroup* TaskGroup::then(TaskFunc&& func, const char* desc)
+{
+    TaskGroup* pNext = m_pManager->createTaskGroup(desc ? desc : m_desc, m_pDeps->m_priority);
+    pNext->addTask(std::move(func), desc);
+
+    {
+        // notifyDependees() runs the continuations under the same lock once the group is done
+        std::lock_guard<std::mutex> holder{m_pDeps->m_waiterLock};
+        if(!m_pDeps->m_done.load(std::memory_order_relaxed))
+        {
+            pNext->m_pDeps->m_dependencyCount.fetch_add(1, std::memory_order_relaxed);
+            m_pDeps->m_continuations.push_back(pNext->m_pDeps);
+        }
+        else if(m_pDeps->m_cancelled.load(std::memory_order_relaxed))
+        {
+            pNext->cancel();
+        }
+    }
+
+    pNext->flush();
+    return pNext;
 }
 
 bool TaskGroup::poll()
@@ -167,12 +339,17 @@ bool TaskGroup::poll()
     {
         flush();
     }
-    return m_pDeps->m_pendingTaskCount.load(std::memory_order_acquire) == 0;
+    return m_pDeps->m_done.load(std::memory_order_acquire);
+}
+
+void TaskGroup::addTask(TaskFunc&& func, const char* desc)
+{
+    m_pManager->addTask(this, std::move(func), desc);
 }
 
-void TaskGroup::addTask(TaskFunc&& func, std::string desc)
+void TaskGroup::addTask(CoTask<void>&& task, const char* desc)
 {
-    m_pManager->addTask(this, std::move(func), std::move(desc));
+    m_pManager->addTask(this, std::move(task), desc);
 }
 
 TaskDeps::TaskDeps(TaskManager* manager) : m_pManager(manager)
@@ -202,9 +379,68 @@ void TaskDeps::notifyDependees()
     m_pendingDeps.clear();
 
     {
-        std::lock_guard<std::mutex> holder{m_condLock};
-        m_done = true;
-        m_cond.notify_all();
+        std::lock_guard<std::mutex> holder{m_waiterLock};
+
+        const bool cancelled = m_cancelled.load(std::memory_order_acquire);
+        for(TaskDeps* pNext : m_continuations)
+        {
+            if(cancelled)
+            {
+                pNext->m_cancelled.store(true, std::memory_order_release);
+            }
+            pNext->dependencySatisfied();
+        }
+        m_continuations.clear();
+
+        m_done.store(true, std::memory_order_release);
+        m_done.notify_all();
+        m_doneCondition.notify_all();
+        m_pManager->wakeWaiters();
+
+        for(auto [handle, priority] : m_waiters)
+        {
+            m_pManager->resumeCoroutine(handle, priority, m_desc);
+        }
+        m_waiters.clear();
+    }
+
+    // the group's own reference, nothing of the group touches the deps after this point
+    release();
+}
+bool TaskDeps::addWaiter(std::coroutine_handle<> handle)
+{
+    std::lock_guard<std::mutex> holder{m_waiterLock};
+    if(m_done.load(std::memory_order_relaxed))
+    {
+        return false;
+    }
+    m_waiters.emplace_back(handle, m_pManager->getCurrentPriority());
+    return true;
+}
+void TaskDeps::setException(std::exception_ptr exception)
+{
+    std::lock_guard<std::mutex> holder{m_waiterLock};
+    if(!m_exception)
+    {
+        m_exception = std::move(exception);
+    }
+}
+void TaskDeps::rethrowIfFailed() const
+{
+    if(m_exception)
+    {
+        std::rethrow_exception(m_exception);
+    }
+}
+void TaskDeps::acquire()
+{
+    m_refCount.fetch_add(1, std::memory_order_relaxed);
+}
+void TaskDeps::release()
+{
+    if(m_refCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        m_pManager->m_taskDepsPool.free(this);
     }
 }
 void TaskDeps::dependencySatisfied()
@@ -214,18 +450,36 @@ void TaskDeps::dependencySatisfied()
 
     if(old_deps == 1)
     {
+        if(m_cancelled.load(std::memory_order_acquire))
+        {
+            // cancelled before it was scheduled, the tasks never reach the queues
+            // coroutine tasks still run, they complete the group once their frame returns
+            auto dropped = erase_if(m_pendingTasks, [this](Task* pTask) {
+                if(pTask->m_pDeps != this)
+                {
+                    return false;
+                }
+                m_pManager->m_taskPool.free(pTask);
+                return true;
+            });
+            m_pendingTaskCount.fetch_sub(dropped, std::memory_order_acq_rel);
+        }
+
         if(m_pendingTasks.empty())
         {
             notifyDependees();
         }
         else
         {
+            // the tasks can complete the group and release it before scheduleTasks() returns
+            acquire();
             m_pManager->scheduleTasks(m_pendingTasks);
             m_pendingTasks.clear();
+            release();
         }
     }
 }
-void TaskManager::scheduleTasks(const SmallVector<Task*>& taskList)
+void TaskManager::scheduleTasks(std::span<Task* const> taskList)
 {
     unsigned taskCount = taskList.size();
 
@@ -233,67 +487,559 @@ void TaskManager::scheduleTasks(const SmallVector<Task*>& taskList)
 
     if(taskCount)
     {
-        std::lock_guard<std::mutex> holder{m_threadData.condLock};
+        auto&          ctx         = m_threadData;
+        const uint32_t workerCount = ctx.workerQueues.size();
+        const bool     fromWorker  = tl_manager == this && tl_workerId < workerCount;
+
+        unsigned cpuTaskCount = 0;
+        unsigned ioTaskCount  = 0;
+        uint32_t worker       = 0;
 
         for(auto& t : taskList)
         {
+            auto priority = t->m_priority;
+            if(priority == TaskPriority::BlockingIO && ctx.ioThreadCount == 0)
+            {
+                // nothing pops the io queue without I/O threads, the workers run these in the Background lane
+                priority = TaskPriority::Background;
+            }
+
+            if(priority == TaskPriority::BlockingIO)
+            {
+                THREAD_LOG_DEBUG("push task [%s] to io queue.", t->m_desc);
+                while(!ctx.ioQueue.tryPush(t))
+                {
+                    // the queue is full, the I/O threads may still be parked
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    wakeUp(ctx.ioParking, ctx.ioThreadCount);
+                    std::this_thread::yield();
+                }
+                ioTaskCount++;
+                continue;
+            }
+
+            auto lane = laneIndex(priority);
+            cpuTaskCount++;
+
+            if(fromWorker)
+            {
+                // scheduled from one of our workers, keep the tasks local and let idle workers steal them
+                THREAD_LOG_DEBUG("push task [%s] to local queue.", t->m_desc);
+                ctx.workerQueues[tl_workerId].lanes[lane].local.push(t);
+                continue;
+            }
+
+            if(cpuTaskCount == 1)
+            {
+                worker = ctx.nextWorker.fetch_add(taskCount, std::memory_order_relaxed);
+            }
+
             THREAD_LOG_DEBUG("push task [%s] to ready queue.", t->m_desc);
-            m_threadData.readyTaskQueue.push(t);
+            while(!ctx.workerQueues[worker++ % workerCount].lanes[lane].inbox.tryPush(t))
+            {
+                if(worker % workerCount == 0)
+                {
+                    // every inbox is full, wake the workers now rather than after the whole batch and let them
+                    // catch up
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    wakeUp(ctx.workerParking, workerCount);
+                    std::this_thread::yield();
+                }
+            }
         }
 
-        for(unsigned i = 0; i < taskCount; i++)
+        // wake up as many sleeping workers as there are new tasks in one go
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        wakeUp(ctx.workerParking, cpuTaskCount);
+        wakeUp(ctx.ioParking, ioTaskCount);
+        if(cpuTaskCount)
         {
-            m_threadData.cond.notify_one();
+            wakeWaiters();
         }
     }
 }
 
-void TaskManager::processTask(uint32_t id)
+void TaskManager::wakeWaiters()
 {
-    aph::thread::setName(m_description.substr(0, 12) + ":" + std::to_string(id));
+    // either a waiter sees the new tasks or the done flag, or we see the waiter
+    auto& ctx = m_threadData;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if(ctx.waiterCount.load(std::memory_order_relaxed))
+    {
+        ctx.waitEpoch.fetch_add(1, std::memory_order_release);
+        ctx.waitEpoch.notify_all();
+    }
+}
 
-    while(true)
+void TaskManager::wakeUp(Parking& parking, unsigned taskCount)
+{
+    if(taskCount)
     {
-        auto& ctx  = m_threadData;
-        Task* task = nullptr;
+        unsigned sleeping = parking.sleepingCount.load(std::memory_order_relaxed);
+        if(sleeping)
+        {
+            parking.wakeup.release(std::min(taskCount, sleeping));
+        }
+    }
+}
+
+void TaskManager::runParallelRange(RangeFunc&& func, IndexRange range, std::size_t grainSize)
+{
+    grainSize = std::max<std::size_t>(grainSize, 1);
 
-        // grab the task from ready task queue
+    if(range.size() == 0)
+    {
+        return;
+    }
+
+    // not worth a round trip through the workers
+    if(range.size() <= grainSize)
+    {
+        func(range.begin, range.end);
+        return;
+    }
+
+    // chunks inherit the priority of the calling task so frame critical work is not split into normal tasks
+    auto group = createTaskGroup("parallel range", getCurrentPriority());
+    group->addTask(
+        [this, pDeps = group->m_pDeps, pFunc = &func, range, grainSize]() {
+            splitRange(pDeps, pFunc, range, grainSize);
+        },
+        "parallel range");
+    group->wait();
+    removeTaskGroup(group);
+}
+
+void TaskManager::splitRange(TaskDeps* pDeps, const RangeFunc* pFunc, IndexRange range, std::size_t grainSize)
+{
+    while(range.size() > grainSize)
+    {
+        if(isLocalQueueEmpty(pDeps->m_priority))
+        {
+            // nothing left for thieves on this worker, hand out the upper half
+            IndexRange upper{range.begin + range.size() / 2, range.end};
+            range.end = upper.begin;
+            spawnTask(
+                pDeps,
+                [this, pDeps, pFunc, upper, grainSize]() { splitRange(pDeps, pFunc, upper, grainSize); },
+                "parallel range");
+        }
+        else
         {
-            std::unique_lock<std::mutex> lock{ctx.condLock};
-            ctx.cond.wait(lock, [&]() { return m_dead || !ctx.readyTaskQueue.empty(); });
+            (*pFunc)(range.begin, range.begin + grainSize);
+            range.begin += grainSize;
+        }
+    }
 
-            if(m_dead && ctx.readyTaskQueue.empty())
-            {
-                THREAD_LOG_DEBUG("Task manager is shutdown and all tasks has completed.");
-                break;
-            }
+    (*pFunc)(range.begin, range.end);
+}
+
+void TaskManager::spawnTask(TaskDeps* pDeps, TaskFunc&& func, const char* desc)
+{
+    // only called from a running task of the same group, which keeps the pending count above zero
+    pDeps->m_pendingTaskCount.fetch_add(1, std::memory_order_relaxed);
+    Task* task = m_taskPool.allocate(pDeps, std::move(func), desc, pDeps->m_desc, pDeps->m_priority);
+    scheduleTasks({&task, 1});
+}
+
+void TaskManager::resumeCoroutine(std::coroutine_handle<> handle, TaskPriority priority, const char* group)
+{
+    Task* task = m_taskPool.allocate(nullptr, [handle]() { handle.resume(); }, "resume coroutine", group, priority);
+    scheduleTasks({&task, 1});
+}
+
+uint32_t TaskManager::getCurrentWorkerIndex() const
+{
+    return tl_manager == this ? std::min(tl_workerId, getWorkerCount()) : getWorkerCount();
+}
+
+TaskPriority TaskManager::getCurrentPriority() const
+{
+    return tl_priority;
+}
+
+bool TaskManager::isLocalQueueEmpty(TaskPriority priority) const
+{
+    if(tl_manager != this || tl_workerId >= getWorkerCount() || priority == TaskPriority::BlockingIO)
+    {
+        return true;
+    }
+    return m_threadData.workerQueues[tl_workerId].lanes[laneIndex(priority)].local.empty();
+}
+
+Task* TaskManager::fetchTask(uint32_t id, uint32_t& queueDepth)
+{
+    auto&          queues      = m_threadData.workerQueues;
+    const uint32_t workerCount = queues.size();
+
+    if(id >= workerCount)
+    {
+        auto task  = m_threadData.ioQueue.tryPop().value_or(nullptr);
+        queueDepth = m_threadData.ioQueue.size();
+        return task;
+    }
+
+    for(std::size_t lane = 0; lane < CPU_LANE_COUNT; ++lane)
+    {
+        if(Task* task = fetchTask(id, lane, queueDepth))
+        {
+            return task;
+        }
+    }
+
+    return nullptr;
+}
 
-            task = ctx.readyTaskQueue.front();
-            ctx.readyTaskQueue.pop();
+Task* TaskManager::fetchTask(uint32_t id, std::size_t lane, uint32_t& queueDepth)
+{
+    auto& worker = m_threadData.workerQueues[id];
+    auto& own    = worker.lanes[lane];
+    if(auto task = own.local.pop())
+    {
+        queueDepth = own.local.size();
+        return task.value();
+    }
+    if(auto task = own.inbox.tryPop())
+    {
+        queueDepth = own.inbox.size();
+        return task.value();
+    }
+    return stealTask(lane, worker.victims, queueDepth);
+}
+
+Task* TaskManager::stealTask(std::size_t lane, std::span<const uint32_t> victims, uint32_t& queueDepth)
+{
+    auto& queues = m_threadData.workerQueues;
+
+    for(uint32_t victimId : victims)
+    {
+        auto& victim = queues[victimId].lanes[lane];
+        if(auto task = victim.local.steal())
+        {
+            queueDepth = victim.local.size();
+            recordSteal(task.value(), victimId);
+            return task.value();
+        }
+        if(auto task = victim.inbox.tryPop())
+        {
+            queueDepth = victim.inbox.size();
+            recordSteal(task.value(), victimId);
+            return task.value();
         }
+    }
+
+    return nullptr;
+}
 
-        THREAD_LOG_DEBUG("running task [%s]", task->m_desc);
+void TaskManager::recordSteal(const Task* task, uint32_t victimId)
+{
+    THREAD_LOG_DEBUG("stole task [%s] from worker %u.", task->m_desc, victimId);
+    if(m_pProfiler->isEnabled())
+    {
+        uint64_t time = TaskProfiler::now();
+        m_pProfiler->record(getProfilerThread(), {.type    = TaskProfiler::Event::Type::Steal,
+                                                  .arg     = victimId,
+                                                  .beginNs = time,
+                                                  .endNs   = time,
+                                                  .name    = task->m_desc,
+                                                  .group   = task->m_group});
+    }
+}
+
+std::size_t TaskManager::getPoolCapacity() const
+{
+    return m_taskPool.getCapacity() + m_taskGroupPool.getCapacity() + m_taskDepsPool.getCapacity();
+}
+
+void TaskManager::setIdlePolicy(const aph::thread::IdlePolicy& policy)
+{
+    CM_LOG_INFO("[%s] idle policy: %u spins, %u yields.", m_description, policy.spinCount, policy.yieldCount);
+    m_idleSpinCount.store(policy.spinCount, std::memory_order_relaxed);
+    m_idleYieldCount.store(policy.yieldCount, std::memory_order_relaxed);
+}
+
+aph::thread::IdlePolicy TaskManager::getIdlePolicy() const
+{
+    return {.spinCount  = m_idleSpinCount.load(std::memory_order_relaxed),
+            .yieldCount = m_idleYieldCount.load(std::memory_order_relaxed)};
+}
+
+uint32_t TaskManager::getProfilerThread() const
+{
+    return tl_manager == this ? tl_workerId : m_pProfiler->getThreadCount();
+}
+
+void TaskManager::runTask(Task* task, uint32_t queueDepth)
+{
+    THREAD_LOG_DEBUG("running task [%s]", task->m_desc);
+
+    // a persistent task may be reused or released by its graph as soon as its callable returns
+    TaskDeps*   pDeps      = task->m_pDeps;
+    bool        persistent = task->m_persistent;
+    const char* desc       = task->m_desc;
+    const char* group      = task->m_group;
+
+    const bool profiling = m_pProfiler->isEnabled();
+    uint64_t   beginTime = profiling ? TaskProfiler::now() : 0;
+
+    // tasks of a cancelled group are dropped without running, the group still completes
+    const bool cancelled = pDeps && pDeps->m_cancelled.load(std::memory_order_relaxed);
+    if(!cancelled)
+    {
+        // tasks may run nested inside a waiting task, restore the priority of the outer one afterwards
+        TaskPriority outerPriority = std::exchange(tl_priority, task->m_priority);
         task->m_callable();
+        tl_priority = outerPriority;
+    }
 
-        task->m_pDeps->taskCompleted();
+    if(profiling && !cancelled)
+    {
+        m_pProfiler->record(getProfilerThread(), {.type    = TaskProfiler::Event::Type::Task,
+                                                  .arg     = queueDepth,
+                                                  .beginNs = beginTime,
+                                                  .endNs   = TaskProfiler::now(),
+                                                  .name    = desc,
+                                                  .group   = group});
+    }
+
+    // coroutine tasks have no deps, they complete their group when the coroutine returns
+    if(pDeps)
+    {
+        pDeps->taskCompleted();
+    }
+    if(!persistent)
+    {
         m_taskPool.free(task);
+    }
+
+    // check if all tasks complete
+    auto completed = m_completedTaskCount.fetch_add(1, std::memory_order_acq_rel) + 1;
+    if(completed == m_totalTaskCount.load(std::memory_order_relaxed))
+    {
+        m_completedTaskCount.notify_all();
+    }
+}
+
+bool TaskManager::helpWithTask(TaskPriority priority)
+{
+    Task*    task       = nullptr;
+    uint32_t queueDepth = 0;
 
-        // check if all tasks complete
+    if(tl_manager == this && tl_workerId < getWorkerCount())
+    {
+        // higher lanes still go first, but a worker takes the lower ones before it sleeps: the waited group may depend
+        // on a lower priority one, and with every worker waiting nobody else would run it
+        for(std::size_t lane = 0; lane < CPU_LANE_COUNT && !task; ++lane)
+        {
+            task = fetchTask(tl_workerId, lane, queueDepth);
+        }
+    }
+    else
+    {
+        // other threads only help with the waited lanes and never with Background, the workers are still there for
+        // the rest, waits on blocking I/O groups can help with any CPU lane
+        std::size_t laneCount =
+            std::min({laneIndex(priority) + 1, CPU_LANE_COUNT, laneIndex(TaskPriority::Background)});
+        for(std::size_t lane = 0; lane < laneCount && !task; ++lane)
         {
-            auto completed = m_completedTaskCount.fetch_add(1, std::memory_order_relaxed) + 1;
-            if(completed == m_totalTaskCount.load(std::memory_order_relaxed))
+            task = stealTask(lane, m_threadData.allWorkers, queueDepth);
+        }
+    }
+
+    if(!task)
+    {
+        return false;
+    }
+
+    runTask(task, queueDepth);
+    return true;
+}
+
+void TaskManager::processTask(uint32_t id, std::latch& started)
+{
+    aph::thread::setName(m_description.substr(0, 12) + ":" + std::to_string(id));
+    tl_manager  = this;
+    tl_workerId = id;
+
+    auto& ctx     = m_threadData;
+    auto& parking = id < ctx.workerQueues.size() ? ctx.workerParking : ctx.ioParking;
+
+    if(id < ctx.workerQueues.size() && ctx.workerQueues[id].cpu >= 0 &&
+       !aph::thread::setAffinity(ctx.workerQueues[id].cpu))
+    {
+        CM_LOG_WARN("[%s] failed to pin worker %u to cpu %d.", m_description, id, ctx.workerQueues[id].cpu);
+    }
+
+    const bool cpuWorker = id < ctx.workerQueues.size();
+
+    // a thread's first task would otherwise allocate its pool magazines in the middle of a frame
+    m_taskPool.prepareThread();
+    m_taskGroupPool.prepareThread();
+    m_taskDepsPool.prepareThread();
+    started.count_down();
+
+    while(true)
+    {
+        uint32_t queueDepth = 0;
+        Task*    task       = fetchTask(id, queueDepth);
+
+        if(!task && cpuWorker)
+        {
+            // frame work comes in bursts, poll for a while before paying for a park and wakeup
+            aph::thread::IdleBackoff backoff{getIdlePolicy()};
+            while(!task && backoff.next())
             {
-                std::lock_guard<std::mutex> holder{m_waitCondLock};
-                m_waitCond.notify_all();
+                task = fetchTask(id, queueDepth);
             }
         }
+
+        if(!task)
+        {
+            // announce that we are going to sleep before checking the queues for the last time, so a concurrent
+            // scheduleTasks() either sees us sleeping or we see its tasks
+            parking.sleepingCount.fetch_add(1, std::memory_order_seq_cst);
+            task = fetchTask(id, queueDepth);
+            if(!task)
+            {
+                if(m_dead.load(std::memory_order_seq_cst))
+                {
+                    parking.sleepingCount.fetch_sub(1, std::memory_order_relaxed);
+                    THREAD_LOG_DEBUG("Task manager is shutdown and all tasks has completed.");
+                    break;
+                }
+
+                uint64_t parkTime = m_pProfiler->isEnabled() ? TaskProfiler::now() : 0;
+                parking.wakeup.acquire();
+                parking.sleepingCount.fetch_sub(1, std::memory_order_relaxed);
+                if(parkTime && m_pProfiler->isEnabled())
+                {
+                    m_pProfiler->record(id, {.type    = TaskProfiler::Event::Type::Park,
+                                             .beginNs = parkTime,
+                                             .endNs   = TaskProfiler::now()});
+                }
+                continue;
+            }
+            parking.sleepingCount.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        runTask(task, queueDepth);
+    }
+
+    tl_manager = nullptr;
+}
+void TaskManager::waitUntil(const std::atomic_bool& done, TaskPriority priority)
+{
+    auto& ctx = m_threadData;
+
+    // help with ready tasks and only sleep once there is nothing left to run
+    while(!done.load(std::memory_order_acquire))
+    {
+        if(helpWithTask(priority))
+        {
+            continue;
+        }
+
+        // announce the waiter before checking for the last time, so scheduleTasks() and the completion either see it
+        // or we see their tasks and the done flag
+        uint32_t epoch = ctx.waitEpoch.load(std::memory_order_acquire);
+        ctx.waiterCount.fetch_add(1, std::memory_order_seq_cst);
+        if(!done.load(std::memory_order_seq_cst) && !helpWithTask(priority))
+        {
+            ctx.waitEpoch.wait(epoch, std::memory_order_acquire);
+        }
+        ctx.waiterCount.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+bool TaskManager::waitUntil(TaskDeps& deps, std::chrono::steady_clock::time_point deadline)
+{
+    while(!deps.m_done.load(std::memory_order_acquire))
+    {
+        if(std::chrono::steady_clock::now() >= deadline)
+        {
+            return false;
+        }
+
+        if(!helpWithTask(deps.m_priority))
+        {
+            std::unique_lock<std::mutex> lock{deps.m_waiterLock};
+            deps.m_doneCondition.wait_until(lock, deadline,
+                                            [&deps]() { return deps.m_done.load(std::memory_order_relaxed); });
+        }
     }
+    return true;
 }
+
 void TaskManager::wait()
 {
-    std::unique_lock<std::mutex> holder{m_waitCondLock};
-    m_waitCond.wait(holder, [&]() {
-        return m_totalTaskCount.load(std::memory_order_relaxed) == m_completedTaskCount.load(std::memory_order_relaxed);
+    while(true)
+    {
+        auto completed = m_completedTaskCount.load(std::memory_order_acquire);
+        if(completed == m_totalTaskCount.load(std::memory_order_acquire))
+        {
+            break;
+        }
+
+        // waits for every lane, helpWithTask() still keeps Background tasks off the other threads
+        if(!helpWithTask(TaskPriority::Background))
+        {
+            m_completedTaskCount.wait(completed, std::memory_order_acquire);
+        }
+    }
+}
+
+TaskContext::TaskContext(std::string name, TaskPriority priority, TaskManager* pManager) :
+    m_pManager(pManager),
+    m_name(std::move(name)),
+    m_priority(priority)
+{
+    CM_LOG_DEBUG("create task context [%s] on [%s]", m_name, m_pManager->m_description);
+}
+
+TaskContext::~TaskContext()
+{
+    wait();
+}
+
+TaskGroup* TaskContext::createTaskGroup(const char* desc)
+{
+    return createTaskGroup(desc, m_priority);
+}
+
+TaskGroup* TaskContext::createTaskGroup(const char* desc, TaskPriority priority)
+{
+    auto group = m_pManager->createTaskGroup(desc, priority);
+
+    // waited on after the group may have been removed
+    group->m_pDeps->acquire();
+
+    // completed groups hand their deps back here, a context that is never waited on does not keep them alive
+    std::lock_guard<std::mutex> holder{m_groupLock};
+    erase_if(m_groups, [](TaskDeps* pDeps) {
+        if(!pDeps->m_done.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        pDeps->release();
+        return true;
     });
+    m_groups.push_back(group->m_pDeps);
+    return group;
+}
+
+void TaskContext::wait()
+{
+    SmallVector<TaskDeps*> groups;
+    {
+        std::lock_guard<std::mutex> holder{m_groupLock};
+        groups.assign(m_groups.begin(), m_groups.end());
+        m_groups.clear();
+    }
+
+    for(auto* pDeps : groups)
+    {
+        m_pManager->waitUntil(pDeps->m_done, pDeps->m_priority);
+        pDeps->release();
+    }
 }
 }  // namespace aph
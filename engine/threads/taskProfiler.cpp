@@ -0,0 +1,189 @@
+#include <bit>
+#include <chrono>
+
+#include "taskProfiler.h"
+
+namespace
+{
+void writeJsonString(std::ostream& out, const char* str)
+{
+    out << '"';
+    for(const char* c = str ? str : ""; *c; ++c)
+    {
+        switch(*c)
+        {
+        case '"':
+            out << "\\\"";
+            break;
+        case '\\':
+            out << "\\\\";
+            break;
+        default:
+            if(static_cast<unsigned char>(*c) >= 0x20)
+            {
+                out << *c;
+            }
+            break;
+        }
+    }
+    out << '"';
+}
+}  // namespace
+
+namespace aph
+{
+void TaskHistogram::add(uint64_t durationNs)
+{
+    std::size_t bucket = durationNs ? std::bit_width(durationNs) - 1 : 0;
+    buckets[std::min(bucket, buckets.size() - 1)]++;
+
+    count++;
+    totalNs += durationNs;
+    minNs = std::min(minNs, durationNs);
+    maxNs = std::max(maxNs, durationNs);
+}
+
+uint64_t TaskHistogram::percentile(double p) const
+{
+    if(count == 0)
+    {
+        return 0;
+    }
+
+    auto     target = static_cast<uint64_t>(p * static_cast<double>(count - 1)) + 1;
+    uint64_t seen   = 0;
+    for(std::size_t bucket = 0; bucket < buckets.size(); ++bucket)
+    {
+        seen += buckets[bucket];
+        if(seen >= target)
+        {
+            return std::min(maxNs, (uint64_t{2} << bucket) - 1);
+        }
+    }
+    return maxNs;
+}
+
+TaskProfiler::TaskProfiler(uint32_t threadCount, std::size_t eventsPerThread) : m_rings(threadCount + 1)
+{
+    std::size_t capacity = std::bit_ceil(std::max<std::size_t>(eventsPerThread, 2));
+    m_mask               = capacity - 1;
+    for(auto& ring : m_rings)
+    {
+        ring.events = std::make_unique<Event[]>(capacity);
+    }
+}
+
+void TaskProfiler::reset()
+{
+    for(auto& ring : m_rings)
+    {
+        ring.head.store(0, std::memory_order_relaxed);
+    }
+}
+
+uint64_t TaskProfiler::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+void TaskProfiler::record(uint32_t thread, const Event& event)
+{
+    auto write = [this, &event](Ring& ring) {
+        uint64_t head              = ring.head.load(std::memory_order_relaxed);
+        ring.events[head & m_mask] = event;
+        ring.head.store(head + 1, std::memory_order_release);
+    };
+
+    if(thread >= getThreadCount())
+    {
+        std::lock_guard<std::mutex> holder{m_externalLock};
+        write(m_rings.back());
+    }
+    else
+    {
+        write(m_rings[thread]);
+    }
+}
+
+std::vector<TaskProfiler::Event> TaskProfiler::collect(uint32_t thread) const
+{
+    const Ring& ring  = m_rings[std::min<std::size_t>(thread, m_rings.size() - 1)];
+    uint64_t    head  = ring.head.load(std::memory_order_acquire);
+    uint64_t    count = std::min<uint64_t>(head, m_mask + 1);
+
+    std::vector<Event> events;
+    events.reserve(count);
+    for(uint64_t i = head - count; i < head; ++i)
+    {
+        events.push_back(ring.events[i & m_mask]);
+    }
+    return events;
+}
+
+void TaskProfiler::exportChromeTrace(std::ostream& out) const
+{
+    // timestamps are in microseconds relative to the first recorded event
+    uint64_t origin = UINT64_MAX;
+    for(uint32_t thread = 0; thread < m_rings.size(); ++thread)
+    {
+        for(const auto& event : collect(thread))
+        {
+            origin = std::min(origin, event.beginNs);
+        }
+    }
+    auto toUs = [origin](uint64_t ns) { return static_cast<double>(ns - origin) / 1000.0; };
+
+    out << "{\"traceEvents\":[";
+    bool first = true;
+    for(uint32_t thread = 0; thread < m_rings.size(); ++thread)
+    {
+        out << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << thread
+            << ",\"args\":{\"name\":\""
+            << (thread == getThreadCount() ? std::string{"other threads"} : "worker " + std::to_string(thread))
+            << "\"}}";
+        first = false;
+
+        for(const auto& event : collect(thread))
+        {
+            out << ",\n{\"pid\":0,\"tid\":" << thread << ",\"ts\":" << toUs(event.beginNs);
+            switch(event.type)
+            {
+            case Event::Type::Task:
+                out << ",\"ph\":\"X\",\"dur\":" << toUs(event.endNs) - toUs(event.beginNs) << ",\"name\":";
+                writeJsonString(out, event.name);
+                out << ",\"cat\":";
+                writeJsonString(out, event.group);
+                out << ",\"args\":{\"queueDepth\":" << event.arg << "}}";
+                break;
+            case Event::Type::Steal:
+                out << ",\"ph\":\"i\",\"s\":\"t\",\"name\":\"steal\",\"cat\":\"scheduler\",\"args\":{\"victim\":"
+                    << event.arg << "}}";
+                break;
+            case Event::Type::Park:
+                out << ",\"ph\":\"X\",\"dur\":" << toUs(event.endNs) - toUs(event.beginNs)
+                    << ",\"name\":\"park\",\"cat\":\"scheduler\"}";
+                break;
+            }
+        }
+    }
+    out << "\n]}\n";
+}
+
+HashMap<std::string, TaskHistogram> TaskProfiler::buildGroupHistograms() const
+{
+    HashMap<std::string, TaskHistogram> histograms;
+    for(uint32_t thread = 0; thread < m_rings.size(); ++thread)
+    {
+        for(const auto& event : collect(thread))
+        {
+            if(event.type == Event::Type::Task)
+            {
+                histograms[event.group ? event.group : ""].add(event.endNs - event.beginNs);
+            }
+        }
+    }
+    return histograms;
+}
+}  // namespace aph
@@ -0,0 +1,97 @@
+#ifndef APH_TASK_PROFILER_H_
+#define APH_TASK_PROFILER_H_
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+#include "common/common.h"
+#include "common/hash.h"
+
+namespace aph
+{
+// histogram of task durations, bucket i counts durations in [2^i, 2^(i+1)) nanoseconds
+struct TaskHistogram
+{
+    std::array<uint64_t, 48> buckets = {};
+
+    uint64_t count   = 0;
+    uint64_t totalNs = 0;
+    uint64_t minNs   = UINT64_MAX;
+    uint64_t maxNs   = 0;
+
+    void add(uint64_t durationNs);
+
+    // upper bound of the bucket containing the given percentile, p in [0, 1]
+    uint64_t percentile(double p) const;
+    uint64_t averageNs() const { return count ? totalNs / count : 0; }
+};
+
+/*
+ * Per-thread ring buffers of task system events.
+ *
+ * Every worker thread writes its own ring without synchronization, threads outside of the task manager share one
+ * ring behind a lock. Recording is off by default and costs one relaxed load per hook when disabled. Rings keep the
+ * most recent events only. Stop recording and wait for the task manager before exporting, events written during an
+ * export may be torn.
+ */
+class TaskProfiler
+{
+public:
+    struct Event
+    {
+        enum class Type : uint8_t
+        {
+            Task,   // a task ran from beginNs to endNs, arg is the depth of the queue it was taken from
+            Steal,  // a task was stolen from worker arg
+            Park,   // the thread was idle from beginNs to endNs
+        };
+
+        Type        type    = Type::Task;
+        uint32_t    arg     = 0;
+        uint64_t    beginNs = 0;
+        uint64_t    endNs   = 0;
+        const char* name    = {};
+        const char* group   = {};
+    };
+
+    // threadCount rings for the task manager's own threads plus one for every other thread
+    explicit TaskProfiler(uint32_t threadCount, std::size_t eventsPerThread = 16384);
+
+    void setEnabled(bool enabled) { m_enabled.store(enabled, std::memory_order_relaxed); }
+    bool isEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+    void reset();
+
+    static uint64_t now();
+
+    // thread is the task manager thread index, or getThreadCount() for any other thread
+    void record(uint32_t thread, const Event& event);
+
+    uint32_t getThreadCount() const { return m_rings.size() - 1; }
+
+    // recorded events of one ring, oldest first
+    std::vector<Event> collect(uint32_t thread) const;
+
+    // Chrome trace event format, open in chrome://tracing or Perfetto
+    void exportChromeTrace(std::ostream& out) const;
+
+    HashMap<std::string, TaskHistogram> buildGroupHistograms() const;
+
+private:
+    struct alignas(CACHE_LINE_SIZE) Ring
+    {
+        std::unique_ptr<Event[]> events;
+        std::atomic<uint64_t>    head{0};
+    };
+
+    std::atomic_bool  m_enabled = false;
+    std::size_t       m_mask    = 0;
+    std::vector<Ring> m_rings;
+    std::mutex        m_externalLock;
+};
+}  // namespace aph
+
+#endif  // APH_TASK_PROFILER_H_
@@ -17,7 +17,9 @@
     #endif
 #endif
 
-#include "threadSafeQueue.h"
+#include "mpmcQueue.h"
+#include "threadUtils.h"
+#include "workStealingQueue.h"
 
 namespace aph
 {
@@ -35,54 +37,55 @@ template <typename FunctionType = threads::DefaultFunctionType, typename ThreadT
 class ThreadPool
 {
 public:
-    explicit ThreadPool(const unsigned int& number_of_threads = std::thread::hardware_concurrency()) :
+    explicit ThreadPool(const unsigned int& number_of_threads = std::thread::hardware_concurrency(),
+                        thread::IdlePolicy   idlePolicy        = {}) :
         m_tasks(number_of_threads)
     {
         std::size_t current_id = 0;
         for(std::size_t i = 0; i < number_of_threads; ++i)
         {
-            m_priority_queue.push_back(size_t(current_id));
             try
             {
-                m_threads.emplace_back([&, id = current_id](const std::stop_token& stop_tok) {
+                m_threads.emplace_back([&, id = current_id, idlePolicy](const std::stop_token& stop_tok) {
+                    tl_pool     = this;
+                    tl_workerId = id;
                     do
                     {
+                        // work tends to come in bursts, poll for a while before paying for a wakeup
+                        thread::IdleBackoff backoff{idlePolicy};
+                        while(m_pending_tasks.load(std::memory_order_acquire) == 0 && !stop_tok.stop_requested() &&
+                              backoff.next())
+                        {
+                        }
+
                         // wait until signaled
-                        m_tasks[id].signal.acquire();
+                        if(m_pending_tasks.load(std::memory_order_acquire) == 0)
+                        {
+                            m_tasks[id].signal.acquire();
+                        }
 
                         do
                         {
                             // invoke the task
-                            while(auto task = m_tasks[id].tasks.pop_front())
+                            while(auto task = popTask(id))
                             {
-                                try
-                                {
-                                    m_pending_tasks.fetch_sub(1, std::memory_order_release);
-                                    std::invoke(std::move(task.value()));
-                                }
-                                catch(...)
-                                {
-                                }
+                                invokeTask(std::move(task.value()));
                             }
 
                             // try to steal a task
                             for(std::size_t j = 1; j < m_tasks.size(); ++j)
                             {
                                 const std::size_t index = (id + j) % m_tasks.size();
-                                if(auto task = m_tasks[index].tasks.steal())
+                                if(auto task = stealTask(index))
                                 {
-                                    // steal a task
-                                    m_pending_tasks.fetch_sub(1, std::memory_order_release);
-                                    std::invoke(std::move(task.value()));
                                     // stop stealing once we have invoked a stolen task
+                                    invokeTask(std::move(task.value()));
                                     break;
                                 }
                             }
 
                         } while(m_pending_tasks.load(std::memory_order_acquire) > 0);
 
-                        m_priority_queue.rotate_to_front(id);
-
                     } while(!stop_tok.stop_requested());
                 });
                 // increment the thread id
@@ -94,9 +97,6 @@ public:
 
                 // remove one item from the tasks
                 m_tasks.pop_back();
-
-                // remove our thread from the priority queue
-                std::ignore = m_priority_queue.pop_back();
             }
         }
     }
@@ -110,6 +110,15 @@ public:
             m_tasks[i].signal.release();
             m_threads[i].join();
         }
+
+        // drop whatever was left in the local deques
+        for(auto& item : m_tasks)
+        {
+            while(auto task = item.local.pop())
+            {
+                delete task.value();
+            }
+        }
     }
 
     /// thread pool is non-copyable
@@ -206,28 +215,95 @@ private:
     template <typename Function>
     void enqueueTask(Function&& f)
     {
-        auto i_opt = m_priority_queue.copy_front_and_rotate_to_back();
-        if(!i_opt.has_value())
+        const std::size_t count = m_tasks.size();
+        if(count == 0)
         {
             // would only be a problem if there are zero threads
             return;
         }
-        auto i = *(i_opt);
+
         m_pending_tasks.fetch_add(1, std::memory_order_relaxed);
-        m_tasks[i].tasks.push_back(std::forward<Function>(f));
-        m_tasks[i].signal.release();
+
+        // nested submissions from one of our workers stay on its own deque, idle workers steal them from there
+        if(tl_pool == this)
+        {
+            m_tasks[tl_workerId].local.push(new FunctionType(std::forward<Function>(f)));
+            m_tasks[m_next_worker.fetch_add(1, std::memory_order_relaxed) % count].signal.release();
+            return;
+        }
+
+        FunctionType      task{std::forward<Function>(f)};
+        const std::size_t start = m_next_worker.fetch_add(1, std::memory_order_relaxed);
+        for(;;)
+        {
+            for(std::size_t j = 0; j < count; ++j)
+            {
+                const std::size_t i = (start + j) % count;
+                if(m_tasks[i].inbox.tryPush(std::move(task)))
+                {
+                    m_tasks[i].signal.release();
+                    return;
+                }
+            }
+            // every inbox is full, give the workers a chance to drain them
+            std::this_thread::yield();
+        }
+    }
+
+    std::optional<FunctionType> popTask(std::size_t id)
+    {
+        // LIFO for nested work, FIFO for external submissions
+        if(auto task = m_tasks[id].local.pop())
+        {
+            return takeTask(task.value());
+        }
+        return m_tasks[id].inbox.tryPop();
+    }
+
+    std::optional<FunctionType> stealTask(std::size_t id)
+    {
+        if(auto task = m_tasks[id].local.steal())
+        {
+            return takeTask(task.value());
+        }
+        return m_tasks[id].inbox.tryPop();
     }
 
+    static FunctionType takeTask(FunctionType* ptr)
+    {
+        FunctionType task{std::move(*ptr)};
+        delete ptr;
+        return task;
+    }
+
+    void invokeTask(FunctionType&& task)
+    {
+        try
+        {
+            m_pending_tasks.fetch_sub(1, std::memory_order_release);
+            std::invoke(std::move(task));
+        }
+        catch(...)
+        {
+        }
+    }
+
+    static constexpr std::size_t INBOX_CAPACITY = 1024;
+
     struct TaskItem
     {
-        aph::ThreadSafeQueue<FunctionType> tasks{};
-        std::binary_semaphore              signal{0};
+        WorkStealingQueue<FunctionType*> local{};
+        MPMCQueue<FunctionType>          inbox{INBOX_CAPACITY};
+        std::binary_semaphore            signal{0};
     };
 
-    std::vector<ThreadType>           m_threads;
-    std::deque<TaskItem>              m_tasks;
-    aph::ThreadSafeQueue<std::size_t> m_priority_queue;
-    std::atomic_int_fast64_t          m_pending_tasks{};
+    inline static thread_local ThreadPool* tl_pool     = nullptr;
+    inline static thread_local std::size_t tl_workerId = 0;
+
+    std::vector<ThreadType>  m_threads;
+    std::deque<TaskItem>     m_tasks;
+    std::atomic_size_t       m_next_worker{};
+    std::atomic_int_fast64_t m_pending_tasks{};
 };
 }  // namespace aph
 
@@ -0,0 +1,176 @@
+#include <sched.h>
+#include <algorithm>
+#include <semaphore>
+#include <sstream>
+
+#include "threadUtils.h"
+
+namespace
+{
+// parses cpu lists such as "0-3,8,10-11"
+std::vector<uint32_t> parseCpuList(const std::string& list)
+{
+    std::vector<uint32_t> cpus;
+    std::stringstream     ss{list};
+    std::string           range;
+    while(std::getline(ss, range, ','))
+    {
+        if(range.empty() || !std::isdigit(static_cast<unsigned char>(range.front())))
+        {
+            continue;
+        }
+
+        auto     dash  = range.find('-');
+        uint32_t first = std::stoul(range.substr(0, dash));
+        uint32_t last  = dash == std::string::npos ? first : std::stoul(range.substr(dash + 1));
+        for(uint32_t cpu = first; cpu <= last; ++cpu)
+        {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+std::string readLine(const std::filesystem::path& path)
+{
+    std::ifstream file{path};
+    std::string   line;
+    std::getline(file, line);
+    return line;
+}
+
+uint32_t readUint(const std::filesystem::path& path, uint32_t fallback)
+{
+    auto line = readLine(path);
+    return line.empty() || !std::isdigit(static_cast<unsigned char>(line.front())) ? fallback : std::stoul(line);
+}
+}  // namespace
+
+namespace aph::thread
+{
+std::vector<CpuCore> getPhysicalCores(const std::filesystem::path& sysfsCpuDir)
+{
+    std::vector<CpuCore> cores;
+
+    std::error_code ec;
+    if(!std::filesystem::exists(sysfsCpuDir / "online", ec))
+    {
+        return cores;
+    }
+
+    for(uint32_t cpu : parseCpuList(readLine(sysfsCpuDir / "online")))
+    {
+        auto cpuDir = sysfsCpuDir / ("cpu" + std::to_string(cpu));
+
+        // keep the first hardware thread of every core only
+        auto siblings = parseCpuList(readLine(cpuDir / "topology" / "thread_siblings_list"));
+        if(!siblings.empty() && *std::min_element(siblings.begin(), siblings.end()) != cpu)
+        {
+            continue;
+        }
+
+        CpuCore core{.cpu = cpu, .package = readUint(cpuDir / "topology" / "physical_package_id", 0), .l3 = cpu};
+
+        for(const auto& entry : std::filesystem::directory_iterator{cpuDir / "cache", ec})
+        {
+            if(entry.path().filename().string().starts_with("index") && readUint(entry.path() / "level", 0) == 3)
+            {
+                auto shared = parseCpuList(readLine(entry.path() / "shared_cpu_list"));
+                if(!shared.empty())
+                {
+                    core.l3 = *std::min_element(shared.begin(), shared.end());
+                }
+            }
+        }
+
+        for(const auto& entry : std::filesystem::directory_iterator{cpuDir, ec})
+        {
+            auto name = entry.path().filename().string();
+            if(name.starts_with("node") && name.size() > 4 && std::isdigit(static_cast<unsigned char>(name[4])))
+            {
+                core.numaNode = std::stoul(name.substr(4));
+            }
+        }
+
+        cores.push_back(core);
+    }
+
+    return cores;
+}
+
+bool isCpuAllowed(uint32_t cpu)
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if(sched_getaffinity(0, sizeof(set), &set) != 0)
+    {
+        return true;
+    }
+    return cpu < CPU_SETSIZE && CPU_ISSET(cpu, &set);
+}
+
+bool setAffinity(uint32_t cpu)
+{
+    if(cpu >= CPU_SETSIZE)
+    {
+        return false;
+    }
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+IdlePolicy calibrateIdlePolicy()
+{
+    using Clock = std::chrono::steady_clock;
+    auto toNs   = [](Clock::duration duration) {
+        return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+    };
+
+    IdlePolicy policy;
+    if(std::thread::hardware_concurrency() <= 1)
+    {
+        // a spinning worker only delays the thread that would give it work
+        policy.spinCount = 0;
+        return policy;
+    }
+
+    constexpr uint32_t pauseCount = 1 << 14;
+    auto               begin      = Clock::now();
+    for(uint32_t i = 0; i < pauseCount; ++i)
+    {
+        cpuRelax();
+    }
+    double pauseNs = std::max(toNs(Clock::now() - begin) / pauseCount, 1.0);
+
+    // semaphore ping-pong, every round trip parks and wakes both threads once
+    constexpr uint32_t    roundCount = 64;
+    std::binary_semaphore ping{0};
+    std::binary_semaphore pong{0};
+    std::vector<double>   wakeNs;
+    {
+        std::jthread partner{[&]() {
+            for(uint32_t i = 0; i < roundCount; ++i)
+            {
+                ping.acquire();
+                pong.release();
+            }
+        }};
+        for(uint32_t i = 0; i < roundCount; ++i)
+        {
+            // give the partner time to park
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+            begin = Clock::now();
+            ping.release();
+            pong.acquire();
+            wakeNs.push_back(toNs(Clock::now() - begin) / 2);
+        }
+    }
+    std::nth_element(wakeNs.begin(), wakeNs.begin() + wakeNs.size() / 2, wakeNs.end());
+
+    policy.spinCount = std::clamp(static_cast<uint32_t>(wakeNs[wakeNs.size() / 2] / pauseNs), 64u, 1u << 16);
+    return policy;
+}
+}  // namespace aph::thread
@@ -1,6 +1,12 @@
 #ifndef APH_THREAD_UTILS_H
 #define APH_THREAD_UTILS_H
 #include <pthread.h>
+#include <filesystem>
+#include <thread>
+#include <vector>
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+    #include <immintrin.h>
+#endif
 
 namespace aph::thread
 {
@@ -20,5 +26,71 @@ inline std::string getName()
     pthread_getname_np(pthread_self(), name.data(), name.size());
     return name;
 }
+
+struct CpuCore
+{
+    uint32_t cpu      = 0;  // logical cpu used for this core, SMT siblings are left out
+    uint32_t package  = 0;
+    uint32_t l3       = 0;  // first cpu sharing the last level cache, equal values share an L3
+    uint32_t numaNode = 0;
+};
+
+// physical cores read from the sysfs cpu topology, empty if it is not available
+std::vector<CpuCore> getPhysicalCores(const std::filesystem::path& sysfsCpuDir = "/sys/devices/system/cpu");
+
+// whether the calling thread's affinity mask allows running on cpu
+bool isCpuAllowed(uint32_t cpu);
+
+// pins the calling thread to a single cpu
+bool setAffinity(uint32_t cpu);
+
+// hints the core that we are in a spin loop, frees pipeline resources for the SMT sibling
+inline void cpuRelax()
+{
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+// how long an idle worker keeps polling for work before it parks on its semaphore
+struct IdlePolicy
+{
+    uint32_t spinCount  = 256;  // polls with a pause in between, no syscalls
+    uint32_t yieldCount = 8;    // polls with a yield in between, lets other threads on this core run
+};
+
+// spins for about as long as waking a parked thread takes, no spinning on a single cpu
+IdlePolicy calibrateIdlePolicy();
+
+// one idle period, poll for work after every next() and park once it returns false
+class IdleBackoff
+{
+public:
+    explicit IdleBackoff(const IdlePolicy& policy) : m_policy(policy) {}
+
+    bool next()
+    {
+        if(m_round < m_policy.spinCount)
+        {
+            cpuRelax();
+        }
+        else if(m_round < m_policy.spinCount + m_policy.yieldCount)
+        {
+            std::this_thread::yield();
+        }
+        else
+        {
+            return false;
+        }
+        ++m_round;
+        return true;
+    }
+
+private:
+    IdlePolicy m_policy;
+    uint32_t   m_round = 0;
+};
 }  // namespace aph::thread
 #endif
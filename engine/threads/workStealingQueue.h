@@ -0,0 +1,162 @@
+#ifndef APH_WORK_STEALING_QUEUE_H_
+#define APH_WORK_STEALING_QUEUE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+#include "common/common.h"
+
+namespace aph
+{
+/*
+ * Lock-free Chase-Lev work-stealing deque.
+ *
+ * Only the owning thread may call push() and pop(), which operate on the bottom end in LIFO order.
+ * Any thread may call steal(), which takes items from the top end in FIFO order.
+ * The ring grows on demand; retired rings are kept alive until destruction since a thief may still be
+ * reading from them.
+ *
+ * Reference: "Correct and Efficient Work-Stealing for Weak Memory Models" (Le et al., PPoPP 2013).
+ */
+template <typename T>
+    requires std::is_trivially_copyable_v<T>
+class WorkStealingQueue
+{
+public:
+    explicit WorkStealingQueue(std::size_t capacity = 1024)
+    {
+        std::size_t cap = 1;
+        while(cap < capacity)
+        {
+            cap <<= 1;
+        }
+        m_array.store(new Array(static_cast<int64_t>(cap)), std::memory_order_relaxed);
+    }
+
+    ~WorkStealingQueue() { delete m_array.load(std::memory_order_relaxed); }
+
+    WorkStealingQueue(const WorkStealingQueue&)            = delete;
+    WorkStealingQueue& operator=(const WorkStealingQueue&) = delete;
+
+    // owner only
+    void push(T item)
+    {
+        int64_t b = m_bottom.load(std::memory_order_relaxed);
+        int64_t t = m_top.load(std::memory_order_acquire);
+        Array*  a = m_array.load(std::memory_order_relaxed);
+
+        if(b - t > a->capacity - 1)
+        {
+            a = grow(a, b, t);
+        }
+
+        a->put(b, item);
+        std::atomic_thread_fence(std::memory_order_release);
+        m_bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    // owner only
+    [[nodiscard]] std::optional<T> pop()
+    {
+        int64_t b = m_bottom.load(std::memory_order_relaxed) - 1;
+        Array*  a = m_array.load(std::memory_order_relaxed);
+        m_bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = m_top.load(std::memory_order_relaxed);
+
+        if(t > b)
+        {
+            // empty
+            m_bottom.store(b + 1, std::memory_order_relaxed);
+            return std::nullopt;
+        }
+
+        T item = a->get(b);
+        if(t == b)
+        {
+            // last item, race against thieves
+            bool won = m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            m_bottom.store(b + 1, std::memory_order_relaxed);
+            if(!won)
+            {
+                return std::nullopt;
+            }
+        }
+        return item;
+    }
+
+    // any thread
+    [[nodiscard]] std::optional<T> steal()
+    {
+        int64_t t = m_top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = m_bottom.load(std::memory_order_acquire);
+
+        if(t >= b)
+        {
+            return std::nullopt;
+        }
+
+        Array* a    = m_array.load(std::memory_order_acquire);
+        T      item = a->get(t);
+        if(!m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+            // lost the race against the owner or another thief
+            return std::nullopt;
+        }
+        return item;
+    }
+
+    [[nodiscard]] bool empty() const { return size() == 0; }
+
+    [[nodiscard]] std::size_t size() const
+    {
+        int64_t b = m_bottom.load(std::memory_order_relaxed);
+        int64_t t = m_top.load(std::memory_order_relaxed);
+        return b > t ? static_cast<std::size_t>(b - t) : 0;
+    }
+
+    [[nodiscard]] std::size_t capacity() const
+    {
+        return static_cast<std::size_t>(m_array.load(std::memory_order_relaxed)->capacity);
+    }
+
+private:
+    struct Array
+    {
+        explicit Array(int64_t cap) : capacity(cap), mask(cap - 1), data(std::make_unique<std::atomic<T>[]>(cap)) {}
+
+        void put(int64_t i, T item) { data[i & mask].store(item, std::memory_order_release); }
+        T    get(int64_t i) const { return data[i & mask].load(std::memory_order_acquire); }
+
+        int64_t                           capacity;
+        int64_t                           mask;
+        std::unique_ptr<std::atomic<T>[]> data;
+    };
+
+    Array* grow(Array* a, int64_t b, int64_t t)
+    {
+        auto* newArray = new Array(a->capacity * 2);
+        for(int64_t i = t; i != b; ++i)
+        {
+            newArray->put(i, a->get(i));
+        }
+        m_garbage.emplace_back(a);
+        m_array.store(newArray, std::memory_order_release);
+        return newArray;
+    }
+
+    alignas(CACHE_LINE_SIZE) std::atomic<int64_t> m_top{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<int64_t> m_bottom{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<Array*> m_array{nullptr};
+
+    // owner only
+    std::vector<std::unique_ptr<Array>> m_garbage;
+};
+}  // namespace aph
+
+#endif  // APH_WORK_STEALING_QUEUE_H_
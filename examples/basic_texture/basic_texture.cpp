@@ -48,51 +48,51 @@ void basic_texture::init()
         };
 
         // vertex buffer
-        APH_VR(m_pResourceLoader->loadAsync(
+        m_pResourceLoader->loadAsync(
             aph::BufferLoadInfo{.debugName  = "quad::vertexBuffer",
                                 .data       = vertices.data(),
                                 .createInfo = {.size  = static_cast<uint32_t>(vertices.size() * sizeof(vertices[0])),
                                                .usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT}},
-            &m_pVB));
+            &m_pVB);
 
         // index buffer
-        APH_VR(m_pResourceLoader->loadAsync(
+        m_pResourceLoader->loadAsync(
             aph::BufferLoadInfo{.data       = indices.data(),
                                 .createInfo = {.size  = static_cast<uint32_t>(indices.size() * sizeof(indices[0])),
                                                .usage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT}},
-            &m_pIB));
+            &m_pIB);
 
         // matrix uniform buffer
-        APH_VR(m_pResourceLoader->loadAsync(aph::BufferLoadInfo{.debugName = "matrix data",
-                                                                .data      = &m_modelMatrix,
-                                                                .createInfo =
-                                                                    {
-                                                                        .size   = sizeof(glm::mat4),
-                                                                        .usage  = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-                                                                        .domain = aph::BufferDomain::LinkedDeviceHost,
-                                                                    }},
-                                            &m_pMatBuffer));
+        m_pResourceLoader->loadAsync(aph::BufferLoadInfo{.debugName = "matrix data",
+                                                         .data      = &m_modelMatrix,
+                                                         .createInfo =
+                                                             {
+                                                                 .size   = sizeof(glm::mat4),
+                                                                 .usage  = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+                                                                 .domain = aph::BufferDomain::LinkedDeviceHost,
+                                                             }},
+                                     &m_pMatBuffer);
 
         // image and sampler
         APH_VR(m_pDevice->create(aph::vk::init::samplerCreateInfo(aph::SamplerPreset::LinearClamp), &m_pSampler));
-        APH_VR(m_pResourceLoader->loadAsync(aph::ImageLoadInfo{.data = "texture://container2.png",
-                                                               .createInfo =
-                                                                   {
-                                                                       .usage     = VK_IMAGE_USAGE_SAMPLED_BIT,
-                                                                       .domain    = aph::ImageDomain::Device,
-                                                                       .imageType = VK_IMAGE_TYPE_2D,
-                                                                   }},
-                                            &m_pImage));
+        m_pResourceLoader->loadAsync(aph::ImageLoadInfo{.data = "texture://container2.png",
+                                                        .createInfo =
+                                                            {
+                                                                .usage     = VK_IMAGE_USAGE_SAMPLED_BIT,
+                                                                .domain    = aph::ImageDomain::Device,
+                                                                .imageType = VK_IMAGE_TYPE_2D,
+                                                            }},
+                                     &m_pImage);
 
         // pipeline
-        APH_VR(m_pResourceLoader->loadAsync(
+        m_pResourceLoader->loadAsync(
             aph::ShaderLoadInfo{
                 .stageInfo =
                     {
                         {aph::ShaderStage::VS, {.data = "shader_slang://texture.slang", .entryPoint = "vertexMain"}},
                         {aph::ShaderStage::FS, {.data = "shader_slang://texture.slang", .entryPoint = "fragmentMain"}},
                     }},
-            &m_pProgram));
+            &m_pProgram);
         m_pResourceLoader->wait();
 
         // record graph execution
@@ -45,31 +45,31 @@ void triangle_demo::init()
         };
         constexpr std::array indexArray{0U, 1U, 2U};
 
-        APH_VR(m_pResourceLoader->loadAsync(
+        m_pResourceLoader->loadAsync(
             aph::BufferLoadInfo{
                 .debugName  = "triangle::vertexBuffer",
                 .data       = vertexArray.data(),
                 .createInfo = {.size  = static_cast<uint32_t>(vertexArray.size() * sizeof(vertexArray[0])),
                                .usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT}},
-            &m_pVB));
+            &m_pVB);
 
         // index buffer
-        APH_VR(m_pResourceLoader->loadAsync(
+        m_pResourceLoader->loadAsync(
             aph::BufferLoadInfo{.debugName  = "triangle::indexbuffer",
                                 .data       = indexArray.data(),
                                 .createInfo = {.size = static_cast<uint32_t>(indexArray.size() * sizeof(indexArray[0])),
                                                .usage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT}},
-            &m_pIB));
+            &m_pIB);
 
         // shader program
-        APH_VR(m_pResourceLoader->loadAsync(
+        m_pResourceLoader->loadAsync(
             aph::ShaderLoadInfo{
                 .stageInfo =
                     {
                         {aph::ShaderStage::VS, {.data = "shader_slang://triangle.slang", .entryPoint = "vertexMain"}},
                         {aph::ShaderStage::FS, {.data = "shader_slang://triangle.slang", .entryPoint = "fragmentMain"}},
                     }},
-            &m_pProgram));
+            &m_pProgram);
         m_pResourceLoader->wait();
 
         // record graph execution
@@ -0,0 +1,214 @@
+#include <catch2/catch_all.hpp>
+
+#include "threads/taskManager.h"
+
+using namespace aph;
+
+namespace
+{
+CoTask<int> square(int value)
+{
+    co_return value * value;
+}
+
+CoTask<void> loadStage(TaskManager& taskManager, std::atomic_int& decoded, std::atomic_int& uploaded)
+{
+    auto decode = taskManager.createTaskGroup("decode");
+    for(int i = 0; i < 4; ++i)
+    {
+        decode->addTask([&decoded]() { decoded++; });
+    }
+    co_await *decode;
+    taskManager.removeTaskGroup(decode);
+
+    auto upload = taskManager.createTaskGroup("upload");
+    upload->addTask([&uploaded]() { uploaded++; });
+    co_await *upload;
+    taskManager.removeTaskGroup(upload);
+}
+
+CoTask<void> fail()
+{
+    throw std::runtime_error("failed");
+    co_return;
+}
+}  // namespace
+
+TEST_CASE("Coroutine Awaits Task Group On A Single Worker")
+{
+    // a blocking wait inside the task would deadlock with only one worker
+    TaskManager taskManager{1, "CoTask Test"};
+
+    std::atomic_int decoded  = 0;
+    std::atomic_int uploaded = 0;
+
+    auto group = taskManager.createTaskGroup("load");
+    group->addTask(loadStage(taskManager, decoded, uploaded));
+    group->wait();
+    taskManager.removeTaskGroup(group);
+
+    REQUIRE(decoded == 4);
+    REQUIRE(uploaded == 1);
+}
+
+TEST_CASE("Nested Coroutines Return Values")
+{
+    TaskManager taskManager{2, "CoTask Test"};
+
+    std::atomic_int result = 0;
+
+    auto group = taskManager.createTaskGroup();
+    group->addTask([](std::atomic_int& out) -> CoTask<void> {
+        int a = co_await square(3);
+        int b = co_await square(4);
+        out   = a + b;
+    }(result));
+    group->wait();
+    taskManager.removeTaskGroup(group);
+
+    REQUIRE(result == 25);
+}
+
+TEST_CASE("Exceptions Propagate To The Awaiting Coroutine")
+{
+    TaskManager taskManager{2, "CoTask Test"};
+
+    std::atomic_bool caught = false;
+
+    auto group = taskManager.createTaskGroup();
+    group->addTask([](std::atomic_bool& out) -> CoTask<void> {
+        auto fail = []() -> CoTask<int> {
+            throw std::runtime_error("failed");
+            co_return 0;
+        };
+
+        try
+        {
+            co_await fail();
+        }
+        catch(const std::runtime_error&)
+        {
+            out = true;
+        }
+    }(caught));
+    group->wait();
+    taskManager.removeTaskGroup(group);
+
+    REQUIRE(caught);
+}
+
+TEST_CASE("Many Coroutines Share The Workers")
+{
+    TaskManager taskManager{4, "CoTask Test"};
+
+    constexpr int   pipelineCount = 64;
+    std::atomic_int decoded       = 0;
+    std::atomic_int uploaded      = 0;
+
+    auto group = taskManager.createTaskGroup("pipelines");
+    for(int i = 0; i < pipelineCount; ++i)
+    {
+        group->addTask(loadStage(taskManager, decoded, uploaded));
+    }
+
+    auto after = taskManager.createTaskGroup("after pipelines");
+    bool ran   = false;
+    after->addTask([&]() { ran = uploaded.load() == pipelineCount; });
+    taskManager.setDependency(after, group);
+
+    group->flush();
+    after->wait();
+
+    REQUIRE(decoded == pipelineCount * 4);
+    REQUIRE(uploaded == pipelineCount);
+    REQUIRE(ran);
+
+    taskManager.removeTaskGroup(group);
+    taskManager.removeTaskGroup(after);
+}
+
+TEST_CASE("Awaiting A Group Waits For Its Dependencies")
+{
+    TaskManager taskManager{1, "CoTask Test"};
+
+    std::atomic_bool opened  = false;
+    std::atomic_bool started = false;
+
+    auto gate = taskManager.createTaskGroup("gate");
+    gate->addTask([&opened]() { opened = true; });
+
+    // neither group can complete before the gate, even though the empty one has no task left to run
+    auto empty   = taskManager.createTaskGroup("empty");
+    auto blocked = taskManager.createTaskGroup("blocked");
+    blocked->addTask([]() {});
+    taskManager.setDependency(empty, gate);
+    taskManager.setDependency(blocked, gate);
+
+    std::array<bool, 2> openedAfter = {};
+
+    auto group = taskManager.createTaskGroup("await");
+    group->addTask([](TaskGroup* pEmpty, TaskGroup* pBlocked, std::atomic_bool& suspending,
+                      const std::atomic_bool& gateOpened, std::array<bool, 2>& out) -> CoTask<void> {
+        suspending = true;
+        co_await *pEmpty;
+        out[0] = gateOpened;
+        co_await *pBlocked;
+        out[1] = gateOpened;
+    }(empty, blocked, started, opened, openedAfter));
+    group->flush();
+
+    // let the coroutine suspend on the empty group before the gate opens
+    while(!started)
+    {
+        std::this_thread::yield();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    gate->flush();
+    group->wait();
+
+    REQUIRE(openedAfter[0]);
+    REQUIRE(openedAfter[1]);
+
+    for(TaskGroup* pGroup : {gate, empty, blocked, group})
+    {
+        taskManager.removeTaskGroup(pGroup);
+    }
+}
+
+TEST_CASE("Exceptions Of Coroutine Tasks Reach The Group")
+{
+    TaskManager taskManager{2, "CoTask Test"};
+
+    SECTION("co_await rethrows")
+    {
+        std::atomic_bool caught = false;
+
+        auto group = taskManager.createTaskGroup("outer");
+        group->addTask([](TaskManager& manager, std::atomic_bool& out) -> CoTask<void> {
+            auto inner = manager.createTaskGroup("inner");
+            inner->addTask(fail());
+            inner->addTask([]() {});
+            try
+            {
+                co_await *inner;
+            }
+            catch(const std::runtime_error&)
+            {
+                out = true;
+            }
+            manager.removeTaskGroup(inner);
+        }(taskManager, caught));
+        group->wait();
+        taskManager.removeTaskGroup(group);
+
+        REQUIRE(caught);
+    }
+
+    SECTION("wait rethrows")
+    {
+        auto group = taskManager.createTaskGroup("failing");
+        group->addTask(fail());
+        REQUIRE_THROWS_AS(group->wait(), std::runtime_error);
+        taskManager.removeTaskGroup(group);
+    }
+}
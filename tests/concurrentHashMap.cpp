@@ -0,0 +1,86 @@
+#include <catch2/catch_all.hpp>
+
+#include "common/concurrentHashMap.h"
+#include <thread>
+
+using namespace aph;
+
+TEST_CASE("basic operations")
+{
+    ConcurrentHashMap<std::string, int> map;
+    REQUIRE(map.empty());
+    REQUIRE(map.insert("a", 1));
+    REQUIRE_FALSE(map.insert("a", 2));
+    REQUIRE(map.find("a") == 1);
+    REQUIRE_FALSE(map.find("b").has_value());
+
+    map.insertOrAssign("a", 3);
+    map.insertOrAssign("b", 4);
+    REQUIRE(map.find("a") == 3);
+    REQUIRE(map.size() == 2);
+
+    int sum = 0;
+    map.forEach([&sum](const std::string& key, int value) { sum += value; });
+    REQUIRE(sum == 7);
+
+    REQUIRE(map.erase("a"));
+    REQUIRE_FALSE(map.erase("a"));
+    REQUIRE_FALSE(map.contains("a"));
+
+    map.clear();
+    REQUIRE(map.empty());
+}
+
+TEST_CASE("getOrCreate runs the factory once per key")
+{
+    constexpr uint32_t threadCount = 8;
+    constexpr uint32_t keyCount    = 64;
+
+    ConcurrentHashMap<uint32_t, uint32_t> map;
+    std::atomic_uint32_t                  created{0};
+    std::atomic_uint32_t                  mismatches{0};
+    std::atomic_bool                      start{false};
+
+    std::vector<std::thread> threads;
+    for(uint32_t t = 0; t < threadCount; ++t)
+    {
+        threads.emplace_back([&, t]() {
+            while(!start.load())
+            {
+                std::this_thread::yield();
+            }
+            for(uint32_t i = 0; i < keyCount * 4; ++i)
+            {
+                uint32_t key   = (i + t) % keyCount;
+                uint32_t value = map.getOrCreate(key, [&]() {
+                    created++;
+                    // keep the other threads waiting on the same key for a while
+                    std::this_thread::sleep_for(std::chrono::microseconds(100));
+                    return key * 10;
+                });
+                if(value != key * 10)
+                {
+                    mismatches++;
+                }
+            }
+        });
+    }
+    start = true;
+    for(auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    REQUIRE(created == keyCount);
+    REQUIRE(mismatches == 0);
+    REQUIRE(map.size() == keyCount);
+}
+
+TEST_CASE("a throwing factory caches nothing")
+{
+    ConcurrentHashMap<int, int> map;
+    REQUIRE_THROWS(map.getOrCreate(1, []() -> int { throw std::runtime_error("failed"); }));
+    REQUIRE_FALSE(map.contains(1));
+    REQUIRE(map.getOrCreate(1, []() { return 2; }) == 2);
+    REQUIRE(map.getOrCreate(1, []() { return 3; }) == 2);
+}
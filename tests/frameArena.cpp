@@ -0,0 +1,131 @@
+#include <catch2/catch_all.hpp>
+
+#include "allocator/frameArena.h"
+#include "common/hash.h"
+
+using namespace aph;
+
+TEST_CASE("Frame arena hands out aligned memory and recycles it in place")
+{
+    FrameArena arena{2, 4 * memory::KB};
+    arena.beginFrame(0);
+
+    void* first = arena.allocate(3, 1);
+    void* ptr   = arena.allocate(16, 64);
+    REQUIRE(reinterpret_cast<uintptr_t>(ptr) % 64 == 0);
+    REQUIRE(static_cast<std::byte*>(ptr) >= static_cast<std::byte*>(first) + 3);
+    REQUIRE(arena.getUsedSize() >= 19);
+
+    struct Pod
+    {
+        int   a;
+        float b;
+    };
+    Pod* pod = arena.create<Pod>(1, 2.0f);
+    REQUIRE(pod->a == 1);
+    REQUIRE(pod->b == 2.0f);
+
+    arena.beginFrame(0);
+    REQUIRE(arena.getUsedSize() == 0);
+    REQUIRE(arena.allocate(3, 1) == first);
+}
+
+TEST_CASE("Frames in flight keep their memory until they begin again")
+{
+    FrameArena arena{2, 4 * memory::KB};
+
+    arena.beginFrame(0);
+    auto* frame0 = arena.allocate<uint32_t>(16);
+    std::fill_n(frame0, 16, 0xAAAAAAAAu);
+
+    arena.beginFrame(1);
+    auto* frame1 = arena.allocate<uint32_t>(16);
+    std::fill_n(frame1, 16, 0xBBBBBBBBu);
+
+    REQUIRE(std::all_of(frame0, frame0 + 16, [](uint32_t v) { return v == 0xAAAAAAAAu; }));
+    REQUIRE(arena.getFrameIndex() == 1);
+}
+
+TEST_CASE("Overflow falls back to the heap and grows the block for the next round")
+{
+    FrameArena arena{1, 256};
+    arena.beginFrame(0);
+    REQUIRE(arena.getCapacity() == 256);
+
+    for(int i = 0; i < 16; ++i)
+    {
+        REQUIRE(arena.allocate(100) != nullptr);
+    }
+    REQUIRE(arena.getOverflowSize() > 0);
+
+    arena.beginFrame(0);
+    REQUIRE(arena.getCapacity() >= 1600);
+    REQUIRE(arena.getOverflowSize() == 0);
+
+    for(int i = 0; i < 16; ++i)
+    {
+        REQUIRE(arena.allocate(100) != nullptr);
+    }
+    REQUIRE(arena.getOverflowSize() == 0);
+}
+
+TEST_CASE("Pmr containers allocate from the frame arena")
+{
+    FrameArena arena{1};
+    arena.beginFrame(0);
+
+    std::pmr::vector<int> values{arena.getResource()};
+    values.reserve(128);
+    for(int i = 0; i < 128; ++i)
+    {
+        values.push_back(i);
+    }
+    REQUIRE(arena.getUsedSize() >= 128 * sizeof(int));
+
+    std::size_t             used = arena.getUsedSize();
+    pmr::HashMap<int, int>  map{arena.getResource()};
+    for(int i = 0; i < 64; ++i)
+    {
+        map[i] = i * 2;
+    }
+    REQUIRE(map.at(10) == 20);
+    REQUIRE(arena.getUsedSize() > used);
+    REQUIRE(arena.getOverflowSize() == 0);
+}
+
+TEST_CASE("Concurrent allocations never overlap")
+{
+    constexpr int threadCount = 4;
+    constexpr int allocCount  = 1024;
+
+    FrameArena arena{1, 64 * memory::KB};
+    arena.beginFrame(0);
+
+    std::vector<std::vector<uint8_t*>> ptrs(threadCount);
+    std::vector<std::thread>           threads;
+    for(int t = 0; t < threadCount; ++t)
+    {
+        threads.emplace_back([&, t]() {
+            for(int i = 0; i < allocCount; ++i)
+            {
+                auto* ptr = static_cast<uint8_t*>(arena.allocate(24, 8));
+                std::memset(ptr, t, 24);
+                ptrs[t].push_back(ptr);
+            }
+        });
+    }
+    for(auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    bool intact = true;
+    for(int t = 0; t < threadCount; ++t)
+    {
+        for(uint8_t* ptr : ptrs[t])
+        {
+            intact &= std::all_of(ptr, ptr + 24, [t](uint8_t v) { return v == t; });
+        }
+    }
+    REQUIRE(intact);
+}
@@ -0,0 +1,64 @@
+#include <catch2/catch_all.hpp>
+
+#include "allocator/hugePageArena.h"
+
+using namespace aph;
+using namespace aph::memory;
+
+TEST_CASE("small allocations stay on the heap")
+{
+    HugePageArena arena{4 * MB};
+    void*         ptr = arena.allocate(1024, 64);
+    REQUIRE(ptr);
+    REQUIRE(reinterpret_cast<uintptr_t>(ptr) % 64 == 0);
+
+    auto stats = arena.getStats();
+    REQUIRE(stats.liveCount == 1);
+    REQUIRE(stats.heapBytes == 1024);
+    REQUIRE(stats.mappedBytes == 0);
+
+    arena.free(ptr);
+    REQUIRE(arena.getStats().liveCount == 0);
+}
+
+TEST_CASE("large allocations are mapped in huge page units")
+{
+    HugePageArena     arena{4 * MB};
+    const std::size_t size = 9 * MB + 123;
+    auto*             ptr  = static_cast<uint8_t*>(arena.allocate(size));
+    REQUIRE(ptr);
+    std::memset(ptr, 0xab, size);
+    REQUIRE(ptr[size - 1] == 0xab);
+
+    auto stats = arena.getStats();
+    REQUIRE(stats.liveCount == 1);
+    REQUIRE(stats.requestedBytes == size);
+#if defined(__linux__)
+    REQUIRE(reinterpret_cast<uintptr_t>(ptr) % HUGE_PAGE_SIZE == 0);
+    REQUIRE(stats.mappedBytes == 10 * MB);
+    REQUIRE(stats.hugeTlbBytes + stats.thpBytes <= stats.mappedBytes);
+    REQUIRE(stats.coverage >= 0.0);
+    REQUIRE(stats.coverage <= 1.0);
+#endif
+
+    arena.free(ptr);
+    stats = arena.getStats();
+    REQUIRE(stats.liveCount == 0);
+    REQUIRE(stats.mappedBytes == 0);
+}
+
+TEST_CASE("pmr containers grow across the threshold")
+{
+    HugePageArena              arena{2 * MB};
+    std::pmr::vector<uint32_t> blob{arena.getResource()};
+    for(uint32_t i = 0; i < 1024 * 1024; ++i)
+    {
+        blob.push_back(i);
+    }
+    REQUIRE(blob[12345] == 12345);
+    REQUIRE(arena.getStats().liveCount == 1);
+
+    blob = {};
+    blob.shrink_to_fit();
+    REQUIRE(arena.getStats().liveCount == 0);
+}
@@ -0,0 +1,74 @@
+#include <catch2/catch_all.hpp>
+
+#include "common/inplaceFunction.h"
+
+using namespace aph;
+
+TEST_CASE("Empty InplaceFunction")
+{
+    InplaceFunction<void()> func;
+    REQUIRE(!func);
+
+    InplaceFunction<void()> null = nullptr;
+    REQUIRE(!null);
+}
+
+TEST_CASE("Invoke With Arguments And Return Value")
+{
+    int                                base = 10;
+    InplaceFunction<int(int, int), 32> func = [base](int a, int b) { return base + a * b; };
+
+    REQUIRE(func);
+    REQUIRE(func(2, 3) == 16);
+}
+
+TEST_CASE("Void Signature Discards The Return Value")
+{
+    int                     calls = 0;
+    InplaceFunction<void()> func  = [&calls]() { return ++calls; };
+
+    func();
+    REQUIRE(calls == 1);
+
+    // converting return types still work for non-void signatures
+    InplaceFunction<long(int)> widen = [](int value) { return value * 2; };
+    REQUIRE(widen(21) == 42);
+}
+
+TEST_CASE("Move Transfers The Callable")
+{
+    auto counter = std::make_shared<int>(0);
+
+    InplaceFunction<void()> a = [counter]() { (*counter)++; };
+    InplaceFunction<void()> b = std::move(a);
+
+    REQUIRE(!a);
+    REQUIRE(b);
+    b();
+    REQUIRE(*counter == 1);
+    REQUIRE(counter.use_count() == 2);
+
+    b = nullptr;
+    REQUIRE(counter.use_count() == 1);
+}
+
+TEST_CASE("Move-Only Captures")
+{
+    auto value = std::make_unique<int>(42);
+
+    InplaceFunction<int()> func = [v = std::move(value)]() { return *v; };
+    REQUIRE(func() == 42);
+}
+
+TEST_CASE("Reassignment Destroys The Previous Callable")
+{
+    auto first  = std::make_shared<int>(1);
+    auto second = std::make_shared<int>(2);
+
+    InplaceFunction<int()> func = [first]() { return *first; };
+    REQUIRE(first.use_count() == 2);
+
+    func = [second]() { return *second; };
+    REQUIRE(first.use_count() == 1);
+    REQUIRE(func() == 2);
+}
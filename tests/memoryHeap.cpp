@@ -0,0 +1,54 @@
+#include <catch2/catch_all.hpp>
+
+#include "allocator/memoryHeap.h"
+
+using namespace aph::memory;
+
+TEST_CASE("Memory heap allocates aligned blocks and frees them individually")
+{
+    MemoryHeap heap{"test"};
+    REQUIRE(heap.getName() == "test");
+
+    void* small   = heap.allocate(24);
+    void* aligned = heap.allocate(100, 256);
+    REQUIRE(small != nullptr);
+    REQUIRE(reinterpret_cast<uintptr_t>(aligned) % 256 == 0);
+    std::memset(aligned, 0xAB, 100);
+
+    heap.free(small);
+    heap.free(aligned);
+    heap.free(nullptr);
+}
+
+TEST_CASE("Memory heap releases everything at once on reset")
+{
+    MemoryHeap heap{"loader"};
+    for(int round = 0; round < 3; ++round)
+    {
+        // nothing is freed one by one, reset drops the whole round
+        for(int i = 0; i < 1000; ++i)
+        {
+            auto* ptr = static_cast<int*>(heap.allocate(sizeof(int) * (i % 64 + 1)));
+            REQUIRE(ptr != nullptr);
+            *ptr = i;
+        }
+        heap.reset();
+    }
+
+    void* ptr = heap.allocate(64);
+    REQUIRE(ptr != nullptr);
+}
+
+TEST_CASE("Memory heap backs pmr containers")
+{
+    MemoryHeap heap{"renderGraph"};
+    {
+        std::pmr::vector<std::pmr::string> names{heap.getResource()};
+        for(int i = 0; i < 100; ++i)
+        {
+            names.emplace_back("a string that does not fit the small buffer " + std::to_string(i));
+        }
+        REQUIRE(names[42].ends_with("42"));
+    }
+    heap.reset();
+}
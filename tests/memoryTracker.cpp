@@ -0,0 +1,174 @@
+#include <catch2/catch_all.hpp>
+
+#include "allocator/allocator.h"
+#include "allocator/memoryTracker.h"
+
+using namespace aph::memory;
+
+namespace
+{
+constexpr const char* RENDERER_FILE = "/src/engine/renderer/renderer.cpp";
+constexpr const char* THREADS_FILE  = "/src/engine/threads/taskManger.cpp";
+
+// distinct fake addresses, the tracker never dereferences them
+void* fakePtr(uintptr_t index)
+{
+    return reinterpret_cast<void*>(0x1000 + index * 16);
+}
+}  // namespace
+
+TEST_CASE("Memory tracker accounts per callsite and per subsystem")
+{
+    MemoryTracker tracker{false};
+
+    for(uintptr_t i = 0; i < 4; ++i)
+    {
+        tracker.onAllocate(fakePtr(i), 100, RENDERER_FILE, 10, "render");
+    }
+    tracker.onAllocate(fakePtr(10), 1000, THREADS_FILE, 20, "addTask");
+    tracker.onFree(fakePtr(0));
+    tracker.onFree(fakePtr(1));
+    // unknown pointers are ignored
+    tracker.onFree(fakePtr(99));
+
+    MemoryCounters total = tracker.getTotal();
+    REQUIRE(total.liveBytes == 1200);
+    REQUIRE(total.liveCount == 3);
+    REQUIRE(total.allocCount == 5);
+    REQUIRE(total.peakBytes == 1400);
+
+    auto callsites = tracker.getCallsites();
+    REQUIRE(callsites.size() == 2);
+    REQUIRE(callsites[0].line == 20);
+    REQUIRE(callsites[0].subsystem == "threads");
+    REQUIRE(callsites[1].line == 10);
+    REQUIRE(callsites[1].subsystem == "renderer");
+    REQUIRE(callsites[1].counters.liveBytes == 200);
+    REQUIRE(callsites[1].counters.peakBytes == 400);
+    REQUIRE(callsites[1].counters.allocCount == 4);
+
+    auto byCount = tracker.getCallsites(MemorySortKey::AllocCount);
+    REQUIRE(byCount[0].line == 10);
+
+    auto subsystems = tracker.getSubsystems();
+    REQUIRE(subsystems.size() == 2);
+    REQUIRE(subsystems[0].name == "threads");
+    REQUIRE(subsystems[1].counters.liveCount == 2);
+}
+
+TEST_CASE("Memory tag scopes override the subsystem of a callsite")
+{
+    MemoryTracker tracker{false};
+    {
+        MemoryTagScope scope{"scene"};
+        tracker.onAllocate(fakePtr(0), 64, RENDERER_FILE, 10, "render");
+        {
+            MemoryTagScope inner{"ui"};
+            tracker.onAllocate(fakePtr(1), 64, RENDERER_FILE, 10, "render");
+        }
+        tracker.onAllocate(fakePtr(2), 64, RENDERER_FILE, 10, "render");
+    }
+    tracker.onAllocate(fakePtr(3), 64, RENDERER_FILE, 10, "render");
+    REQUIRE(MemoryTagScope::GetCurrent() == nullptr);
+
+    aph::HashMap<std::string, std::size_t> liveBytes;
+    for(const auto& subsystem : tracker.getSubsystems())
+    {
+        liveBytes[subsystem.name] = subsystem.counters.liveBytes;
+    }
+    REQUIRE(liveBytes.size() == 3);
+    REQUIRE(liveBytes["scene"] == 128);
+    REQUIRE(liveBytes["ui"] == 64);
+    REQUIRE(liveBytes["renderer"] == 64);
+}
+
+TEST_CASE("Memory tracker reports leaks and snapshots")
+{
+    MemoryTracker tracker{false};
+    tracker.onAllocate(fakePtr(0), 4096, THREADS_FILE, 20, "addTask");
+    tracker.onAllocate(fakePtr(1), 16, "tools/\"quoted\".cpp", 5, "main");
+    tracker.onFree(fakePtr(1));
+
+    REQUIRE(tracker.reportLeaks() == 1);
+
+    std::string report = tracker.report();
+    REQUIRE(report.find("taskManger.cpp:20") != std::string::npos);
+    REQUIRE(report.find("4.0 KiB") != std::string::npos);
+
+    std::string json = tracker.toJson();
+    REQUIRE(json.find("\"subsystem\": \"threads\"") != std::string::npos);
+    REQUIRE(json.find("tools/\\\"quoted\\\".cpp") != std::string::npos);
+    REQUIRE(json.find("\"liveBytes\": 4096") != std::string::npos);
+
+    tracker.onFree(fakePtr(0));
+    REQUIRE(tracker.reportLeaks() == 0);
+}
+
+TEST_CASE("Memory tracker moves the record of a reallocated block")
+{
+    MemoryTracker tracker{false};
+
+    tracker.onAllocate(fakePtr(0), 100, RENDERER_FILE, 10, "render");
+
+    auto failedRealloc = [](void*, std::size_t) -> void* { return nullptr; };
+    REQUIRE(tracker.reallocate(fakePtr(0), 400, failedRealloc, THREADS_FILE, 20, "addTask") == nullptr);
+    REQUIRE(tracker.getTotal().liveBytes == 100);
+    REQUIRE(tracker.getCallsites()[0].line == 10);
+
+    auto movedRealloc = [](void*, std::size_t) -> void* { return fakePtr(1); };
+    REQUIRE(tracker.reallocate(fakePtr(0), 400, movedRealloc, THREADS_FILE, 20, "addTask") == fakePtr(1));
+    MemoryCounters total = tracker.getTotal();
+    REQUIRE(total.liveBytes == 400);
+    REQUIRE(total.liveCount == 1);
+    REQUIRE(total.allocCount == 2);
+
+    auto callsites = tracker.getCallsites();
+    REQUIRE(callsites[0].line == 20);
+    REQUIRE(callsites[0].counters.liveBytes == 400);
+    REQUIRE(callsites[1].counters.liveCount == 0);
+
+    REQUIRE(tracker.onFree(fakePtr(0)) == 0);
+    REQUIRE(tracker.onFree(fakePtr(1)) == 400);
+    REQUIRE(tracker.reportLeaks() == 0);
+}
+
+#ifdef APH_MEMORY_TRACKING
+TEST_CASE("Allocations through aph_malloc are tracked")
+{
+    auto& tracker = MemoryTracker::GetInstance();
+
+    std::size_t before = tracker.getTotal().liveBytes;
+    void*       ptr    = aph_malloc(333);
+    REQUIRE(tracker.getTotal().liveBytes == before + 333);
+
+    auto callsites = tracker.getCallsites();
+    bool found     = std::any_of(callsites.begin(), callsites.end(), [](const auto& callsite) {
+        return std::string_view{callsite.file}.ends_with("memoryTracker.cpp") && callsite.counters.liveBytes == 333;
+    });
+    REQUIRE(found);
+
+    aph_free(ptr);
+    REQUIRE(tracker.getTotal().liveBytes == before);
+}
+
+TEST_CASE("A failed aph_realloc leaves the tracker untouched")
+{
+    auto& tracker = MemoryTracker::GetInstance();
+
+    void*          ptr    = aph_malloc(256);
+    MemoryCounters before = tracker.getTotal();
+
+    REQUIRE(aph_realloc(ptr, std::numeric_limits<std::size_t>::max() / 2) == nullptr);
+    MemoryCounters after = tracker.getTotal();
+    REQUIRE(after.liveBytes == before.liveBytes);
+    REQUIRE(after.liveCount == before.liveCount);
+    REQUIRE(after.allocCount == before.allocCount);
+
+    ptr = aph_realloc(ptr, 512);
+    REQUIRE(tracker.getTotal().liveBytes == before.liveBytes + 256);
+    REQUIRE(tracker.getTotal().allocCount == before.allocCount + 1);
+
+    aph_free(ptr);
+    REQUIRE(tracker.getTotal().liveBytes == before.liveBytes - 256);
+}
+#endif
@@ -0,0 +1,205 @@
+#include <catch2/catch_all.hpp>
+
+#include "threads/mpmcQueue.h"
+
+using namespace aph;
+
+TEST_CASE("Values come out in FIFO order")
+{
+    MPMCQueue<int> queue(3);
+    REQUIRE(queue.capacity() == 4);
+
+    for(int i = 0; i < 4; ++i)
+    {
+        REQUIRE(queue.tryPush(i));
+    }
+    REQUIRE(!queue.tryPush(4));
+    REQUIRE(queue.size() == 4);
+
+    for(int i = 0; i < 4; ++i)
+    {
+        REQUIRE(queue.tryPop() == i);
+    }
+    REQUIRE(!queue.tryPop().has_value());
+    REQUIRE(queue.empty());
+}
+
+TEST_CASE("Batches stop at the capacity")
+{
+    MPMCQueue<std::unique_ptr<int>> queue(8);
+
+    std::vector<std::unique_ptr<int>> values;
+    for(int i = 0; i < 12; ++i)
+    {
+        values.push_back(std::make_unique<int>(i));
+    }
+
+    REQUIRE(queue.tryPushBatch(values) == 8);
+    REQUIRE(!values[7]);
+    REQUIRE(values[8]);
+    REQUIRE(queue.tryPushBatch(std::span{values}.subspan(8)) == 0);
+
+    std::vector<std::unique_ptr<int>> out(5);
+    REQUIRE(queue.tryPopBatch(out) == 5);
+    REQUIRE(*out[0] == 0);
+    REQUIRE(*out[4] == 4);
+
+    // the run wraps around the end of the ring
+    REQUIRE(queue.tryPushBatch(std::span{values}.subspan(8)) == 4);
+    REQUIRE(queue.tryPopBatch(out) == 5);
+    REQUIRE(*out[0] == 5);
+    REQUIRE(*out[4] == 9);
+    REQUIRE(queue.tryPopBatch(out) == 2);
+    REQUIRE(*out[1] == 11);
+    REQUIRE(queue.tryPopBatch(out) == 0);
+}
+
+TEST_CASE("Blocking push waits for room")
+{
+    MPMCQueue<int> queue(2);
+    REQUIRE(queue.push(0));
+    REQUIRE(queue.push(1));
+
+    std::atomic_bool pushed{false};
+    std::thread      producer{[&]() {
+        queue.push(2);
+        pushed = true;
+    }};
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    REQUIRE(!pushed);
+
+    REQUIRE(queue.pop() == 0);
+    producer.join();
+    REQUIRE(pushed);
+    REQUIRE(queue.pop() == 1);
+    REQUIRE(queue.pop() == 2);
+}
+
+TEST_CASE("Close wakes blocked consumers after draining")
+{
+    MPMCQueue<int> queue(4);
+
+    std::atomic_int          drained{0};
+    std::vector<std::thread> consumers;
+    for(int i = 0; i < 3; ++i)
+    {
+        consumers.emplace_back([&]() {
+            while(queue.pop())
+            {
+                drained++;
+            }
+        });
+    }
+
+    REQUIRE(queue.push(1));
+    REQUIRE(queue.push(2));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    queue.close();
+    for(auto& consumer : consumers)
+    {
+        consumer.join();
+    }
+
+    REQUIRE(drained == 2);
+    REQUIRE(queue.isClosed());
+    REQUIRE(!queue.push(3));
+    REQUIRE(!queue.pop().has_value());
+}
+
+TEST_CASE("Non-blocking pushes fail after close")
+{
+    MPMCQueue<int> queue(4);
+
+    REQUIRE(queue.tryPush(1));
+    queue.close();
+
+    REQUIRE(!queue.tryPush(2));
+    std::vector<int> values{3, 4};
+    REQUIRE(queue.tryPushBatch(values) == 0);
+
+    // what was pushed before the close is still drained
+    REQUIRE(queue.tryPop() == 1);
+    REQUIRE(!queue.tryPop().has_value());
+}
+
+TEST_CASE("Concurrent producers and consumers neither lose nor duplicate values")
+{
+    constexpr int producerCount = 4;
+    constexpr int consumerCount = 4;
+    constexpr int valueCount    = 1 << 16;
+
+    MPMCQueue<int> queue(64);
+
+    std::vector<std::atomic_int> seen(producerCount * valueCount);
+    std::vector<std::thread>     consumers;
+    for(int i = 0; i < consumerCount; ++i)
+    {
+        consumers.emplace_back([&, i]() {
+            // half of the consumers pop in batches
+            std::array<int, 16> batch;
+            for(;;)
+            {
+                if(i % 2)
+                {
+                    std::size_t count = queue.popBatch(batch);
+                    if(count == 0)
+                    {
+                        break;
+                    }
+                    for(std::size_t j = 0; j < count; ++j)
+                    {
+                        seen[batch[j]]++;
+                    }
+                }
+                else if(auto value = queue.pop())
+                {
+                    seen[value.value()]++;
+                }
+                else
+                {
+                    break;
+                }
+            }
+        });
+    }
+
+    std::vector<std::thread> producers;
+    for(int i = 0; i < producerCount; ++i)
+    {
+        producers.emplace_back([&, i]() {
+            std::array<int, 16> batch;
+            for(int value = 0; value < valueCount; value += batch.size())
+            {
+                for(std::size_t j = 0; j < batch.size(); ++j)
+                {
+                    batch[j] = i * valueCount + value + j;
+                }
+                if(i % 2)
+                {
+                    queue.pushBatch(batch);
+                }
+                else
+                {
+                    for(int v : batch)
+                    {
+                        queue.push(v);
+                    }
+                }
+            }
+        });
+    }
+
+    for(auto& producer : producers)
+    {
+        producer.join();
+    }
+    queue.close();
+    for(auto& consumer : consumers)
+    {
+        consumer.join();
+    }
+
+    bool exactlyOnce = std::all_of(seen.begin(), seen.end(), [](const auto& count) { return count == 1; });
+    REQUIRE(exactlyOnce);
+}
@@ -1,4 +1,4 @@
-#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_all.hpp>
 
 #include <thread>
 #include <set>
@@ -135,3 +135,98 @@ TEST_CASE("ThreadSafeObjectPool functionality", "[ThreadSafeObjectPool]")
         REQUIRE(counter == 1000);
     }
 }
+
+TEST_CASE("ThreadSafeObjectPool objects may be freed on another thread", "[ThreadSafeObjectPool]")
+{
+    ThreadSafeObjectPool<TestObject> pool;
+
+    // enough objects to spill through several magazines in both directions
+    std::vector<TestObject*> objects;
+    for(int i = 0; i < 1000; ++i)
+    {
+        objects.push_back(pool.allocate(i));
+    }
+
+    std::thread consumer{[&]() {
+        for(auto obj : objects)
+        {
+            pool.free(obj);
+        }
+    }};
+    consumer.join();
+
+    std::set<TestObject*> reused;
+    for(int i = 0; i < 1000; ++i)
+    {
+        reused.insert(pool.allocate(i));
+    }
+    REQUIRE(reused.size() == 1000);
+
+    // everything but what the exited thread's magazine still caches came back through the depot
+    std::size_t recycled = std::count_if(objects.begin(), objects.end(), [&](auto obj) { return reused.contains(obj); });
+    REQUIRE(recycled >= objects.size() - 2 * detail::POOL_MAGAZINE_SIZE);
+}
+
+TEMPLATE_TEST_CASE_SIG("ThreadSafeObjectPool never hands out a live object twice", "[ThreadSafeObjectPool]",
+                       ((PoolDepot Depot), Depot), PoolDepot::Locked, PoolDepot::LockFree)
+{
+    ThreadSafeObjectPool<TestObject, Depot> pool;
+
+    constexpr int            threadCount = 8;
+    std::atomic_bool         aliased{false};
+    std::vector<std::thread> threads;
+    for(int i = 0; i < threadCount; ++i)
+    {
+        threads.emplace_back([&, i]() {
+            std::vector<TestObject*> live;
+            for(int round = 0; round < 200; ++round)
+            {
+                for(int j = 0; j < 50; ++j)
+                {
+                    live.push_back(pool.allocate(i));
+                }
+                for(auto obj : live)
+                {
+                    aliased = aliased || obj->value != i;
+                }
+                // hand half of the objects to the pool from the middle so magazines churn
+                for(std::size_t j = 0; j < live.size(); j += 2)
+                {
+                    pool.free(live[j]);
+                }
+                std::erase_if(live, [&, j = 0](TestObject*) mutable { return j++ % 2 == 0; });
+            }
+            for(auto obj : live)
+            {
+                pool.free(obj);
+            }
+        });
+    }
+
+    for(auto& t : threads)
+    {
+        t.join();
+    }
+    REQUIRE(!aliased);
+}
+
+TEMPLATE_TEST_CASE_SIG("ThreadSafeObjectPool does not grow past a reservation", "[ThreadSafeObjectPool]",
+                       ((PoolDepot Depot), Depot), PoolDepot::Locked, PoolDepot::LockFree)
+{
+    ThreadSafeObjectPool<TestObject, Depot> pool;
+
+    pool.reserve(1000);
+    const std::size_t capacity = pool.getCapacity();
+    REQUIRE(capacity >= 1000);
+
+    std::vector<TestObject*> objects;
+    for(int i = 0; i < 1000; ++i)
+    {
+        objects.push_back(pool.allocate(i));
+    }
+    for(auto obj : objects)
+    {
+        pool.free(obj);
+    }
+    REQUIRE(pool.getCapacity() == capacity);
+}
@@ -0,0 +1,125 @@
+#include <catch2/catch_all.hpp>
+
+#include "allocator/slotMap.h"
+
+using namespace aph;
+
+namespace
+{
+struct Resource;
+using ResourceMap = SlotMap<Resource, uint64_t, std::string>;
+}  // namespace
+
+TEST_CASE("handles resolve to their fields")
+{
+    ResourceMap map;
+    auto        first  = map.insert(1u, "first");
+    auto        second = map.insert(2u, "second");
+
+    REQUIRE(map.size() == 2);
+    REQUIRE(first != second);
+    REQUIRE(*map.get(first) == 1);
+    REQUIRE(*map.get<1>(second) == "second");
+    REQUIRE(map.getDense().size() == 2);
+    REQUIRE(map.getHandle(1) == second);
+
+    Handle<Resource> null;
+    REQUIRE(null.isNull());
+    REQUIRE_FALSE(map.contains(null));
+    REQUIRE(map.get(null) == nullptr);
+
+    REQUIRE(Handle<Resource>::FromRaw(second.getRaw()) == second);
+}
+
+TEST_CASE("stale handles are detected after erase and slot reuse")
+{
+    ResourceMap map;
+    auto        first  = map.insert(1u, "first");
+    auto        second = map.insert(2u, "second");
+    auto        third  = map.insert(3u, "third");
+
+    REQUIRE(map.erase(first));
+    REQUIRE_FALSE(map.erase(first));
+    REQUIRE_FALSE(map.contains(first));
+    REQUIRE(map.get(first) == nullptr);
+
+    // the last element filled the hole, the handles still find it
+    REQUIRE(map.size() == 2);
+    REQUIRE(*map.get(third) == 3);
+    REQUIRE(*map.get<1>(second) == "second");
+
+    // same slot, new generation
+    auto reused = map.insert(4u, "reused");
+    REQUIRE(reused.getIndex() == first.getIndex());
+    REQUIRE(reused.getGeneration() != first.getGeneration());
+    REQUIRE(map.get(first) == nullptr);
+    REQUIRE(*map.get<1>(reused) == "reused");
+
+    map.clear();
+    REQUIRE(map.empty());
+    for(auto handle : {second, third, reused})
+    {
+        REQUIRE_FALSE(map.contains(handle));
+    }
+}
+
+TEST_CASE("a slot is retired instead of wrapping its generation")
+{
+    ResourceMap map;
+    auto        first  = map.insert(0u, "first");
+    auto        handle = first;
+    for(uint32_t i = 1; i < Handle<Resource>::MAX_GENERATION; ++i)
+    {
+        REQUIRE(map.erase(handle));
+        handle = map.insert(i, "churn");
+        REQUIRE(handle.getIndex() == first.getIndex());
+    }
+    REQUIRE(handle.getGeneration() == Handle<Resource>::MAX_GENERATION);
+
+    // the saturated slot is not reused, no handle it ever produced matches again
+    REQUIRE(map.erase(handle));
+    auto next = map.insert(1u, "next");
+    REQUIRE(next.getIndex() != first.getIndex());
+    for(auto stale : {first, handle})
+    {
+        REQUIRE_FALSE(map.contains(stale));
+        REQUIRE(map.get(stale) == nullptr);
+        REQUIRE_FALSE(map.erase(stale));
+    }
+    REQUIRE(map.size() == 1);
+}
+
+TEST_CASE("dense storage stays consistent under churn")
+{
+    SlotMap<Resource, uint32_t>                        map;
+    std::vector<std::pair<Handle<Resource>, uint32_t>> live;
+
+    uint32_t state = 0x12345678u;
+    for(uint32_t i = 0; i < 10000; ++i)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        if(live.empty() || state % 3)
+        {
+            live.emplace_back(map.insert(i), i);
+        }
+        else
+        {
+            auto pos = state % live.size();
+            REQUIRE(map.erase(live[pos].first));
+            live[pos] = live.back();
+            live.pop_back();
+        }
+    }
+
+    REQUIRE(map.size() == live.size());
+    for(auto [handle, value] : live)
+    {
+        REQUIRE(*map.get(handle) == value);
+    }
+    for(uint32_t i = 0; i < map.size(); ++i)
+    {
+        REQUIRE(*map.get(map.getHandle(i)) == map.getDense()[i]);
+    }
+}
@@ -92,3 +92,67 @@ TEST_CASE("Iterators")
     REQUIRE(*vec.rbegin() == 4);
     REQUIRE(*(vec.rend() - 1) == 1);
 }
+
+TEST_CASE("Growth past the inline storage")
+{
+    SmallVector<int, 4> vec;
+    REQUIRE(vec.isInline());
+    for(int i = 0; i < 100; ++i)
+    {
+        vec.push_back(i);
+    }
+    REQUIRE_FALSE(vec.isInline());
+    REQUIRE(vec.size() == 100);
+    for(int i = 0; i < 100; ++i)
+    {
+        REQUIRE(vec[i] == i);
+    }
+
+    // the argument refers to an element that moves when the vector grows
+    SmallVector<std::string, 2> strings = {"first", "second"};
+    strings.push_back(strings[0]);
+    REQUIRE(strings.back() == "first");
+
+    vec.resize(3);
+    vec.shrink_to_fit();
+    REQUIRE(vec.isInline());
+    REQUIRE(vec == SmallVector<int, 4>{0, 1, 2});
+}
+
+TEST_CASE("Moves steal heap buffers and relocate inline elements")
+{
+    SmallVector<std::unique_ptr<int>, 2> heap;
+    for(int i = 0; i < 8; ++i)
+    {
+        heap.push_back(std::make_unique<int>(i));
+    }
+    const auto* pData = heap.data();
+
+    SmallVector<std::unique_ptr<int>, 2> stolen{std::move(heap)};
+    REQUIRE(stolen.data() == pData);
+    REQUIRE(heap.empty());
+    REQUIRE(heap.isInline());
+
+    SmallVector<std::unique_ptr<int>, 2> small;
+    small.push_back(std::make_unique<int>(42));
+    stolen = std::move(small);
+    REQUIRE(stolen.isInline());
+    REQUIRE(stolen.size() == 1);
+    REQUIRE(*stolen[0] == 42);
+}
+
+TEST_CASE("Insert and erase")
+{
+    SmallVector<std::string, 4> vec = {"a", "d"};
+    vec.insert(vec.begin() + 1, {"b", "c"});
+    vec.insert(vec.end(), 2, "e");
+    vec.emplace(vec.begin(), "0");
+    REQUIRE(vec == SmallVector<std::string, 4>{"0", "a", "b", "c", "d", "e", "e"});
+
+    vec.erase(vec.begin());
+    vec.erase(vec.begin() + 1, vec.begin() + 3);
+    REQUIRE(vec == SmallVector<std::string, 4>{"a", "d", "e", "e"});
+
+    REQUIRE(erase_if(vec, [](const std::string& str) { return str == "e"; }) == 2);
+    REQUIRE(vec == SmallVector<std::string, 4>{"a", "d"});
+}
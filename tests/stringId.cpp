@@ -0,0 +1,65 @@
+#include <catch2/catch_all.hpp>
+
+#include "common/stringId.h"
+#include <thread>
+
+using namespace aph;
+using namespace aph::literals;
+
+TEST_CASE("ids match between compile time and runtime")
+{
+    static_assert("render target"_sid == StringId{"render target"});
+    static_assert("render target"_sid != "depth"_sid);
+    static_assert(StringId::Hash("") == StringId::FNV_OFFSET_BASIS);
+    // FNV-1a reference value
+    static_assert(StringId::Hash("a") == 0xaf63dc4c8601ec8cull);
+
+    std::string name = "render target";
+    REQUIRE(StringId{name} == "render target"_sid);
+    REQUIRE(StringId{std::string_view{name}.substr(0, 6)} == "render"_sid);
+    REQUIRE_FALSE(StringId{}.operator bool());
+    REQUIRE(StringId{}.isNull());
+
+    HashMap<StringId, int> map;
+    map["render target"_sid] = 1;
+    map[StringId{"depth"}]   = 2;
+    REQUIRE(map.at(StringId{name}) == 1);
+    REQUIRE(map.at("depth") == 2);
+}
+
+TEST_CASE("interned strings can be looked up by id")
+{
+    auto& table = StringTable::GetInstance();
+    auto  id    = table.intern(std::string{"gbuffer albedo"});
+    REQUIRE(id == "gbuffer albedo"_sid);
+    REQUIRE(id.getDebugName() == "gbuffer albedo");
+    REQUIRE(table.intern("gbuffer albedo") == id);
+    REQUIRE("never interned, only hashed"_sid.getDebugName().empty());
+
+    std::vector<std::thread> threads;
+    for(uint32_t t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&table]() {
+            for(uint32_t i = 0; i < 256; ++i)
+            {
+                table.intern("pass " + std::to_string(i));
+            }
+        });
+    }
+    for(auto& thread : threads)
+    {
+        thread.join();
+    }
+    REQUIRE(StringId{"pass 255"}.getDebugName() == "pass 255");
+}
+
+TEST_CASE("string maps look up views without building strings")
+{
+    StringMap<int> map;
+    map["shader"] = 1;
+
+    std::string_view input = "shader://mesh.slang";
+    REQUIRE(map.contains(input.substr(0, 6)));
+    REQUIRE(map.find("shader")->second == 1);
+    REQUIRE(map.find(std::string_view{"texture"}) == map.end());
+}
@@ -0,0 +1,165 @@
+#include <catch2/catch_all.hpp>
+
+#include "threads/taskGraph.h"
+
+using namespace aph;
+
+namespace
+{
+std::atomic<std::size_t> g_heapAllocationCount{0};
+}
+
+void* operator new(std::size_t size)
+{
+    g_heapAllocationCount.fetch_add(1, std::memory_order_relaxed);
+    if(void* ptr = std::malloc(size))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+TEST_CASE("Task Graph Runs Nodes After Their Predecessors")
+{
+    TaskManager taskManager(4, "Graph");
+    TaskGraph   graph{"diamond", TaskPriority::Normal, &taskManager};
+
+    std::mutex       orderLock;
+    std::vector<int> order;
+    auto             record = [&](int value) {
+        std::lock_guard<std::mutex> holder{orderLock};
+        order.push_back(value);
+    };
+
+    auto top    = graph.addNode([&]() { record(0); }, "top");
+    auto left   = graph.addNode([&]() { record(1); }, "left");
+    auto right  = graph.addNode([&]() { record(1); }, "right");
+    auto bottom = graph.addNode([&]() { record(2); }, "bottom");
+    graph.addEdge(top, left);
+    graph.addEdge(top, right);
+    graph.addEdge(left, bottom);
+    graph.addEdge(right, bottom);
+
+    graph.run();
+    graph.wait();
+
+    REQUIRE(order == std::vector{0, 1, 1, 2});
+}
+
+TEST_CASE("Task Graph Replays")
+{
+    TaskManager taskManager(4, "Graph");
+    TaskGraph   graph{"replay", TaskPriority::Normal, &taskManager};
+
+    std::atomic_int count = 0;
+
+    TaskGraph::NodeId previous = graph.addNode([&count]() { count++; });
+    for(int i = 1; i < 64; ++i)
+    {
+        TaskGraph::NodeId node = graph.addNode([&count]() { count++; });
+        graph.addEdge(previous, node);
+        // a few independent nodes between the chain links
+        graph.addNode([&count]() { count++; });
+        previous = node;
+    }
+
+    for(int frame = 0; frame < 100; ++frame)
+    {
+        graph.run();
+        graph.wait();
+        REQUIRE(graph.poll());
+    }
+
+    REQUIRE(count == 100 * 127);
+}
+
+TEST_CASE("Task Graph Replay Does Not Allocate")
+{
+    ScopedLogLevel logLevel{Logger::Level::Info};
+    TaskManager    taskManager(2, "Graph");
+    TaskGraph      graph{"frame", TaskPriority::Critical, &taskManager};
+
+    std::atomic_int count = 0;
+    auto            root  = graph.addNode([&count]() { count++; });
+    for(int i = 0; i < 32; ++i)
+    {
+        graph.addEdge(root, graph.addNode([&count]() { count++; }));
+    }
+
+    // the first run prepares the roots
+    graph.run();
+    graph.wait();
+
+    auto before = g_heapAllocationCount.load();
+    for(int frame = 0; frame < 100; ++frame)
+    {
+        graph.run();
+        graph.wait();
+    }
+    auto after = g_heapAllocationCount.load();
+
+    REQUIRE(count == 101 * 33);
+    REQUIRE(after == before);
+}
+
+TEST_CASE("Task Graph Can Be Recorded Again")
+{
+    TaskManager taskManager(2, "Graph");
+    TaskGraph   graph{"rerecord", TaskPriority::Normal, &taskManager};
+
+    int value = 0;
+    graph.addNode([&value]() { value = 1; });
+    graph.run();
+    graph.wait();
+    REQUIRE(value == 1);
+
+    graph.clear();
+    REQUIRE(graph.getNodeCount() == 0);
+
+    auto first = graph.addNode([&value]() { value *= 3; });
+    auto last  = graph.addNode([&value]() { value += 2; });
+    graph.addEdge(first, last);
+    graph.run();
+    graph.wait();
+    REQUIRE(value == 5);
+}
+
+TEST_CASE("Task Graph With A Cycle Is Not Run")
+{
+    TaskManager taskManager(2, "Graph");
+    TaskGraph   graph{"cycle", TaskPriority::Normal, &taskManager};
+
+    std::atomic_int count = 0;
+    auto            root  = graph.addNode([&count]() { count++; });
+    auto            a     = graph.addNode([&count]() { count++; });
+    auto            b     = graph.addNode([&count]() { count++; });
+    graph.addEdge(root, a);
+    graph.addEdge(a, b);
+    graph.addEdge(b, a);
+
+    REQUIRE(!graph.prepare());
+    REQUIRE(!graph.run());
+    REQUIRE(graph.poll());
+    // returns right away instead of waiting for nodes that can never run
+    graph.wait();
+    REQUIRE(count == 0);
+
+    // recording a fixed graph makes it runnable again
+    graph.clear();
+    auto first = graph.addNode([&count]() { count++; });
+    auto last  = graph.addNode([&count]() { count++; });
+    graph.addEdge(first, last);
+    REQUIRE(graph.run());
+    graph.wait();
+    REQUIRE(count == 2);
+}
@@ -4,6 +4,31 @@
 
 using namespace aph;
 
+namespace
+{
+std::atomic<std::size_t> g_heapAllocationCount{0};
+}
+
+void* operator new(std::size_t size)
+{
+    g_heapAllocationCount.fetch_add(1, std::memory_order_relaxed);
+    if(void* ptr = std::malloc(size))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
 TEST_CASE("Basic Task Creation and Execution")
 {
     TaskManager taskManager;
@@ -52,7 +77,7 @@ TEST_CASE("Multiple Tasks Execution")
 
     for(int i = 0; i < 5; i++)
     {
-        taskGroup->addTask([&count]() { count++; }, "CountTask" + std::to_string(i));
+        taskGroup->addTask([&count]() { count++; }, "CountTask");
     }
     taskGroup->flush();
     taskGroup->wait();
@@ -76,3 +101,727 @@ TEST_CASE("Polling for Task Completion")
 
     taskManager.removeTaskGroup(taskGroup);
 }
+
+TEST_CASE("Many Small Tasks Across Workers")
+{
+    TaskManager taskManager(8, "StealGroup");
+
+    std::atomic<int> count{0};
+    for(int round = 0; round < 10; round++)
+    {
+        auto first  = taskManager.createTaskGroup("First");
+        auto second = taskManager.createTaskGroup("Second");
+        for(int i = 0; i < 1000; i++)
+        {
+            first->addTask([&count]() { count.fetch_add(1, std::memory_order_relaxed); });
+            second->addTask([&count]() { count.fetch_add(1, std::memory_order_relaxed); });
+        }
+        // the second group is scheduled from a worker thread once the first one completes
+        taskManager.setDependency(second, first);
+        first->submit();
+        second->submit();
+    }
+    taskManager.wait();
+
+    REQUIRE(count.load() == 20000);
+}
+
+TEST_CASE("Scheduling More Tasks Than The Inboxes Hold")
+{
+    // the worker is parked while the main thread fills its inbox and has to be woken before the batch is done
+    TaskManager taskManager(1, "Overflow");
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+    std::atomic<int> count{0};
+    auto             group = taskManager.createTaskGroup("Overflow");
+    for(int i = 0; i < 20000; i++)
+    {
+        group->addTask([&count]() { count.fetch_add(1, std::memory_order_relaxed); });
+    }
+    group->wait();
+    taskManager.removeTaskGroup(group);
+
+    REQUIRE(count.load() == 20000);
+}
+
+TEST_CASE("Cancel Drops Tasks That Have Not Started")
+{
+    TaskManager taskManager(1, "Cancel");
+
+    std::atomic_bool started{false};
+    std::atomic_bool release{false};
+    std::atomic_int  count{0};
+
+    auto group = taskManager.createTaskGroup("streaming");
+    group->addTask([&]() {
+        started = true;
+        while(!release)
+        {
+            std::this_thread::yield();
+        }
+    });
+    for(int i = 0; i < 100; i++)
+    {
+        group->addTask([&count]() { count++; });
+    }
+    group->flush();
+
+    while(!started)
+    {
+        std::this_thread::yield();
+    }
+    group->cancel();
+    release = true;
+    group->wait();
+
+    REQUIRE(group->isCancelled());
+    REQUIRE(count == 0);
+    taskManager.removeTaskGroup(group);
+}
+
+TEST_CASE("Cancel Before Flush Still Notifies Dependees")
+{
+    TaskManager taskManager(2, "Cancel");
+
+    std::atomic_int  count{0};
+    std::atomic_bool continued{false};
+    std::atomic_bool dependeeRan{false};
+
+    auto group = taskManager.createTaskGroup("obsolete");
+    for(int i = 0; i < 100; i++)
+    {
+        group->addTask([&count]() { count++; });
+    }
+    auto dependee = taskManager.createTaskGroup("dependee");
+    dependee->addTask([&dependeeRan]() { dependeeRan = true; });
+    taskManager.setDependency(dependee, group);
+
+    group->cancel();
+    auto next = group->then([&continued]() { continued = true; });
+    group->flush();
+    dependee->wait();
+    next->wait();
+
+    REQUIRE(count == 0);
+    REQUIRE(dependeeRan);
+    // continuations are cancelled along with their group, plain dependees are not
+    REQUIRE(next->isCancelled());
+    REQUIRE(!continued);
+
+    taskManager.removeTaskGroup(group);
+    taskManager.removeTaskGroup(dependee);
+    taskManager.removeTaskGroup(next);
+}
+
+TEST_CASE("Wait For Times Out")
+{
+    TaskManager taskManager(2, "Timeout");
+
+    std::atomic_bool started{false};
+    std::atomic_bool release{false};
+
+    auto group = taskManager.createTaskGroup("slow");
+    group->addTask([&]() {
+        started = true;
+        while(!release)
+        {
+            std::this_thread::yield();
+        }
+    });
+    group->flush();
+    while(!started)
+    {
+        std::this_thread::yield();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    REQUIRE(!group->waitFor(std::chrono::milliseconds(20)));
+    REQUIRE(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(20));
+
+    release = true;
+    REQUIRE(group->waitFor(std::chrono::seconds(10)));
+    REQUIRE(group->poll());
+    taskManager.removeTaskGroup(group);
+}
+
+TEST_CASE("Continuations Run In Order")
+{
+    TaskManager taskManager(4, "Continuation");
+
+    std::atomic_int count{0};
+    std::atomic_int firstSaw{-1};
+    std::atomic_int secondSaw{-1};
+
+    auto group = taskManager.createTaskGroup("decode");
+    for(int i = 0; i < 64; i++)
+    {
+        group->addTask([&count]() { count++; });
+    }
+    auto first  = group->then([&]() { firstSaw = count.load(); }, "upload");
+    auto second = first->then([&]() { secondSaw = firstSaw.load(); }, "notify");
+    group->flush();
+    second->wait();
+
+    REQUIRE(firstSaw == 64);
+    REQUIRE(secondSaw == 64);
+
+    // a continuation of a completed group runs right away
+    std::atomic_bool late{false};
+    auto             third = group->then([&late]() { late = true; });
+    third->wait();
+    REQUIRE(late);
+
+    for(auto pGroup : {group, first, second, third})
+    {
+        taskManager.removeTaskGroup(pGroup);
+    }
+}
+
+TEST_CASE("Task Submission Does Not Allocate")
+{
+    ScopedLogLevel logLevel{Logger::Level::Info};
+    TaskManager    taskManager(2, "AllocGroup");
+
+    constexpr int    warmUpCount = 256;
+    constexpr int    frameCount  = 1000;
+    std::atomic<int> count{0};
+    auto             submitGroup = [&]() {
+        auto group = taskManager.createTaskGroup("Frame");
+        for(int i = 0; i < 8; i++)
+        {
+            group->addTask([&count]() { count.fetch_add(1, std::memory_order_relaxed); }, "Work");
+        }
+        group->submit();
+        taskManager.wait();
+    };
+
+    // the pools grow until the magazines of every thread are full
+    for(int frame = 0; frame < warmUpCount; ++frame)
+    {
+        submitGroup();
+    }
+
+    auto before = g_heapAllocationCount.load();
+    for(int frame = 0; frame < frameCount; ++frame)
+    {
+        submitGroup();
+    }
+    auto after = g_heapAllocationCount.load();
+
+    REQUIRE(count.load() == (warmUpCount + frameCount) * 8);
+    REQUIRE(after == before);
+}
+
+TEST_CASE("Parallel For Visits Every Index Once")
+{
+    TaskManager taskManager(4, "ParallelFor");
+
+    constexpr std::size_t         count = 100000;
+    std::vector<std::atomic<int>> visited(count);
+
+    taskManager.parallelFor({0, count}, 64, [&visited](std::size_t i) { visited[i].fetch_add(1); });
+
+    bool exactlyOnce = true;
+    for(auto& v : visited)
+    {
+        exactlyOnce = exactlyOnce && v.load() == 1;
+    }
+    REQUIRE(exactlyOnce);
+
+    std::atomic<std::size_t> covered{0};
+    taskManager.parallelFor({10, 20}, 100, [&covered](std::size_t begin, std::size_t end) {
+        covered.fetch_add(end - begin);
+    });
+    REQUIRE(covered.load() == 10);
+}
+
+TEST_CASE("Parallel Reduce")
+{
+    TaskManager taskManager(4, "ParallelReduce");
+
+    constexpr std::size_t count = 1 << 20;
+    uint64_t              sum   = taskManager.parallelReduce(
+        IndexRange{0, count}, 1024, uint64_t{0},
+        [](std::size_t begin, std::size_t end) {
+            uint64_t partial = 0;
+            for(std::size_t i = begin; i < end; ++i)
+            {
+                partial += i;
+            }
+            return partial;
+        },
+        [](uint64_t a, uint64_t b) { return a + b; });
+
+    REQUIRE(sum == uint64_t(count) * (count - 1) / 2);
+}
+
+TEST_CASE("Removed Groups Return To The Pools")
+{
+    TaskManager taskManager(2, "Release");
+
+    std::atomic<std::size_t> sum      = 0;
+    auto                     runFrame = [&]() {
+        taskManager.parallelFor({0, 256}, 16, [&sum](std::size_t i) { sum.fetch_add(i, std::memory_order_relaxed); });
+
+        auto first  = taskManager.createTaskGroup("first");
+        auto second = taskManager.createTaskGroup("second");
+        first->addTask([&sum]() { sum++; });
+        second->addTask([&sum]() { sum++; });
+        taskManager.setDependency(second, first);
+        // removed long before it runs, its dependency still notifies it
+        taskManager.removeTaskGroup(second->then([&sum]() { sum++; }));
+        first->submit();
+        second->submit();
+        taskManager.wait();
+    };
+
+    for(int frame = 0; frame < 256; ++frame)
+    {
+        runFrame();
+    }
+
+    // the magazines of every thread may still fill up and grow the pools by a block, a leak would grow them by four
+    // groups per frame
+    constexpr int frameCount = 2000;
+    auto          capacity   = taskManager.getPoolCapacity();
+    for(int frame = 0; frame < frameCount; ++frame)
+    {
+        runFrame();
+    }
+
+    REQUIRE(sum.load() == (256 + frameCount) * (255 * 256 / 2 + 3));
+    REQUIRE(taskManager.getPoolCapacity() - capacity < frameCount);
+}
+
+TEST_CASE("Higher Priority Lanes Run First")
+{
+    TaskManager taskManager(1, "Priority");
+
+    std::atomic_bool started = false;
+    std::atomic_bool release = false;
+
+    auto gate = taskManager.createTaskGroup("gate");
+    gate->addTask([&]() {
+        started = true;
+        while(!release)
+        {
+            std::this_thread::yield();
+        }
+    });
+    gate->flush();
+    while(!started)
+    {
+        std::this_thread::yield();
+    }
+
+    // only touched by the single worker, the test polls instead of waiting so it never runs a task itself
+    std::vector<TaskPriority> order;
+
+    SmallVector<TaskGroup*> groups;
+    for(auto priority : {TaskPriority::Background, TaskPriority::Normal, TaskPriority::Critical})
+    {
+        auto group = taskManager.createTaskGroup("lane", priority);
+        group->addTask([&order, priority]() { order.push_back(priority); });
+        group->flush();
+        groups.push_back(group);
+    }
+
+    release = true;
+    for(auto group : groups)
+    {
+        while(!group->poll())
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    REQUIRE(order == std::vector{TaskPriority::Critical, TaskPriority::Normal, TaskPriority::Background});
+
+    taskManager.removeTaskGroup(gate);
+    for(auto group : groups)
+    {
+        taskManager.removeTaskGroup(group);
+    }
+}
+
+TEST_CASE("Critical Latency Under Background Load")
+{
+    using namespace std::chrono;
+
+    TaskManager taskManager(2, "Latency");
+
+    constexpr int   backgroundTaskCount = 200;
+    std::atomic_int backgroundCompleted = 0;
+
+    // roughly 200ms of work per worker
+    auto background = taskManager.createTaskGroup("streaming", TaskPriority::Background);
+    for(int i = 0; i < backgroundTaskCount; ++i)
+    {
+        background->addTask([&backgroundCompleted]() {
+            std::this_thread::sleep_for(milliseconds(2));
+            backgroundCompleted++;
+        });
+    }
+    background->flush();
+    std::this_thread::sleep_for(milliseconds(5));
+
+    double maxLatency = 0.0;
+    for(int i = 0; i < 10; ++i)
+    {
+        std::atomic<steady_clock::time_point> startTime;
+
+        auto critical   = taskManager.createTaskGroup("frame", TaskPriority::Critical);
+        auto submitTime = steady_clock::now();
+        critical->addTask([&startTime]() { startTime = steady_clock::now(); });
+        // a blocking wait would run the task on this thread, the latency of the workers is measured
+        while(!critical->poll())
+        {
+            std::this_thread::yield();
+        }
+        taskManager.removeTaskGroup(critical);
+
+        maxLatency = std::max(maxLatency, duration<double, std::milli>(startTime.load() - submitTime).count());
+        std::this_thread::sleep_for(milliseconds(5));
+    }
+
+    // the pool was still saturated while the critical tasks ran
+    REQUIRE(backgroundCompleted.load() < backgroundTaskCount);
+
+    // a critical task waits for at most one background task per worker, not for the whole backlog
+    REQUIRE(maxLatency < 50.0);
+
+    background->wait();
+    taskManager.removeTaskGroup(background);
+}
+
+TEST_CASE("Blocking IO Lane Does Not Occupy CPU Workers")
+{
+    TaskManager taskManager(1, "BlockingIO", 1);
+
+    std::atomic_bool computed    = false;
+    std::atomic_bool ioSawResult = false;
+
+    // the io task blocks until the cpu task has run, which needs the single cpu worker to be free
+    auto io = taskManager.createTaskGroup("io", TaskPriority::BlockingIO);
+    io->addTask([&]() {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while(!computed && std::chrono::steady_clock::now() < deadline)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        ioSawResult = computed.load();
+    });
+    io->flush();
+
+    auto cpu = taskManager.createTaskGroup("cpu");
+    cpu->addTask([&computed]() { computed = true; });
+    cpu->flush();
+
+    io->wait();
+    cpu->wait();
+
+    REQUIRE(ioSawResult);
+
+    taskManager.removeTaskGroup(io);
+    taskManager.removeTaskGroup(cpu);
+}
+
+TEST_CASE("Blocking IO Without IO Threads Runs On Workers")
+{
+    TaskManager taskManager(2, "NoIOThreads", 0);
+
+    std::atomic_int counter = 0;
+
+    auto io = taskManager.createTaskGroup("io", TaskPriority::BlockingIO);
+    for(int i = 0; i < 64; i++)
+    {
+        io->addTask([&counter]() { counter++; });
+    }
+    io->flush();
+    io->wait();
+
+    REQUIRE(counter == 64);
+
+    taskManager.removeTaskGroup(io);
+}
+
+TEST_CASE("Waiting Thread Helps With Ready Tasks")
+{
+    TaskManager taskManager(1, "Help");
+
+    std::atomic_bool started = false;
+    std::atomic_bool release = false;
+
+    // keep the only worker busy so the waiting thread has to run the group itself
+    auto gate = taskManager.createTaskGroup("gate");
+    gate->addTask([&]() {
+        started = true;
+        while(!release)
+        {
+            std::this_thread::yield();
+        }
+    });
+    gate->flush();
+    while(!started)
+    {
+        std::this_thread::yield();
+    }
+
+    const auto      waitingThread = std::this_thread::get_id();
+    std::atomic_int helped        = 0;
+
+    auto group = taskManager.createTaskGroup("work");
+    for(int i = 0; i < 16; ++i)
+    {
+        group->addTask([&]() {
+            if(std::this_thread::get_id() == waitingThread)
+            {
+                helped++;
+            }
+        });
+    }
+    group->wait();
+
+    REQUIRE(helped == 16);
+
+    release = true;
+    taskManager.wait();
+
+    taskManager.removeTaskGroup(gate);
+    taskManager.removeTaskGroup(group);
+}
+
+TEST_CASE("Waiting Thread Does Not Help With Lower Priority Tasks")
+{
+    TaskManager taskManager(1, "Help Priority");
+
+    std::atomic_bool started = false;
+    std::atomic_bool release = false;
+
+    auto gate = taskManager.createTaskGroup("gate");
+    gate->addTask([&]() {
+        started = true;
+        while(!release)
+        {
+            std::this_thread::yield();
+        }
+    });
+    gate->flush();
+    while(!started)
+    {
+        std::this_thread::yield();
+    }
+
+    const auto      waitingThread = std::this_thread::get_id();
+    std::atomic_int helped        = 0;
+    auto            countHelp     = [&]() {
+        if(std::this_thread::get_id() == waitingThread)
+        {
+            helped++;
+        }
+    };
+
+    SmallVector<TaskGroup*> groups;
+    for(auto priority : {TaskPriority::Background, TaskPriority::Normal})
+    {
+        auto group = taskManager.createTaskGroup("lower", priority);
+        for(int i = 0; i < 4; ++i)
+        {
+            group->addTask(countHelp);
+        }
+        group->flush();
+        groups.push_back(group);
+    }
+
+    auto critical = taskManager.createTaskGroup("frame", TaskPriority::Critical);
+    critical->addTask(countHelp);
+    critical->wait();
+    REQUIRE(helped == 1);
+
+    // the worker is still blocked, the normal tasks are run here but the background ones wait for the worker
+    groups[1]->wait();
+    REQUIRE(helped == 5);
+
+    release = true;
+    taskManager.wait();
+    REQUIRE(helped == 5);
+
+    taskManager.removeTaskGroup(gate);
+    taskManager.removeTaskGroup(critical);
+    for(auto group : groups)
+    {
+        taskManager.removeTaskGroup(group);
+    }
+}
+
+TEST_CASE("Waiting Worker Runs Lower Priority Dependencies")
+{
+    // the only worker waits on a critical group that depends on a normal one, nobody else is left to run that one
+    TaskManager taskManager(1, "Help Dependencies");
+
+    std::atomic_int order = 0;
+
+    auto outer = taskManager.createTaskGroup("outer");
+    outer->addTask([&]() {
+        auto frame  = taskManager.createTaskGroup("frame", TaskPriority::Critical);
+        auto upload = taskManager.createTaskGroup("upload", TaskPriority::Normal);
+        upload->addTask([&order]() { order = 1; });
+        frame->addTask([&order]() { order = order == 1 ? 2 : -1; });
+        taskManager.setDependency(frame, upload);
+
+        upload->flush();
+        frame->flush();
+        frame->wait();
+
+        taskManager.removeTaskGroup(frame);
+        taskManager.removeTaskGroup(upload);
+    });
+    outer->flush();
+
+    // polls instead of waiting, a waiting test thread would run the normal group itself
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{10};
+    while(!outer->poll() && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::yield();
+    }
+    REQUIRE(outer->poll());
+    REQUIRE(order == 2);
+
+    taskManager.removeTaskGroup(outer);
+}
+
+TEST_CASE("Waiting Worker Runs Tasks Scheduled After It Slept")
+{
+    // the only worker sleeps in a wait on a group whose dependency is only submitted afterwards by this thread
+    TaskManager taskManager(1, "Late Dependencies");
+
+    std::atomic_bool waiting = false;
+    std::atomic_int  order   = 0;
+
+    auto late   = taskManager.createTaskGroup("late", TaskPriority::Background);
+    auto waited = taskManager.createTaskGroup("waited", TaskPriority::Background);
+    late->addTask([&order]() { order = 1; });
+    waited->addTask([&order]() { order = order == 1 ? 2 : -1; });
+    taskManager.setDependency(waited, late);
+    waited->flush();
+
+    auto outer = taskManager.createTaskGroup("outer");
+    outer->addTask([&]() {
+        waiting = true;
+        waited->wait();
+    });
+    outer->flush();
+
+    while(!waiting)
+    {
+        std::this_thread::yield();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    late->flush();
+
+    // polls instead of waiting, this thread must not be the one running the late group
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{10};
+    while(!outer->poll() && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::yield();
+    }
+    REQUIRE(outer->poll());
+    REQUIRE(order == 2);
+
+    taskManager.removeTaskGroup(outer);
+    taskManager.removeTaskGroup(waited);
+    taskManager.removeTaskGroup(late);
+}
+
+TEST_CASE("Nested Parallel For Inside A Task")
+{
+    // the outer task waits on the nested range from the only worker, which has to help instead of blocking
+    TaskManager taskManager(1, "Nested");
+
+    std::atomic<std::size_t> sum = 0;
+
+    auto group = taskManager.createTaskGroup("outer");
+    group->addTask([&]() {
+        taskManager.parallelFor({0, 1000}, 10, [&sum](std::size_t i) { sum.fetch_add(i); });
+    });
+    group->wait();
+
+    REQUIRE(sum.load() == 999 * 1000 / 2);
+    taskManager.removeTaskGroup(group);
+}
+
+TEST_CASE("Task Contexts Share One Manager")
+{
+    TaskManager taskManager(2, "Shared");
+    TaskContext loader{"Loader", TaskPriority::Background, &taskManager};
+    TaskContext renderer{"Renderer", TaskPriority::Critical, &taskManager};
+
+    std::atomic_bool release = false;
+    std::atomic_bool loaded  = false;
+
+    auto streaming = loader.createTaskGroup("streaming");
+    streaming->addTask([&]() {
+        while(!release)
+        {
+            std::this_thread::yield();
+        }
+        loaded = true;
+    });
+    loader.submit(streaming);
+
+    std::atomic_int recorded = 0;
+    for(int i = 0; i < 4; ++i)
+    {
+        auto group = renderer.createTaskGroup("record");
+        group->addTask([&recorded]() { recorded++; });
+        renderer.submit(group);
+    }
+
+    // only waits for the renderer's own groups, the loader is still blocked
+    renderer.wait();
+    REQUIRE(recorded == 4);
+    REQUIRE(!loaded);
+
+    release = true;
+    loader.wait();
+    REQUIRE(loaded);
+}
+
+
+TEST_CASE("Task Context Groups Return To The Pools")
+{
+    TaskManager taskManager(2, "Context Release");
+    TaskContext context{"Frame", TaskPriority::Normal, &taskManager};
+
+    std::atomic_int count    = 0;
+    auto            runFrame = [&](int frame) {
+        auto group = context.createTaskGroup("frame");
+        group->addTask([&count]() { count++; });
+        context.submit(group);
+        // half of the frames never wait on the context, their deps are released by the next createTaskGroup()
+        if(frame % 2)
+        {
+            context.wait();
+        }
+        else
+        {
+            taskManager.wait();
+        }
+    };
+
+    for(int frame = 0; frame < 256; ++frame)
+    {
+        runFrame(frame);
+    }
+
+    // a leak would grow the deps pool by one group per frame
+    constexpr int frameCount = 2000;
+    auto          capacity   = taskManager.getPoolCapacity();
+    for(int frame = 0; frame < frameCount; ++frame)
+    {
+        runFrame(frame);
+    }
+
+    REQUIRE(count == 256 + frameCount);
+    REQUIRE(taskManager.getPoolCapacity() - capacity < frameCount);
+}
@@ -0,0 +1,171 @@
+#include <catch2/catch_all.hpp>
+
+#include <sstream>
+
+#include "threads/taskManager.h"
+
+using namespace aph;
+
+TEST_CASE("Profiler Records Tasks Per Group")
+{
+    TaskManager taskManager{4, "Profiler Test"};
+    auto&       profiler = taskManager.getProfiler();
+    profiler.setEnabled(true);
+
+    auto decode = taskManager.createTaskGroup("decode");
+    auto upload = taskManager.createTaskGroup("upload");
+    for(int i = 0; i < 32; ++i)
+    {
+        decode->addTask([]() { std::this_thread::sleep_for(std::chrono::microseconds(50)); }, "decode image");
+    }
+    for(int i = 0; i < 8; ++i)
+    {
+        upload->addTask([]() {}, "upload image");
+    }
+    decode->flush();
+    upload->flush();
+    taskManager.wait();
+    profiler.setEnabled(false);
+
+    taskManager.removeTaskGroup(decode);
+    taskManager.removeTaskGroup(upload);
+
+    auto histograms = profiler.buildGroupHistograms();
+    REQUIRE(histograms.contains("decode"));
+    REQUIRE(histograms.contains("upload"));
+    REQUIRE(histograms["decode"].count == 32);
+    REQUIRE(histograms["upload"].count == 8);
+    REQUIRE(histograms["decode"].minNs >= 50'000);
+    REQUIRE(histograms["decode"].percentile(0.5) >= histograms["decode"].minNs);
+    REQUIRE(histograms["decode"].percentile(0.5) <= histograms["decode"].maxNs * 2);
+
+    std::size_t taskCount = 0;
+    for(uint32_t thread = 0; thread <= profiler.getThreadCount(); ++thread)
+    {
+        for(const auto& event : profiler.collect(thread))
+        {
+            if(event.type == TaskProfiler::Event::Type::Task)
+            {
+                REQUIRE(event.endNs >= event.beginNs);
+                taskCount++;
+            }
+        }
+    }
+    REQUIRE(taskCount == 40);
+}
+
+TEST_CASE("Profiler Exports Chrome Trace")
+{
+    TaskManager taskManager{2, "Profiler Test"};
+    auto&       profiler = taskManager.getProfiler();
+    profiler.setEnabled(true);
+
+    auto group = taskManager.createTaskGroup("trace \"group\"");
+    group->addTask([]() {}, "traced task");
+    group->wait();
+    taskManager.removeTaskGroup(group);
+    profiler.setEnabled(false);
+
+    std::ostringstream out;
+    profiler.exportChromeTrace(out);
+    std::string trace = out.str();
+
+    REQUIRE(trace.find("\"traceEvents\"") != std::string::npos);
+    REQUIRE(trace.find("\"ph\":\"X\"") != std::string::npos);
+    REQUIRE(trace.find("\"traced task\"") != std::string::npos);
+    REQUIRE(trace.find("trace \\\"group\\\"") != std::string::npos);
+    REQUIRE(trace.front() == '{');
+    REQUIRE(trace.find_last_not_of("\n") == trace.rfind('}'));
+}
+
+TEST_CASE("Disabled Profiler Records Nothing")
+{
+    TaskManager taskManager{2, "Profiler Test"};
+    auto&       profiler = taskManager.getProfiler();
+
+    auto group = taskManager.createTaskGroup("quiet");
+    for(int i = 0; i < 16; ++i)
+    {
+        group->addTask([]() {});
+    }
+    group->wait();
+    taskManager.removeTaskGroup(group);
+
+    REQUIRE(profiler.buildGroupHistograms().empty());
+    for(uint32_t thread = 0; thread <= profiler.getThreadCount(); ++thread)
+    {
+        REQUIRE(profiler.collect(thread).empty());
+    }
+}
+
+TEST_CASE("Full Ring Keeps The Latest Events")
+{
+    TaskProfiler profiler{1, 8};
+    profiler.setEnabled(true);
+
+    for(uint32_t i = 0; i < 20; ++i)
+    {
+        profiler.record(0, {.type = TaskProfiler::Event::Type::Task, .arg = i, .beginNs = i, .endNs = i + 1});
+    }
+
+    auto events = profiler.collect(0);
+    REQUIRE(events.size() == 8);
+    REQUIRE(events.front().arg == 12);
+    REQUIRE(events.back().arg == 19);
+
+    profiler.reset();
+    REQUIRE(profiler.collect(0).empty());
+}
+
+TEST_CASE("Profiler Records Steals From Inboxes")
+{
+    TaskManager taskManager{1, "Profiler Test"};
+    auto&       profiler = taskManager.getProfiler();
+
+    std::atomic_bool started = false;
+    std::atomic_bool release = false;
+
+    // keep the only worker busy, the tasks below stay in its inbox until the waiting thread takes them
+    auto gate = taskManager.createTaskGroup("gate");
+    gate->addTask([&]() {
+        started = true;
+        while(!release)
+        {
+            std::this_thread::yield();
+        }
+    });
+    gate->flush();
+    while(!started)
+    {
+        std::this_thread::yield();
+    }
+
+    profiler.setEnabled(true);
+    auto group = taskManager.createTaskGroup("stolen");
+    for(int i = 0; i < 4; ++i)
+    {
+        group->addTask([]() {}, "stolen task");
+    }
+    group->wait();
+    profiler.setEnabled(false);
+
+    release = true;
+    taskManager.wait();
+    taskManager.removeTaskGroup(gate);
+    taskManager.removeTaskGroup(group);
+
+    std::size_t stealCount = 0;
+    for(uint32_t thread = 0; thread <= profiler.getThreadCount(); ++thread)
+    {
+        for(const auto& event : profiler.collect(thread))
+        {
+            if(event.type == TaskProfiler::Event::Type::Steal)
+            {
+                REQUIRE(event.arg == 0);
+                REQUIRE(std::string_view{event.name} == "stolen task");
+                stealCount++;
+            }
+        }
+    }
+    REQUIRE(stealCount == 4);
+}
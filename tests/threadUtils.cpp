@@ -0,0 +1,138 @@
+#include <catch2/catch_all.hpp>
+
+#include "threads/taskManager.h"
+#include "threads/threadUtils.h"
+
+using namespace aph;
+
+namespace
+{
+void writeFile(const std::filesystem::path& path, const std::string& content)
+{
+    std::filesystem::create_directories(path.parent_path());
+    std::ofstream{path} << content << "\n";
+}
+
+// 2 packages x 2 cores x 2 hardware threads, one L3 and NUMA node per package
+std::filesystem::path makeFakeTopology()
+{
+    auto root = std::filesystem::temp_directory_path() / "aph_fake_cpu_topology";
+    std::filesystem::remove_all(root);
+
+    writeFile(root / "online", "0-7");
+    for(uint32_t cpu = 0; cpu < 8; ++cpu)
+    {
+        uint32_t package = cpu / 4;
+        uint32_t core    = cpu % 4 / 2;
+        uint32_t first   = package * 4 + core * 2;
+
+        auto cpuDir = root / ("cpu" + std::to_string(cpu));
+        writeFile(cpuDir / "topology" / "physical_package_id", std::to_string(package));
+        writeFile(cpuDir / "topology" / "thread_siblings_list",
+                  std::to_string(first) + "-" + std::to_string(first + 1));
+        writeFile(cpuDir / "cache" / "index0" / "level", "1");
+        writeFile(cpuDir / "cache" / "index0" / "shared_cpu_list",
+                  std::to_string(first) + "-" + std::to_string(first + 1));
+        writeFile(cpuDir / "cache" / "index3" / "level", "3");
+        writeFile(cpuDir / "cache" / "index3" / "shared_cpu_list",
+                  std::to_string(package * 4) + "-" + std::to_string(package * 4 + 3));
+        std::filesystem::create_directories(cpuDir / ("node" + std::to_string(package)));
+    }
+    return root;
+}
+}  // namespace
+
+TEST_CASE("Physical Cores Skip SMT Siblings")
+{
+    auto root  = makeFakeTopology();
+    auto cores = thread::getPhysicalCores(root);
+    std::filesystem::remove_all(root);
+
+    REQUIRE(cores.size() == 4);
+
+    std::vector<uint32_t> cpus;
+    for(const auto& core : cores)
+    {
+        cpus.push_back(core.cpu);
+    }
+    REQUIRE(cpus == std::vector<uint32_t>{0, 2, 4, 6});
+
+    REQUIRE(cores[0].package == 0);
+    REQUIRE(cores[1].l3 == cores[0].l3);
+    REQUIRE(cores[2].package == 1);
+    REQUIRE(cores[2].l3 != cores[0].l3);
+    REQUIRE(cores[3].numaNode == 1);
+}
+
+TEST_CASE("Missing Topology Is Empty")
+{
+    REQUIRE(thread::getPhysicalCores("/nonexistent/cpu").empty());
+}
+
+TEST_CASE("Pinned Workers Run Tasks")
+{
+    TaskManager taskManager(2, "Pinned", 1, true);
+
+    std::atomic_int count = 0;
+    taskManager.parallelFor({0, 1000}, 10, [&count](std::size_t) { count++; });
+
+    REQUIRE(count == 1000);
+}
+
+TEST_CASE("Idle Backoff Spins Then Yields Then Parks")
+{
+    thread::IdleBackoff backoff{{.spinCount = 3, .yieldCount = 2}};
+
+    int rounds = 0;
+    while(backoff.next())
+    {
+        rounds++;
+    }
+    REQUIRE(rounds == 5);
+    REQUIRE(!backoff.next());
+
+    thread::IdleBackoff parkRightAway{{.spinCount = 0, .yieldCount = 0}};
+    REQUIRE(!parkRightAway.next());
+}
+
+TEST_CASE("Calibrated Idle Policy")
+{
+    auto policy = thread::calibrateIdlePolicy();
+    if(std::thread::hardware_concurrency() <= 1)
+    {
+        REQUIRE(policy.spinCount == 0);
+    }
+    else
+    {
+        REQUIRE(policy.spinCount >= 64);
+        REQUIRE(policy.spinCount <= (1u << 16));
+    }
+}
+
+TEST_CASE("Bursts Run Under Every Idle Policy")
+{
+    TaskManager taskManager(2, "Idle");
+
+    for(thread::IdlePolicy policy : {thread::IdlePolicy{.spinCount = 0, .yieldCount = 0},
+                                     thread::IdlePolicy{.spinCount = 1 << 14, .yieldCount = 64}})
+    {
+        taskManager.setIdlePolicy(policy);
+        REQUIRE(taskManager.getIdlePolicy().spinCount == policy.spinCount);
+        REQUIRE(taskManager.getIdlePolicy().yieldCount == policy.yieldCount);
+
+        std::atomic_int count = 0;
+        for(int burst = 0; burst < 20; ++burst)
+        {
+            auto group = taskManager.createTaskGroup("burst");
+            for(int i = 0; i < 100; ++i)
+            {
+                group->addTask([&count]() { count++; });
+            }
+            group->submit();
+            // workers are either still spinning or already parked when the next burst arrives
+            std::this_thread::sleep_for(std::chrono::microseconds(burst % 2 ? 50 : 2000));
+        }
+        taskManager.wait();
+        REQUIRE(count == 2000);
+    }
+}
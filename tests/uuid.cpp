@@ -0,0 +1,99 @@
+#include <catch2/catch_all.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include "common/uuid.h"
+
+using namespace aph;
+using namespace aph::uuid;
+
+TEST_CASE("uuids convert to and from their string representation")
+{
+    UUID uuid{0x0123456789abcdefull, 0xfedcba9876543210ull};
+    REQUIRE(uuid.str() == "10325476-98ba-dcfe-efcd-ab8967452301");
+    REQUIRE(UUID::fromStrFactory(uuid.str()) == uuid);
+    REQUIRE(UUID::fromStrFactory("10325476-98BA-DCFE-EFCD-AB8967452301") == uuid);
+
+    UUIDGenerator<std::mt19937_64> generator{42};
+    UUID                           generated = generator.getUUID();
+    std::string                    str       = generated.str();
+    REQUIRE(str.size() == STRING_LENGTH);
+    REQUIRE(str[14] == '4');
+    REQUIRE(std::string_view{"89ab"}.find(str[19]) != std::string_view::npos);
+}
+
+TEST_CASE("every simd level matches the scalar codec")
+{
+    // odd counts leave a tail for the kernels that convert several uuids at once
+    for(std::size_t count : {0, 1, 2, 3, 17})
+    {
+        UUIDGenerator<std::mt19937_64> generator{count};
+        std::vector<UUID>              uuids(count);
+        generator.generate(uuids);
+
+        std::string expected(count * STRING_LENGTH, '\0');
+        format(uuids, expected.data(), simd::Level::Scalar);
+
+        for(simd::Level level : simd::getSupportedLevels())
+        {
+            INFO(simd::toString(level) << ", " << count << " uuids");
+
+            std::string str(count * STRING_LENGTH, '\0');
+            format(uuids, str.data(), level);
+            REQUIRE(str == expected);
+
+            std::vector<UUID> parsed(count);
+            parse(str.data(), parsed, level);
+            REQUIRE(parsed == uuids);
+        }
+
+        std::string str(count * STRING_LENGTH, '\0');
+        format(uuids, str.data());
+        REQUIRE(str == expected);
+        for(std::size_t i = 0; i < count; ++i)
+        {
+            REQUIRE(uuids[i].str() == expected.substr(i * STRING_LENGTH, STRING_LENGTH));
+        }
+    }
+}
+
+TEST_CASE("every simd level parses upper-case hex")
+{
+    // 17 uuids so the kernels that convert several at once see upper case in both the batch and the tail
+    UUIDGenerator<std::mt19937_64> generator{3};
+    std::vector<UUID>              uuids(17);
+    generator.generate(uuids);
+
+    std::string str(uuids.size() * STRING_LENGTH, '\0');
+    format(uuids, str.data());
+    std::ranges::transform(str, str.begin(), [](char c) { return static_cast<char>(std::toupper(c)); });
+
+    for(simd::Level level : simd::getSupportedLevels())
+    {
+        INFO(simd::toString(level));
+
+        std::vector<UUID> parsed(uuids.size());
+        parse(str.data(), parsed, level);
+        REQUIRE(parsed == uuids);
+    }
+}
+
+TEST_CASE("generated uuids are version 4")
+{
+    UUIDGenerator<std::mt19937_64> generator{7};
+    std::vector<UUID>              uuids(64);
+    generator.generate(uuids);
+
+    std::string str(uuids.size() * STRING_LENGTH, '\0');
+    format(uuids, str.data());
+    for(std::size_t i = 0; i < uuids.size(); ++i)
+    {
+        std::string_view s{str.data() + i * STRING_LENGTH, STRING_LENGTH};
+        REQUIRE(s[14] == '4');
+        REQUIRE(std::string_view{"89ab"}.find(s[19]) != std::string_view::npos);
+        for(std::size_t j = i + 1; j < uuids.size(); ++j)
+        {
+            REQUIRE(uuids[i] != uuids[j]);
+        }
+    }
+}
@@ -0,0 +1,120 @@
+#include <catch2/catch_all.hpp>
+
+#include "threads/workStealingQueue.h"
+
+using namespace aph;
+
+TEST_CASE("Owner pops in LIFO order")
+{
+    WorkStealingQueue<int> queue(4);
+
+    for(int i = 0; i < 4; ++i)
+    {
+        queue.push(i);
+    }
+    REQUIRE(queue.size() == 4);
+
+    for(int i = 3; i >= 0; --i)
+    {
+        auto value = queue.pop();
+        REQUIRE(value.has_value());
+        REQUIRE(value.value() == i);
+    }
+    REQUIRE(!queue.pop().has_value());
+    REQUIRE(queue.empty());
+}
+
+TEST_CASE("Thieves steal in FIFO order")
+{
+    WorkStealingQueue<int> queue(4);
+
+    for(int i = 0; i < 4; ++i)
+    {
+        queue.push(i);
+    }
+
+    for(int i = 0; i < 4; ++i)
+    {
+        auto value = queue.steal();
+        REQUIRE(value.has_value());
+        REQUIRE(value.value() == i);
+    }
+    REQUIRE(!queue.steal().has_value());
+}
+
+TEST_CASE("Queue grows past its initial capacity")
+{
+    WorkStealingQueue<int> queue(2);
+
+    for(int i = 0; i < 1000; ++i)
+    {
+        queue.push(i);
+    }
+    REQUIRE(queue.size() == 1000);
+    REQUIRE(queue.capacity() >= 1000);
+
+    long sum = 0;
+    while(auto value = queue.pop())
+    {
+        sum += value.value();
+    }
+    REQUIRE(sum == 999 * 1000 / 2);
+}
+
+TEST_CASE("Concurrent stealing neither loses nor duplicates items")
+{
+    constexpr int itemCount   = 100000;
+    constexpr int thiefCount  = 4;
+    WorkStealingQueue<int> queue;
+
+    std::vector<std::atomic<int>> seen(itemCount);
+    std::atomic<bool>             done{false};
+    std::atomic<int>              consumed{0};
+
+    std::vector<std::thread> thieves;
+    for(int t = 0; t < thiefCount; ++t)
+    {
+        thieves.emplace_back([&]() {
+            while(!done.load(std::memory_order_acquire) || !queue.empty())
+            {
+                if(auto value = queue.steal())
+                {
+                    seen[value.value()].fetch_add(1, std::memory_order_relaxed);
+                    consumed.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+
+    for(int i = 0; i < itemCount; ++i)
+    {
+        queue.push(i);
+        if(i % 3 == 0)
+        {
+            if(auto value = queue.pop())
+            {
+                seen[value.value()].fetch_add(1, std::memory_order_relaxed);
+                consumed.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+    while(auto value = queue.pop())
+    {
+        seen[value.value()].fetch_add(1, std::memory_order_relaxed);
+        consumed.fetch_add(1, std::memory_order_relaxed);
+    }
+    done.store(true, std::memory_order_release);
+
+    for(auto& t : thieves)
+    {
+        t.join();
+    }
+
+    REQUIRE(consumed.load() == itemCount);
+    bool exactlyOnce = true;
+    for(auto& s : seen)
+    {
+        exactlyOnce = exactlyOnce && s.load() == 1;
+    }
+    REQUIRE(exactlyOnce);
+}